@@ -0,0 +1,64 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "mapped_file.hpp"
+
+#include <cassert>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace webgraph { namespace ascii_graph {
+
+////////////////////////////////////////////////////////////////////////////////
+/** Maps the given file, which must exist, into memory.
+ */
+mapped_file::mapped_file( const std::string& filename, bool sequential ) : 
+   filename( filename ), start( NULL ), length( 0 ) {
+   int fd = open( filename.c_str(), O_RDONLY );
+   assert( fd >= 0 );
+
+   struct stat st;
+   int r = fstat( fd, &st );
+   assert( r == 0 );
+
+   length = st.st_size;
+
+   // mmap() refuses empty mappings.
+   if( length > 0 ) {
+      void* m = mmap( NULL, length, PROT_READ, MAP_PRIVATE, fd, 0 );
+      assert( m != MAP_FAILED );
+
+      if( sequential )
+         madvise( m, length, MADV_SEQUENTIAL );
+
+      start = static_cast<const char*>( m );
+   }
+
+   close( fd );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+mapped_file::~mapped_file() {
+   if( length > 0 )
+      munmap( const_cast<char*>( start ), length );
+}
+
+} }
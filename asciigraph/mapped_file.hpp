@@ -0,0 +1,100 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef MAPPED_FILE_HPP_
+#define MAPPED_FILE_HPP_
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <boost/utility.hpp>
+
+#include "vertex.hpp"
+
+namespace webgraph { namespace ascii_graph {
+
+/*!
+ * A read-only memory mapping of a whole file. The ASCII graph iterators share one of
+ * these, so that scanning a .graph-txt file costs no system calls beyond the page faults,
+ * and positioning an iterator is just a matter of keeping a pointer.
+ */
+class mapped_file : public boost::noncopyable {
+private:
+   std::string filename;
+   const char* start;
+   size_t length;
+
+public:
+   /// If sequential, the kernel is told the file will be read front to back.
+   explicit mapped_file( const std::string& filename, bool sequential = true );
+   ~mapped_file();
+
+   const char* begin() const {
+      return start;
+   }
+
+   const char* end() const {
+      return start + length;
+   }
+
+   size_t size() const {
+      return length;
+   }
+
+   const std::string& get_filename() const {
+      return filename;
+   }
+};
+
+/*!
+ * Parses a line of decimal integers separated by blanks, starting at p and ending at the
+ * first newline or at end, into dest (which is cleared first, but keeps its capacity, so
+ * that a buffer reused across lines stops allocating once it has grown to the largest
+ * outdegree).
+ *
+ * @return a pointer just past the newline, or end.
+ */
+inline const char* parse_line( const char* p, const char* end, 
+                               std::vector<vertex_label_t>& dest ) {
+   dest.clear();
+
+   while( p != end ) {
+      char c = *p;
+
+      if( c == '\n' )
+         return p + 1;
+
+      if( (unsigned char)( c - '0' ) < 10 ) {
+         vertex_label_t x = c - '0';
+
+         while( ++p != end && (unsigned char)( *p - '0' ) < 10 )
+            x = x * 10 + ( *p - '0' );
+
+         dest.push_back( x );
+      } else {
+         ++p;
+      }
+   }
+
+   return end;
+}
+
+} }
+
+#endif /*MAPPED_FILE_HPP_*/
@@ -20,6 +20,7 @@
 #include "offline_edge_iterator.hpp"
 
 #include <iostream>
+#include <fstream>
 #include <iterator>
 #include <cassert>
 #include <algorithm>
@@ -26,7 +26,7 @@
 namespace webgraph { namespace ascii_graph {
 
 ////////////////////////////////////////////////////////////////////////////////
-offline_graph::offline_graph() : n(0), num_edges(0)
+offline_graph::offline_graph() : n(0), num_edges(0), edges_counted(false)
 {
 }
 
@@ -62,17 +62,28 @@ offline_graph offline_graph::load( const string& basename ) {
    nl >> result.n;
         
    assert( result.n > 0 );
-                
 
-   // now read number of edges
-   result.num_edges = 0;
-   edge_iterator b, e;
-   tie( b, e ) = result.get_edge_iterator();
-   for( ; b != e; ++b ) {
-      result.num_edges++;
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/**
+ * Returns the number of edges of the graph. The file says nothing about it, so the
+ * first call reads the whole graph to count them; callers that only scan the graph
+ * (such as the compressor, which counts arcs as it goes) never pay for that pass.
+ */
+unsigned int offline_graph::get_num_edges() const {
+   if( !edges_counted ) {
+      num_edges = 0;
+      edge_iterator b, e;
+      tie( b, e ) = get_edge_iterator();
+      for( ; b != e; ++b ) {
+         num_edges++;
+      }
+      edges_counted = true;
    }
 
-   return result;
+   return num_edges;
 }
         
 ////////////////////////////////////////////////////////////////////////////////
@@ -48,7 +48,8 @@ private:
 protected:
    unsigned int n; // num vertices
    string filename; // file containing the graph
-   unsigned int num_edges;
+   mutable unsigned int num_edges; // counted on the first call to get_num_edges()
+   mutable bool edges_counted;
    
 public:
    virtual ~offline_graph();
@@ -69,9 +70,7 @@ public:
       return n;
    }
 
-   unsigned int get_num_edges() const {
-      return num_edges;
-   }
+   unsigned int get_num_edges() const;
 };
 } } // namespace webgraph
 
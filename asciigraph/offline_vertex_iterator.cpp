@@ -42,23 +42,23 @@ offline_vertex_iterator::offline_vertex_iterator(const char* filename)
 {
    init();
    
-   this->filename = filename;
-   back.open(filename);
+   back.reset( new mapped_file( filename ) );
+   pos.reset( new cursor );
 
    end_marker = false;
    
-   string tmp;
-   getline( back, tmp );
-   
-   istringstream iss(tmp);
-   
-   iss >> num_vertices;
+   std::vector<vertex_label_t> first_line;
+   pos->get_pos = parse_line( back->begin(), back->end(), first_line ) - back->begin();
+
+   assert( first_line.size() == 1 );
+   num_vertices = first_line[0];
    
-   current_descriptor.label_ref() = 0; // just to make sure it's valid.
+   pos->current_descriptor.label_ref() = 0; // just to make sure it's valid.
    
    increment();
    
-   current_descriptor.label_ref() = 0;
+   if( !end_marker )
+      pos->current_descriptor.label_ref() = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -82,27 +82,20 @@ offline_vertex_iterator& offline_vertex_iterator::operator = (
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/*! Cheap way to implement copy and assignment.
+/*! Cheap way to implement copy and assignment: the file and the cursor are shared, not
+ * duplicated.
  */
 void offline_vertex_iterator::copy( const offline_vertex_iterator& other ) {
    if( other.end_marker ) {
-      if( back.is_open() )
-         back.close();
+      back.reset();
+      pos.reset();
       
       end_marker = true;  
    } else {
-      current_descriptor = other.current_descriptor;
-      if( back.is_open())
-         back.close();
-
-      back.clear();
-      
-      back.open( other.filename.c_str() );
-      back.seekg( other.get_pos );
-      get_pos = other.get_pos;
+      back = other.back;
+      pos = other.pos;
       num_vertices = other.num_vertices;
       end_marker = false;
-      filename = other.filename;
    }
 }
 
@@ -110,29 +103,28 @@ void offline_vertex_iterator::copy( const offline_vertex_iterator& other ) {
 /*! Backing function for ++'s
  */
 void offline_vertex_iterator::increment() {
-   string tmp;
-   
-   bool success = getline( back, tmp );
-   
-   if( !success ) {
+   const char* next = back->begin() + pos->get_pos;
+
+   if( next == back->end() ) {
       end_marker = true;
-#if 0
-      cerr << "Just failed to perform a getline. Current state: " << endl
-           << as_str() << endl
-           << "back.good() = " << back.good() << endl;
-#endif      
+      pos.reset();
       return;
    }
+
+   // Copy on advance: if other iterators still point to the current vertex, leave the
+   // cursor to them. The new cursor needs nothing from the old one but its position, as
+   // the successors are about to be overwritten anyway.
+   if( !pos.unique() ) {
+      boost::shared_ptr<cursor> c( new cursor );
+      c->current_descriptor.label_ref() = pos->current_descriptor.get_label();
+      pos = c;
+   }
    
-   current_descriptor.successors_ref().clear();
-   istringstream iss( tmp );
-   
-   std::copy( istream_iterator<vertex_label_t>(iss), 
-              istream_iterator<vertex_label_t>(), 
-              back_inserter(current_descriptor.successors_ref()) );
-      
-   get_pos = back.tellg();
-   current_descriptor.label_ref()++;
+   // Otherwise the successor vector is reused from line to line, so once it has grown to
+   // the largest outdegree parsing does not allocate.
+   pos->get_pos = parse_line( next, back->end(), pos->current_descriptor.successors_ref() ) 
+      - back->begin();
+   pos->current_descriptor.label_ref()++;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -142,9 +134,10 @@ string offline_vertex_iterator::as_str() const {
    ostringstream o;
    
    o << "ascii_graph::offline_vertex_iterator\n"
-     << "\tcurrent_descriptor:\n\t" << current_descriptor.as_str() << "\n"
-     << "\tfilename: " << filename << "\n"
-     << "\tseek position: " << get_pos << "\n"
+     << "\tcurrent_descriptor:\n\t" 
+     << ( pos != NULL ? pos->current_descriptor.as_str() : "" ) << "\n"
+     << "\tfilename: " << ( back != NULL ? back->get_filename() : "" ) << "\n"
+     << "\tseek position: " << ( pos != NULL ? pos->get_pos : 0 ) << "\n"
      << "\tis end marker?: " << end_marker << "\n";
    
    return o.str();
@@ -160,12 +153,12 @@ offline_vertex_iterator::~offline_vertex_iterator()
 ////////////////////////////////////////////////////////////////////////////////
 
 int outdegree( const offline_vertex_iterator& me ) {
-   return me.current_descriptor.get_successors().size();   
+   return me.pos->current_descriptor.get_successors().size();   
 }
       
 ////////////////////////////////////////////////////////////////////////////////
 const std::vector<vertex_label_t>& successors( const offline_vertex_iterator& me ) {
-   return me.current_descriptor.get_successors();
+   return me.pos->current_descriptor.get_successors();
 }
 
 } }
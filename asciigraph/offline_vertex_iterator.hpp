@@ -23,11 +23,12 @@
 #include "../webgraph/webgraph_vertex.hpp"
 
 #include "vertex.hpp"
+#include "mapped_file.hpp"
 
 #include <string>
 #include <sstream>
 #include <boost/iterator/iterator_facade.hpp>
-#include <fstream>
+#include <boost/shared_ptr.hpp>
 #include <cassert>
 
 #include <iostream>
@@ -46,17 +47,22 @@ namespace webgraph { namespace ascii_graph {
    private:
       ////////////////////////////////////////////////////////////////////////////////
       // data members
-      vertex_descriptor current_descriptor;
 //      std::vector<vertex> current_successors;
-      std::ifstream back;
-      std::string filename;
-      size_t get_pos;
+      //! Where an iterator is: the current vertex and the offset of the next line.
+      struct cursor {
+         vertex_descriptor current_descriptor;
+         size_t get_pos;
+      };
+
+      // The mapped file is shared by all the iterators over it.
+      boost::shared_ptr<const mapped_file> back;
+      // Copies of an iterator share its cursor, so copying is O(1); the first of them 
+      // to be advanced gets a cursor of its own (see increment()). NULL at the end.
+      boost::shared_ptr<cursor> pos;
       bool end_marker;
       unsigned int num_vertices;
       
       void init() {
-//         current_descriptor = vertex_descriptor_t();
-         get_pos = 0;
          end_marker = false;
          num_vertices = 0;   
       }
@@ -102,18 +108,20 @@ namespace webgraph { namespace ascii_graph {
               << " and " << endl
               << rhs.as_str() << endl;
               
-         bool val = this->current_descriptor == rhs.current_descriptor || (this->end_marker && rhs.end_marker);
+         bool val = this->pos->current_descriptor == rhs.pos->current_descriptor || (this->end_marker && rhs.end_marker);
          
          cerr << "Will return : " << val << endl;
 #endif
          
-         return ((this->current_descriptor.get_label() == rhs.current_descriptor.get_label()) && 
-                 !(this->end_marker || rhs.end_marker))
-                || (this->end_marker && rhs.end_marker);
+         if( this->end_marker || rhs.end_marker )
+            return this->end_marker && rhs.end_marker;
+
+         return this->pos == rhs.pos || 
+            this->pos->current_descriptor.get_label() == rhs.pos->current_descriptor.get_label();
       }
 
       vertex_descriptor dereference() const {
-         return current_descriptor;
+         return pos->current_descriptor;
       }
    };
 
@@ -0,0 +1,152 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "parallel_graph.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <boost/bind.hpp>
+
+namespace webgraph { namespace ascii_graph {
+
+////////////////////////////////////////////////////////////////////////////////
+/** Maps basename.graph-txt and reads its number of nodes. Nothing else is read until
+ * an iterator is created.
+ *
+ * @param threads the number of threads parsing the file during a scan.
+ * @param chunk_size the approximate size of the pieces the file is split into.
+ */
+parallel_graph parallel_graph::load( const std::string& basename, int threads, 
+                                     size_t chunk_size ) {
+   parallel_graph result;
+
+   result.file.reset( new mapped_file( basename + ".graph-txt" ) );
+   result.threads = std::max( 1, threads );
+   result.chunk_size = std::max( (size_t)1, chunk_size );
+
+   std::vector<vertex_label_t> first_line;
+   const mapped_file& f = *result.file;
+   result.header_length = parse_line( f.begin(), f.end(), first_line ) - f.begin();
+
+   assert( first_line.size() == 1 && first_line[0] > 0 );
+   result.n = first_line[0];
+
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** Starts a new scan of the graph.
+ */
+std::pair<parallel_graph::vertex_iterator, parallel_graph::vertex_iterator>
+parallel_graph::get_vertex_iterator() const {
+   boost::shared_ptr<scan> s( new scan( *this ) );
+
+   s->advance();
+
+   return std::make_pair( vertex_iterator( s ), vertex_iterator() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** Splits the file into chunks and starts the workers.
+ */
+parallel_graph::scan::scan( const parallel_graph& g ) : 
+   file( g.file ), current( 0 ), line( -1 ), 
+   label( -1 ), at_end( false ), first( NULL ), last( NULL ) {
+   const char* p = file->begin() + g.header_length;
+   const char* end = file->end();
+
+   // Each chunk ends just past the first newline at least chunk_size bytes after its start.
+   while( p != end ) {
+      chunk c;
+      c.begin = p;
+
+      if( (size_t)( end - p ) <= g.chunk_size ) {
+         p = end;
+      } else {
+         const char* nl = 
+            static_cast<const char*>( std::memchr( p + g.chunk_size, '\n', 
+                                                   end - p - g.chunk_size ) );
+         p = nl == NULL ? end : nl + 1;
+      }
+
+      c.end = p;
+      chunks.push_back( c );
+   }
+
+   pipeline.start( chunks.size(), g.threads, boost::bind( &scan::parse, this, _1 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** Parses chunk i; called by the workers.
+ */
+void parallel_graph::scan::parse( long i ) {
+   chunk& c = chunks[i];
+   std::vector<vertex_label_t> list;
+   const char* p = c.begin;
+
+   c.line_start.push_back( 0 );
+
+   while( p != c.end ) {
+      p = parse_line( p, c.end, list );
+
+      c.successors.insert( c.successors.end(), list.begin(), list.end() );
+      c.line_start.push_back( c.successors.size() );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** Moves to the next node, waiting for its chunk to be parsed if need be, and frees
+ * the chunks left behind.
+ */
+void parallel_graph::scan::advance() {
+   assert( !at_end );
+
+   for( ;; ) {
+      if( current == chunks.size() ) {
+         at_end = true;
+         return;
+      }
+
+      chunk& c = chunks[ current ];
+
+      if( line == -1 ) 
+         pipeline.wait();
+
+      if( line + 2 < (long)c.line_start.size() ) {
+         const vertex_label_t* base = c.successors.empty() ? NULL : &c.successors[0];
+
+         line++;
+         label++;
+         first = base + c.line_start[ line ];
+         last = base + c.line_start[ line + 1 ];
+
+         return;
+      }
+
+      std::vector<size_t>().swap( c.line_start );
+      std::vector<vertex_label_t>().swap( c.successors );
+
+      current++;
+      pipeline.release();
+      line = -1;
+   }
+}
+
+} }
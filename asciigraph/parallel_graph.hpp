@@ -0,0 +1,157 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef PARALLEL_GRAPH_HPP_
+#define PARALLEL_GRAPH_HPP_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "vertex.hpp"
+#include "mapped_file.hpp"
+#include "../webgraph/pipeline.hpp"
+
+namespace webgraph { namespace ascii_graph {
+
+/*!
+ * ascii_graph::parallel_graph reads a .graph-txt file like offline_graph, but parses it
+ * on several threads, so that parsing does not limit the speed of whatever consumes the
+ * graph (typically the compressor, which is single threaded).
+ *
+ * Each scan of the graph splits the (memory-mapped) file at newline boundaries into chunks
+ * of about chunk_size bytes. Worker threads take the chunks in order (see
+ * parallel::ordered_pipeline), each splitting its chunk into lines and parsing them into a
+ * buffer of its own. The nodes are then handed out in file order: the id of the first
+ * node of a chunk is the sum of the line counts of the chunks before it, which the
+ * iterator accumulates as it goes. At most twice as many chunks as there are threads are
+ * parsed ahead of the iterator, which bounds memory use.
+ *
+ * Every call to get_vertex_iterator() starts a new scan with threads of its own, so the
+ * graph can be scanned several times; but each scan is single pass, and all copies of an
+ * iterator share its position.
+ */
+class parallel_graph {
+public:
+   static const size_t DEFAULT_CHUNK_SIZE = 16 << 20;
+
+private:
+   //! A piece of the file, and the successor lists parsed from it.
+   struct chunk {
+      const char* begin;
+      const char* end;
+      // The list of the i-th line of the chunk is successors[line_start[i]..line_start[i+1])
+      std::vector<size_t> line_start;
+      std::vector<vertex_label_t> successors;
+   };
+
+   //! The state of a scan: the chunks, the workers parsing them, and the current node.
+   class scan : public boost::noncopyable {
+   private:
+      boost::shared_ptr<const mapped_file> file;
+      std::vector<chunk> chunks;
+      size_t current;       // the chunk the current node is in
+      long line;            // the line of the current node within it
+
+      // Declared after chunks, so that the workers are stopped first.
+      parallel::ordered_pipeline pipeline;
+
+      void parse( long i );
+
+   public:
+      long label;
+      bool at_end;
+      const vertex_label_t* first;
+      const vertex_label_t* last;
+
+      scan( const parallel_graph& g );
+
+      void advance();
+   };
+
+   boost::shared_ptr<const mapped_file> file;
+   size_t header_length; // the line giving the number of nodes
+   unsigned int n;
+   int threads;
+   size_t chunk_size;
+
+   parallel_graph() : header_length( 0 ), n( 0 ), threads( 1 ), chunk_size( 0 ) {}
+
+public:
+   class parallel_vertex_iterator : public boost::iterator_facade<
+      parallel_vertex_iterator,
+      vertex_label_t,
+      boost::single_pass_traversal_tag,
+      vertex_label_t
+   > {
+   private:
+      boost::shared_ptr<scan> state; // NULL for the end marker
+
+   public:
+      parallel_vertex_iterator() {}
+      explicit parallel_vertex_iterator( const boost::shared_ptr<scan>& s ) : state( s ) {}
+
+      //! The successor list of the current node, as a range of the parse buffer.
+      std::pair<const vertex_label_t*, const vertex_label_t*> get_successors() const {
+         return std::make_pair( state->first, state->last );
+      }
+
+   private:
+      friend class boost::iterator_core_access;
+
+      void increment() {
+         state->advance();
+      }
+
+      bool at_end() const {
+         return state == NULL || state->at_end;
+      }
+
+      bool equal( const parallel_vertex_iterator& rhs ) const {
+         if( at_end() || rhs.at_end() )
+            return at_end() && rhs.at_end();
+
+         return state == rhs.state;
+      }
+
+      vertex_label_t dereference() const {
+         return state->label;
+      }
+   };
+
+   typedef parallel_vertex_iterator vertex_iterator;
+   typedef parallel_vertex_iterator node_iterator;
+
+   static parallel_graph load( const std::string& basename, int threads, 
+                               size_t chunk_size = DEFAULT_CHUNK_SIZE );
+
+   std::pair<vertex_iterator, vertex_iterator> get_vertex_iterator() const;
+
+   unsigned int get_num_nodes() const {
+      return n;
+   }
+};
+
+} }
+
+#endif /*PARALLEL_GRAPH_HPP_*/
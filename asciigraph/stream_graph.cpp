@@ -0,0 +1,85 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "stream_graph.hpp"
+#include "mapped_file.hpp"
+
+#include <cassert>
+#include <sstream>
+
+namespace webgraph { namespace ascii_graph {
+
+////////////////////////////////////////////////////////////////////////////////
+stream_graph::stream_graph( std::istream& in ) : state( new reader ) {
+   state->in = &in;
+   state->n = 0;
+   state->arcs = 0;
+   state->label = 0;
+   state->started = false;
+   state->at_end = false;
+
+   std::getline( in, state->line );
+   std::istringstream nl( state->line );
+
+   nl >> state->n;
+
+   assert( state->n > 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** Returns the iterators over the nodes of this graph. As the stream is consumed by
+ * the iteration, this may only be called once.
+ */
+std::pair<stream_graph::vertex_iterator, stream_graph::vertex_iterator>
+stream_graph::get_vertex_iterator() const {
+   assert( !state->started );
+
+   state->started = true;
+
+   if( state->read_line() )
+      state->label = 0;
+
+   return std::make_pair( vertex_iterator( state ), vertex_iterator() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void stream_graph::stream_vertex_iterator::increment() {
+   if( state->read_line() )
+      state->label++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** Reads the next line of the stream into successors, setting at_end if there is none.
+ */
+bool stream_graph::reader::read_line() {
+   if( !std::getline( *in, line ) ) {
+      at_end = true;
+      return false;
+   }
+
+   parse_line( line.data(), line.data() + line.size(), successors );
+
+   assert( successors.empty() || successors.back() < n );
+
+   arcs += successors.size();
+
+   return true;
+}
+
+} }
@@ -0,0 +1,121 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef STREAM_GRAPH_HPP_
+#define STREAM_GRAPH_HPP_
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <utility>
+#include <boost/shared_ptr.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "vertex.hpp"
+
+namespace webgraph { namespace ascii_graph {
+
+/*!
+ * ascii_graph::stream_graph reads a graph in the .graph-txt format (the number of nodes on
+ * the first line, then the successor list of each node on a line of its own) from a
+ * stream, in a single pass. Unlike offline_graph it never seeks or reopens its input, so
+ * it can read a pipe, standard input or the output of a decompressor.
+ *
+ * The price is that the graph can be scanned only once: get_vertex_iterator() may be
+ * called a single time, and all copies of the iterator it returns share the same position
+ * in the stream. The number of arcs is not known in advance; get_num_edges() returns the
+ * number of arcs read so far.
+ */
+class stream_graph {
+private:
+   /// The state shared by the graph and all its iterators.
+   struct reader {
+      std::istream* in;
+      std::string line;
+      std::vector<vertex_label_t> successors;
+      unsigned int n;
+      unsigned long arcs;
+      vertex_label_t label;
+      bool started;
+      bool at_end;
+
+      bool read_line();
+   };
+
+   boost::shared_ptr<reader> state;
+
+public:
+   class stream_vertex_iterator : public boost::iterator_facade<
+      stream_vertex_iterator,
+      vertex_label_t,
+      boost::single_pass_traversal_tag,
+      vertex_label_t
+   > {
+   private:
+      boost::shared_ptr<reader> state; // NULL for the end marker
+
+   public:
+      stream_vertex_iterator() {}
+      explicit stream_vertex_iterator( const boost::shared_ptr<reader>& s ) : state( s ) {}
+
+      const std::vector<vertex_label_t>& get_successors() const {
+         return state->successors;
+      }
+
+   private:
+      friend class boost::iterator_core_access;
+
+      void increment();
+
+      bool at_end() const {
+         return state == NULL || state->at_end;
+      }
+
+      bool equal( const stream_vertex_iterator& rhs ) const {
+         if( at_end() || rhs.at_end() )
+            return at_end() && rhs.at_end();
+
+         return state == rhs.state;
+      }
+
+      vertex_label_t dereference() const {
+         return state->label;
+      }
+   };
+
+   typedef stream_vertex_iterator vertex_iterator;
+   typedef stream_vertex_iterator node_iterator;
+
+   /// Reads the number of nodes from in, which must outlive this graph.
+   explicit stream_graph( std::istream& in );
+
+   std::pair<vertex_iterator, vertex_iterator> get_vertex_iterator() const;
+
+   unsigned int get_num_nodes() const {
+      return state->n;
+   }
+
+   unsigned long get_num_edges() const {
+      return state->arcs;
+   }
+};
+
+} }
+
+#endif /*STREAM_GRAPH_HPP_*/
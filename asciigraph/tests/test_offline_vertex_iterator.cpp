@@ -21,6 +21,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cassert>
 
 int main( int, char** ) {
    using namespace std;
@@ -49,5 +50,8 @@ int main( int, char** ) {
       ++st;
    }
 
+   // copies share their position until advanced, so the original must not have moved
+   assert( itor == end || vertex_label_t( *itor ) == vertex_label_t( i - 1 ) );
+
    return 0;
 }
@@ -25,7 +25,7 @@
 
 #include "../utils/fast.hpp"
 
-#define LOGGING
+//#define LOGGING
 
 namespace webgraph {
 using namespace std;
@@ -141,9 +141,11 @@ int ibitstream::read() {
    // deal with reading into the buffer.
    if ( avail == 0 ) {
       // then the buffer is empty. attempt to fill it again.
-      if( is != NULL )
+      // a wrapped byte array has no stream behind it; running off its end is EOF.
+      if( is != NULL ) {
          assert( buffer->size() == buffer->capacity() );
          avail = is->readsome( (char*)&(*buffer).at(0), buffer->size() ); // used to be capacity
+      }
 #ifdef LOGGING         
       cerr << "==================================================\n";
       cerr << "BUFFER REFILLED; first 50 bytes : \n";
@@ -376,14 +378,9 @@ void ibitstream::set_position( unsigned long position ) {
    assert( position >= 0 );
 
    // removed "unsigned"
-   const int delta = ( position >> 3 ) - ( this->position + pos );
-
-   // Once graph memory is attached, we should be looking there.
-   // But for some reason, we're looking in the (null) istream instead.
-      
-   int pos = (int)this->pos;
+   const long delta = (long)( position >> 3 ) - (long)( this->position + pos );
 
-   if ( delta <= avail && delta >= - pos ) {
+   if ( delta <= (long)avail && delta >= - (long)pos ) {
       // We can reposition just by moving into the buffer.
       avail -= delta;
       pos += delta;
@@ -409,7 +406,7 @@ int ibitstream::read_unary() {
    if ( fill < 8 ) 
       refill();
       
-#if 1
+#if 0
    cerr << "current: " << current << endl
         << "fill: " << fill << endl;
 #endif
@@ -425,7 +422,7 @@ int ibitstream::read_unary() {
 
       read_bits += x + 1;
       fill -= x + 1;
-#if 1
+#if 0
       cerr << "1. read_unary() = " << x << endl;
 #endif
       return x;
@@ -437,7 +434,7 @@ int ibitstream::read_unary() {
    x += 7 - ( fill = BYTEMSB[ current ] );
    read_bits += x + 1;
 
-#if 1
+#if 0
    cerr << "2. read_unary() = " << x << endl;
 #endif
    return x;
@@ -765,7 +762,7 @@ int ibitstream::read_zeta( int k ) {
          if ( pre_comp != 0 ) {
             read_bits += pre_comp >> 8;
             fill -= pre_comp >> 8;
-#if 1
+#if 0
             cerr << "\t1. read_zeta returning " << (pre_comp & 0xFF) << endl;
 #endif
             return pre_comp & 0xFF;
@@ -778,7 +775,7 @@ int ibitstream::read_zeta( int k ) {
    const int m = read_int( h * k + k - 1 );
    if ( m < left ) {
       int retval = m + left - 1;
-#if 1
+#if 0
       cerr << "\t2. read_zeta returning " << retval << endl;
 #endif
       return retval;
@@ -786,7 +783,7 @@ int ibitstream::read_zeta( int k ) {
 
    int retval = ( m << 1 ) + read_bit() - 1;
 
-#if 1
+#if 0
    cerr << "\t3. read_zeta returning " << retval << endl;
 #endif
    
@@ -26,19 +26,76 @@
  * compressed_graph.offsets, and compressed_graph.properties.
  *
  *      ./compress_webgraph --source=some_graph --dest=compressed_graph
+ *
+ * An existing BV graph can be recompressed with different parameters in a single pass:
+ *
+ *      ./compress_webgraph --graph-class=BVGraph -w 7 --source=compressed_graph --dest=other
+ *
+ * An unsorted list of "source target" lines (the file name is taken as is; - is standard
+ * input) can be compressed without sorting it first, spilling sorted runs of at most
+ * --batch-size arcs to --temp-dir:
+ *
+ *      ./compress_webgraph --graph-class=ArcList -b 50000000 --source=arcs.txt --dest=out
+ *
+ * An ASCII graph given as - is read from standard input in a single pass, so it may come
+ * straight out of a decompressor:
+ *
+ *      zcat some_graph.graph-txt.gz | ./compress_webgraph --source=- --dest=compressed_graph
+ *
+ * A large ASCII graph file can be parsed on several threads while it is compressed:
+ *
+ *      ./compress_webgraph --threads=4 --source=some_graph --dest=compressed_graph
  */
 
 #include <boost/program_options.hpp>
 #include <iostream>
 #include <string>
+#include <fstream>
+#include <stdexcept>
 
 #include "../webgraph/webgraph.hpp"
+#include "../webgraph/arc_list_builder.hpp"
+#include "../webgraph/tuning.hpp"
+#include "../asciigraph/stream_graph.hpp"
+#include "../asciigraph/parallel_graph.hpp"
+
+namespace bvg = webgraph::bv_graph;
+
+/** Parameters of a compression run, possibly to be tuned. */
+struct settings {
+   bvg::compression_parameters params;
+   std::string autotune;
+   int strata, run_length;
+   std::ostream* log;
+   bvg::compression_stats* stats;
+};
+
+/** Compresses g into dest, first tuning the parameters on a sample of g if asked to.
+ */
+template<class source_type>
+void compress( const source_type& g, const std::string& dest, settings& s ) {
+   bvg::compression_parameters& p = s.params;
+
+   if( s.autotune != "" ) {
+      bvg::node_sample sample( g, s.strata, s.run_length );
+
+      p = bvg::tune( sample, s.autotune == "size" ? -1 : p.max_ref_count, p.chain_weight, 
+                     s.log );
+
+      bvg::graph::store( g, dest, p.window_size, p.max_ref_count, p.min_interval_length, 
+                         p.zeta_k, p.flags, s.log, s.stats, p.chain_weight );
+
+      bvg::record_tuning( dest, s.autotune, sample, p );
+   } else {
+      bvg::graph::store( g, dest, p.window_size, p.max_ref_count, p.min_interval_length, 
+                         p.zeta_k, p.flags, s.log, s.stats, p.chain_weight );
+   }
+}
 
 /** Reads an immutable graph and stores it as a {@link BVGraph}.
  */
 int main( int argc, char** argv ) {
    namespace po = boost::program_options;
-   namespace bvg = webgraph::bv_graph;
    using namespace std;
 
    string src, dest;
@@ -48,9 +105,17 @@ int main( int argc, char** argv ) {
       min_interval_length = -1, 
       zeta_k = 5, 
       flags = 0,
-      quantum = 10000;
+      quantum = 10000,
+      threads = 1;
 
-   bool offline = false, write_offsets = false;
+   double chain_weight = 0;
+
+   long batch_size = webgraph::arc_list_builder::DEFAULT_BATCH_SIZE;
+   string temp_dir, autotune;
+   int strata = bvg::node_sample::DEFAULT_STRATA, 
+      run_length = bvg::node_sample::DEFAULT_RUN_LENGTH;
+
+   bool offline = false, write_offsets = false, print_stats = false;
 
    ostringstream help_message_oss;
 
@@ -83,7 +148,12 @@ int main( int argc, char** argv ) {
       
       ("graph-class,g", 
        po::value<string>(),
-       "Set graph class")
+       "Set graph class of the source (AsciiGraph, BVGraph or ArcList)")
+
+      ("chain-weight", 
+       po::value<double>(&chain_weight)->default_value( chain_weight ),
+       "Bits a reference must save per level of reference chain it adds; positive "
+       "values shorten chains, and so speed up random access")
 
       ("min-interval-length", 
        po::value<int>(&min_interval_length)->
@@ -95,8 +165,36 @@ int main( int argc, char** argv ) {
        "the k parameter for zeta-k codes")
       
       ("offline,o", "Use the offline load method to reduce memory consumption")
+
+      ("batch-size,b",
+       po::value<long>(&batch_size)->default_value( batch_size ),
+       "Number of arcs sorted in memory at once (ArcList only)")
+
+      ("temp-dir,T",
+       po::value<string>(&temp_dir),
+       "Directory for sorted runs (ArcList only; default $TMPDIR or /tmp)")
+      
+      ("threads,t",
+       po::value<int>(&threads)->default_value( threads ),
+       "Number of threads parsing the source (AsciiGraph only)")
       
       ("offsets,O", "Generate offsets for the source graph")
+
+      ("stats,S", "Print per-component compression statistics when done")
+
+      ("autotune,a",
+       po::value<string>(&autotune),
+       "Choose the compression parameters on a sample of the graph: \"size\" for the "
+       "smallest graph, \"access\" for the smallest graph whose reference chains are "
+       "at most --max-ref-count long (3 if not given)")
+
+      ("sample-strata",
+       po::value<int>(&strata)->default_value( strata ),
+       "Number of strata sampled by --autotune")
+
+      ("sample-run-length",
+       po::value<int>(&run_length)->default_value( run_length ),
+       "Number of consecutive nodes sampled per stratum by --autotune")
       
       ("quantum,q",
        po::value<int>(&quantum)->default_value( quantum ),
@@ -104,7 +202,7 @@ int main( int argc, char** argv ) {
 
       ("source,s",
        po::value<string>(&src),
-       "Set source graph file")
+       "Set source graph file (- for standard input, AsciiGraph and ArcList only)")
 
       ("dest,d",
        po::value<string>(&dest),
@@ -126,14 +224,34 @@ int main( int argc, char** argv ) {
       return 1;
    }
 
+   string graph_class = "AsciiGraph";
+
    if( vm.count("graph-class") ) {
-      if( vm["graph-class"].as<string>() != "AsciiGraph" ) {
-         cerr << "The only allowable parameter for graph-class is AsciiGraph right now.\n";
+      graph_class = vm["graph-class"].as<string>();
+
+      if( graph_class != "AsciiGraph" && graph_class != "BVGraph" && graph_class != "ArcList" ) {
+         cerr << "The only allowable parameters for graph-class are AsciiGraph, BVGraph and ArcList.\n";
 
          return 1;
       }
    }
 
+   if( autotune != "" && autotune != "size" && autotune != "access" ) {
+      cerr << "The only allowable parameters for autotune are size and access.\n";
+
+      return 1;
+   }
+
+   if( autotune != "" && src == "-" && graph_class == "AsciiGraph" ) {
+      cerr << "autotune reads the source twice, so it cannot be used on standard input.\n";
+
+      return 1;
+   }
+
+   if( autotune == "access" && vm["max-ref-count"].defaulted() ) {
+      max_ref_count = 3;
+   }
+
    if( vm.count( "offline" ) ) {
       offline = true;
    }
@@ -141,6 +259,10 @@ int main( int argc, char** argv ) {
    if( vm.count( "offsets" ) ) {
       write_offsets = true;
    }
+
+   if( vm.count( "stats" ) ) {
+      print_stats = true;
+   }
    
    if( !vm.count( "source" ) || !vm.count( "dest") ) {
       cerr << "For now you must specify either a source or a dest." << "\n";
@@ -156,15 +278,67 @@ int main( int argc, char** argv ) {
 
    namespace ag = webgraph::ascii_graph;
 
-   ag::offline_graph graph = ag::offline_graph::load( src );
-
    ostream* log = &cerr;
 
+   bvg::compression_stats stats;
+
+   settings s;
+   s.params.window_size = window_size;
+   s.params.max_ref_count = max_ref_count;
+   s.params.min_interval_length = min_interval_length;
+   s.params.zeta_k = zeta_k;
+   s.params.flags = flags;
+   s.params.chain_weight = chain_weight;
+   s.autotune = autotune;
+   s.strata = strata;
+   s.run_length = run_length;
+   s.log = log;
+   s.stats = &stats;
+
    if( dest != "" ) {
-      cerr << "About to call store offline graph...\n";
-      bvg::graph::store_offline_graph( graph, dest, window_size, max_ref_count, 
-                                       min_interval_length, 
-                                       zeta_k, flags, log );
+      if( graph_class == "BVGraph" ) {
+         // The source is only ever scanned, so there is no need for offsets.
+         bvg::graph::graph_ptr graph = offline ? bvg::graph::load_offline( src ) 
+                                               : bvg::graph::load_sequential( src );
+
+         compress( *graph, dest, s );
+      } else if( graph_class == "ArcList" ) {
+         webgraph::arc_list_builder builder( batch_size, temp_dir, log );
+
+         // runs are spilled as arcs are added, and merged by finish().
+         try {
+            if( src == "-" ) {
+               builder.add_arcs( cin );
+            } else {
+               ifstream in( src.c_str() );
+               assert( in.good() );
+               builder.add_arcs( in );
+            }
+            builder.finish();
+         } catch( runtime_error& e ) {
+            cerr << e.what() << "\n";
+
+            return 1;
+         }
+
+         compress( builder, dest, s );
+      } else if( src == "-" ) {
+         ag::stream_graph graph( cin );
+
+         compress( graph, dest, s );
+      } else if( threads > 1 ) {
+         ag::parallel_graph graph = ag::parallel_graph::load( src, threads );
+
+         compress( graph, dest, s );
+      } else {
+         ag::offline_graph graph = ag::offline_graph::load( src );
+
+         cerr << "About to call store offline graph...\n";
+         compress( graph, dest, s );
+      }
+
+      if( print_stats ) 
+         stats.report( cerr );
    }
    else {
       if ( write_offsets ) {
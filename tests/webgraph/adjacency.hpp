@@ -0,0 +1,74 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef TESTS_ADJACENCY_HPP_
+#define TESTS_ADJACENCY_HPP_
+
+#include <vector>
+#include <string>
+#include <cassert>
+#include <boost/tuple/tuple.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/successor_source.hpp"
+#include "../../webgraph/csr_view.hpp"
+
+/*!
+ * Successor lists held as plain vectors, which the tests use as a reference to compare
+ * graphs and to run naive versions of the algorithms on.
+ */
+typedef std::vector< std::vector<unsigned int> > adjacency;
+
+/** Decodes all the lists of g, any graph with a successor_source_traits specialization. */
+template<class source_type>
+adjacency to_adjacency( const source_type& g ) {
+   typedef webgraph::successor_source_traits<source_type> traits;
+
+   adjacency a( traits::num_nodes( g ) );
+   typename traits::node_iterator i, end;
+   long x = 0;
+
+   for( boost::tie( i, end ) = traits::nodes( g ); i != end; ++i, ++x ) 
+      a[x].resize( traits::successors( i, a[x] ) );
+
+   assert( x == (long)a.size() );
+
+   return a;
+}
+
+/** Stores a as a BV graph under basename, and returns it loaded with offsets. */
+inline webgraph::bv_graph::graph::graph_ptr store_adjacency( const adjacency& a, 
+                                                             const std::string& basename ) {
+   const long n = a.size();
+   std::vector<long> offsets( 1, 0 );
+   std::vector<int> targets;
+
+   for( long x = 0; x < n; x++ ) {
+      targets.insert( targets.end(), a[x].begin(), a[x].end() );
+      offsets.push_back( targets.size() );
+   }
+
+   webgraph::bv_graph::graph::store( 
+      webgraph::csr_view<long, int>( n, &offsets[0], targets.empty() ? NULL : &targets[0] ), 
+      basename, -1, -1, -1, -1, 0 );
+
+   return webgraph::bv_graph::graph::load( basename );
+}
+
+#endif /*TESTS_ADJACENCY_HPP_*/
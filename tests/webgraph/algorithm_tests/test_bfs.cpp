@@ -0,0 +1,109 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cassert>
+
+#include "../../../webgraph/webgraph.hpp"
+#include "../../../webgraph/bfs.hpp"
+#include "../adjacency.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+/** A plain queue-based visit, for reference. */
+vector<int> reference_distances( const adjacency& a, int source ) {
+   vector<int> distance( a.size(), -1 );
+   deque<int> queue( 1, source );
+
+   distance[ source ] = 0;
+
+   while( !queue.empty() ) {
+      int x = queue.front();
+      queue.pop_front();
+
+      for( unsigned j = 0; j < a[x].size(); j++ ) 
+         if( distance[ a[x][j] ] == -1 ) {
+            distance[ a[x][j] ] = distance[x] + 1;
+            queue.push_back( a[x][j] );
+         }
+   }
+
+   return distance;
+}
+
+/** Checks distances against the reference, and that parents form a visit tree. */
+void check_visit( const bfs::engine& e, const adjacency& a, int source ) {
+   vector<int> distance, parent;
+   vector<int> expected = reference_distances( a, source );
+
+   long reached = e.visit( source, distance, parent );
+
+   assert( distance == expected );
+   assert( reached == (long)( a.size() - count( expected.begin(), expected.end(), -1 ) ) );
+   assert( parent[ source ] == source );
+
+   for( unsigned y = 0; y < a.size(); y++ ) {
+      if( distance[y] <= 0 ) {
+         assert( distance[y] == 0 || parent[y] == -1 );
+         continue;
+      }
+
+      const vector<unsigned int>& s = a[ parent[y] ];
+
+      assert( distance[ parent[y] ] == distance[y] - 1 );
+      assert( binary_search( s.begin(), s.end(), y ) );
+   }
+}
+
+/*
+ * Checks visits with and without direction switching, with one and more threads, on a
+ * compressed and on a decompressed graph, against a plain breadth-first visit.
+ *
+ * Usage: test_bfs BASENAME
+ */
+int main( int argc, char** argv ) {
+   assert( argc == 2 );
+
+   bv_graph::graph::graph_ptr g = bv_graph::graph::load( argv[1] );
+   bv_graph::graph::graph_ptr d = bv_graph::graph::load_decompressed( argv[1] );
+   adjacency a = to_adjacency( *g );
+
+   const int sources[] = { 0, (int)a.size() / 2, (int)a.size() - 1 };
+
+   for( int k = 0; k < 4; k++ ) {
+      bfs::bfs_parameters p;
+      p.direction_switching = k & 1;
+      p.threads = k & 2 ? 3 : 1;
+
+      bfs::engine e( *g, p ), f( *d, p );
+
+      for( int s = 0; s < 3; s++ ) {
+         check_visit( e, a, sources[s] );
+         check_visit( f, a, sources[s] );
+      }
+   }
+
+   cerr << "BFS test passed.\n";
+
+   return 0;
+}
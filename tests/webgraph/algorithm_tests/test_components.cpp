@@ -0,0 +1,260 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <cassert>
+
+#include "../../../webgraph/webgraph.hpp"
+#include "../../../webgraph/components.hpp"
+#include "../../../webgraph/transform.hpp"
+#include "../../../webgraph/csr_view.hpp"
+#include "../adjacency.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+/** Numbers weakly connected components by visits of the symmetrized graph, started from
+ * nodes in increasing order. */
+vector<int> reference_components( const adjacency& a ) {
+   const long n = a.size();
+   adjacency u( n );
+
+   for( long x = 0; x < n; x++ ) 
+      for( unsigned j = 0; j < a[x].size(); j++ ) {
+         u[x].push_back( a[x][j] );
+         u[ a[x][j] ].push_back( x );
+      }
+
+   vector<int> component( n, -1 );
+   int c = 0;
+
+   for( long s = 0; s < n; s++ ) {
+      if( component[s] != -1 )
+         continue;
+
+      deque<int> queue( 1, s );
+      component[s] = c;
+
+      while( !queue.empty() ) {
+         int x = queue.front();
+         queue.pop_front();
+
+         for( unsigned j = 0; j < u[x].size(); j++ ) 
+            if( component[ u[x][j] ] == -1 ) {
+               component[ u[x][j] ] = c;
+               queue.push_back( u[x][j] );
+            }
+      }
+
+      c++;
+   }
+
+   return component;
+}
+
+/** Visits a from each node not visited yet, in order, and appends the nodes to order as
+ * they are left. */
+void finishing_order( const adjacency& a, vector<int>& order ) {
+   vector<char> seen( a.size() );
+   vector< pair<int, unsigned> > stack;
+
+   for( unsigned s = 0; s < a.size(); s++ ) {
+      if( seen[s] )
+         continue;
+
+      seen[s] = true;
+      stack.push_back( make_pair( s, 0 ) );
+
+      while( !stack.empty() ) {
+         pair<int, unsigned>& top = stack.back();
+
+         if( top.second < a[ top.first ].size() ) {
+            int y = a[ top.first ][ top.second++ ];
+
+            if( !seen[y] ) {
+               seen[y] = true;
+               stack.push_back( make_pair( y, 0 ) );
+            }
+         } else {
+            order.push_back( top.first );
+            stack.pop_back();
+         }
+      }
+   }
+}
+
+/** The transpose of a. */
+adjacency reversed( const adjacency& a ) {
+   adjacency r( a.size() );
+
+   for( unsigned x = 0; x < a.size(); x++ ) 
+      for( unsigned j = 0; j < a[x].size(); j++ ) 
+         r[ a[x][j] ].push_back( x );
+
+   return r;
+}
+
+/** Numbers strongly connected components by Kosaraju's algorithm, then in the order of
+ * their smallest node. */
+vector<int> reference_strong_components( const adjacency& a ) {
+   const long n = a.size();
+   adjacency t = reversed( a );
+
+   vector<int> order, label( n, -1 );
+   finishing_order( a, order );
+
+   for( long k = n - 1; k >= 0; k-- ) {
+      if( label[ order[k] ] != -1 )
+         continue;
+
+      deque<int> queue( 1, order[k] );
+      label[ order[k] ] = order[k];
+
+      while( !queue.empty() ) {
+         int x = queue.front();
+         queue.pop_front();
+
+         for( unsigned j = 0; j < t[x].size(); j++ ) 
+            if( label[ t[x][j] ] == -1 ) {
+               label[ t[x][j] ] = order[k];
+               queue.push_back( t[x][j] );
+            }
+      }
+   }
+
+   vector<int> id( n, -1 ), component( n );
+   int c = 0;
+
+   for( long x = 0; x < n; x++ ) {
+      if( id[ label[x] ] == -1 )
+         id[ label[x] ] = c++;
+
+      component[x] = id[ label[x] ];
+   }
+
+   return component;
+}
+
+/** Checks the parallel strongly connected components of a, stored under basename, with
+ * one and more threads, and with and without going on sequentially at the end. */
+void check_strong_components( const adjacency& a, const string& basename ) {
+   bv_graph::graph::graph_ptr g = store_adjacency( a, basename );
+   bv_graph::graph::graph_ptr t = store_adjacency( reversed( a ), basename + "-t" );
+   const vector<int> strong = reference_strong_components( a );
+   vector<int> component;
+   vector<long> sizes;
+
+   for( int threads = 1; threads <= 3; threads += 2 ) {
+      components::strongly_connected( *g, *t, component, sizes, threads );
+      assert( component == strong );
+
+      components::strongly_connected( *g, *t, component, sizes, threads, NULL, 0 );
+      assert( component == strong );
+   }
+}
+
+/*
+ * Checks weakly connected components, on a sequential and on a random-access graph with
+ * several threads, against visits of the symmetrized graph, and strongly connected
+ * components, by Tarjan's algorithm and by coloring (with the transpose stored under
+ * TEMP_BASENAME), against Kosaraju's algorithm. Coloring is also checked on long chains,
+ * which must be trimmed or handed to Tarjan's algorithm rather than colored round after
+ * round.
+ *
+ * Usage: test_components BASENAME TEMP_BASENAME
+ */
+int main( int argc, char** argv ) {
+   assert( argc == 3 );
+
+   bv_graph::graph::graph_ptr seq = bv_graph::graph::load_sequential( argv[1] );
+   bv_graph::graph::graph_ptr g = bv_graph::graph::load( argv[1] );
+   adjacency a = to_adjacency( *seq );
+   vector<int> expected = reference_components( a );
+
+   vector<int> component;
+   vector<long> sizes;
+
+   long k = components::weakly_connected( *seq, component, sizes );
+   assert( component == expected );
+   assert( k == (long)sizes.size() );
+
+   long total = 0;
+   for( long c = 0; c < k; c++ ) 
+      total += sizes[c];
+   assert( total == g->get_num_nodes() );
+
+   vector<int> threaded;
+   vector<long> threaded_sizes;
+
+   components::weakly_connected( *g, threaded, threaded_sizes, 3 );
+   assert( threaded == expected && threaded_sizes == sizes );
+
+   const long n = g->get_num_nodes();
+   vector<long> offsets;
+   vector<int> targets;
+
+   transform::transpose_in_memory( *g, offsets, targets );
+   bv_graph::graph::store( csr_view<long, int>( n, &offsets[0], &targets[0] ), argv[2], 
+                           -1, -1, -1, -1, 0 );
+
+   bv_graph::graph::graph_ptr t = bv_graph::graph::load( argv[2] );
+   bv_graph::graph::graph_ptr d = bv_graph::graph::load_decompressed( argv[1] );
+   vector<int> strong = reference_strong_components( a );
+
+   components::strongly_connected( *g, component, sizes );
+   assert( component == strong );
+
+   components::strongly_connected( *d, component, sizes );
+   assert( component == strong );
+
+   components::strongly_connected( *g, *t, threaded, threaded_sizes, 1 );
+   assert( threaded == strong && threaded_sizes == sizes );
+
+   components::strongly_connected( *g, *t, threaded, threaded_sizes, 3 );
+   assert( threaded == strong && threaded_sizes == sizes );
+
+   components::strongly_connected( *g, *t, threaded, threaded_sizes, 3, NULL, 0 );
+   assert( threaded == strong && threaded_sizes == sizes );
+
+   // A reversed path, trimmed away node by node, and a reversed ladder of 2-cycles, where
+   // coloring alone would settle one cycle per round.
+   const long length = 100000;
+   adjacency path( length ), ladder( length );
+
+   for( long x = 1; x < length; x++ ) 
+      path[x].push_back( x - 1 );
+
+   for( long x = 0; x + 1 < length; x += 2 ) {
+      if( x > 0 )
+         ladder[x].push_back( x - 1 );
+
+      ladder[x].push_back( x + 1 );
+      ladder[ x + 1 ].push_back( x );
+   }
+
+   check_strong_components( path, string( argv[2] ) + "-path" );
+   check_strong_components( ladder, string( argv[2] ) + "-ladder" );
+
+   cerr << "Components test passed.\n";
+
+   return 0;
+}
@@ -0,0 +1,166 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <string>
+#include <cassert>
+
+#include "../../../webgraph/webgraph.hpp"
+#include "../../../webgraph/cores.hpp"
+#include "../../../webgraph/transform.hpp"
+#include "../../../webgraph/csr_view.hpp"
+#include "../adjacency.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+/** Core numbers by the definition: for k = 0, 1, ..., repeatedly remove the nodes of
+ * degree at most k, giving them core number k. In the symmetrized graph a pair of opposite
+ * arcs is a single edge. */
+vector<int> reference_cores( const adjacency& a, cores::degree_type type ) {
+   const long n = a.size();
+   vector< set<int> > u( n );
+   adjacency neighbours( n );
+   vector<int> degree( n ), core( n, -1 );
+
+   for( long x = 0; x < n; x++ ) 
+      for( unsigned j = 0; j < a[x].size(); j++ ) {
+         const int y = a[x][j];
+
+         if( y == x )
+            continue;
+
+         if( type != cores::IN ) 
+            u[y].insert( x );
+         if( type != cores::OUT ) 
+            u[x].insert( y );
+      }
+
+   // Peeling x lowers the degree of each y in u[x], so the degree of y counts those x.
+   for( long x = 0; x < n; x++ ) {
+      neighbours[x].assign( u[x].begin(), u[x].end() );
+
+      for( unsigned j = 0; j < neighbours[x].size(); j++ ) 
+         degree[ neighbours[x][j] ]++;
+   }
+
+   long left = n;
+
+   for( int k = 0; left > 0; k++ ) 
+      for( bool removed = true; removed; ) {
+         removed = false;
+
+         for( long x = 0; x < n; x++ ) 
+            if( core[x] == -1 && degree[x] <= k ) {
+               core[x] = k;
+               left--;
+               removed = true;
+
+               for( unsigned j = 0; j < neighbours[x].size(); j++ ) 
+                  degree[ neighbours[x][j] ]--;
+            }
+      }
+
+   return core;
+}
+
+/*
+ * Checks core numbers of all three types, sequential and parallel, on a compressed and a
+ * decompressed graph, against their definition, and symmetrized cores on a small graph
+ * with opposite arcs. The transposes and the small graph are stored under TEMP_BASENAME.
+ *
+ * Usage: test_cores BASENAME TEMP_BASENAME
+ */
+int main( int argc, char** argv ) {
+   assert( argc == 3 );
+
+   bv_graph::graph::graph_ptr g = bv_graph::graph::load( argv[1] );
+   bv_graph::graph::graph_ptr d = bv_graph::graph::load_decompressed( argv[1] );
+   const long n = g->get_num_nodes();
+
+   vector<long> offsets;
+   vector<int> targets;
+
+   transform::transpose_in_memory( *g, offsets, targets );
+   bv_graph::graph::store( csr_view<long, int>( n, &offsets[0], &targets[0] ), argv[2], 
+                           -1, -1, -1, -1, 0 );
+
+   bv_graph::graph::graph_ptr t = bv_graph::graph::load( argv[2] );
+   adjacency a = to_adjacency( *g );
+
+   const cores::degree_type types[] = { cores::IN, cores::OUT, cores::ALL };
+
+   for( int k = 0; k < 3; k++ ) {
+      vector<int> expected = reference_cores( a, types[k] ), core;
+      const int degeneracy = *max_element( expected.begin(), expected.end() );
+
+      assert( cores::decompose( *g, t.get(), types[k], core ) == degeneracy );
+      assert( core == expected );
+
+      assert( cores::decompose( *d, t.get(), types[k], core ) == degeneracy );
+      assert( core == expected );
+
+      assert( cores::decompose_parallel( *g, t.get(), types[k], core, 1 ) == degeneracy );
+      assert( core == expected );
+
+      assert( cores::decompose_parallel( *g, t.get(), types[k], core, 3 ) == degeneracy );
+      assert( core == expected );
+
+      cerr << "degeneracy " << degeneracy << "\n";
+   }
+
+   // A complete digraph on 0-3, a one-way cycle 4 -> 5 -> 6 -> 4, an arc 0 -> 4 and a loop
+   // on 5. Opposite arcs are single edges, so 0-3 make a 3-core, not a 6-core.
+   adjacency r( 7 );
+
+   for( int x = 0; x < 4; x++ ) 
+      for( int y = 0; y < 4; y++ ) 
+         if( x != y )
+            r[x].push_back( y );
+
+   r[0].push_back( 4 );
+   r[4].push_back( 5 );
+   r[5].push_back( 5 );
+   r[5].push_back( 6 );
+   r[6].push_back( 4 );
+
+   adjacency rt( r.size() );
+
+   for( unsigned x = 0; x < r.size(); x++ ) 
+      for( unsigned j = 0; j < r[x].size(); j++ ) 
+         rt[ r[x][j] ].push_back( x );
+
+   bv_graph::graph::graph_ptr rg = store_adjacency( r, string( argv[2] ) + "-r" );
+   bv_graph::graph::graph_ptr rgt = store_adjacency( rt, string( argv[2] ) + "-rt" );
+
+   const int r_cores[] = { 3, 3, 3, 3, 2, 2, 2 };
+   vector<int> expected( r_cores, r_cores + 7 ), core;
+
+   assert( reference_cores( r, cores::ALL ) == expected );
+   assert( cores::decompose( *rg, rgt.get(), cores::ALL, core ) == 3 );
+   assert( core == expected );
+   assert( cores::decompose_parallel( *rg, rgt.get(), cores::ALL, core, 3 ) == 3 );
+   assert( core == expected );
+
+   cerr << "Cores test passed.\n";
+
+   return 0;
+}
@@ -0,0 +1,108 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cassert>
+
+#include "../../../webgraph/webgraph.hpp"
+#include "../../../webgraph/degrees.hpp"
+#include "../adjacency.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+void check_equal( const degrees::statistics& s, const degrees::statistics& t ) {
+   assert( s.nodes == t.nodes && s.arcs == t.arcs );
+   assert( s.indegree == t.indegree && s.outdegree == t.outdegree );
+   assert( s.in_distribution == t.in_distribution );
+   assert( s.out_distribution == t.out_distribution );
+   assert( s.max_indegree == t.max_indegree && s.max_outdegree == t.max_outdegree );
+   assert( s.dangling == t.dangling && s.self_loops == t.self_loops );
+   assert( s.graph_bits == t.graph_bits );
+}
+
+/*
+ * Checks degree statistics, sequential and parallel, against a direct count, and that
+ * they survive a round trip through the binary format, written to TEMP_BASENAME.degrees.
+ *
+ * Usage: test_degrees BASENAME TEMP_BASENAME
+ */
+int main( int argc, char** argv ) {
+   assert( argc == 3 );
+
+   bv_graph::graph::graph_ptr g = bv_graph::graph::load( argv[1] );
+   const long n = g->get_num_nodes();
+
+   adjacency a = to_adjacency( *g );
+
+   vector<int> indegree( n ), outdegree( n );
+   long arcs = 0, self_loops = 0;
+
+   for( long x = 0; x < n; x++ ) {
+      outdegree[x] = a[x].size();
+      arcs += a[x].size();
+
+      for( unsigned j = 0; j < a[x].size(); j++ ) {
+         indegree[ a[x][j] ]++;
+         self_loops += a[x][j] == (unsigned)x;
+      }
+   }
+
+   degrees::statistics s, t;
+   degrees::compute( *g, s );
+
+   assert( s.nodes == n && s.arcs == arcs && s.self_loops == self_loops );
+   assert( s.indegree == indegree && s.outdegree == outdegree );
+   assert( s.max_indegree == *max_element( indegree.begin(), indegree.end() ) );
+   assert( s.max_outdegree == *max_element( outdegree.begin(), outdegree.end() ) );
+   assert( s.dangling == count( outdegree.begin(), outdegree.end(), 0 ) );
+   assert( s.graph_bits > 0 );
+
+   long in_total = 0, out_total = 0;
+
+   for( int d = 0; d <= s.max_indegree; d++ ) {
+      assert( s.in_distribution[d] == count( indegree.begin(), indegree.end(), d ) );
+      in_total += s.in_distribution[d];
+   }
+
+   for( int d = 0; d <= s.max_outdegree; d++ ) {
+      assert( s.out_distribution[d] == count( outdegree.begin(), outdegree.end(), d ) );
+      out_total += s.out_distribution[d];
+   }
+
+   assert( in_total == n && out_total == n );
+
+   degrees::compute( *g, t, 3 );
+   check_equal( s, t );
+
+   const string filename = string( argv[2] ) + ".degrees";
+
+   degrees::store( s, filename );
+   degrees::load( filename, t, 2 );
+   check_equal( s, t );
+
+   cerr << "arcs " << s.arcs << ", dangling " << s.dangling << ", self-loops " 
+        << s.self_loops << ", " << s.bits_per_link << " bits/link\n";
+   cerr << "Degrees test passed.\n";
+
+   return 0;
+}
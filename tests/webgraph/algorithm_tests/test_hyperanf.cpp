@@ -0,0 +1,112 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <cmath>
+#include <cassert>
+
+#include "../../../webgraph/webgraph.hpp"
+#include "../../../webgraph/generators.hpp"
+#include "../../../webgraph/hyperanf.hpp"
+#include "../adjacency.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+/** The exact neighbourhood function, by a visit from every node. */
+vector<double> exact_neighbourhood_function( const adjacency& a ) {
+   vector<double> nf;
+   vector<int> distance( a.size() );
+
+   for( unsigned s = 0; s < a.size(); s++ ) {
+      fill( distance.begin(), distance.end(), -1 );
+      deque<int> queue( 1, s );
+      distance[s] = 0;
+
+      while( !queue.empty() ) {
+         int x = queue.front();
+         queue.pop_front();
+
+         if( distance[x] >= (int)nf.size() )
+            nf.resize( distance[x] + 1 );
+         nf[ distance[x] ]++;
+
+         for( unsigned j = 0; j < a[x].size(); j++ ) 
+            if( distance[ a[x][j] ] == -1 ) {
+               distance[ a[x][j] ] = distance[x] + 1;
+               queue.push_back( a[x][j] );
+            }
+      }
+   }
+
+   for( unsigned t = 1; t < nf.size(); t++ ) 
+      nf[t] += nf[t - 1];
+
+   return nf;
+}
+
+/*
+ * Checks HyperANF against the exact neighbourhood function of a small random graph,
+ * stored under TEMP_BASENAME, and that it does not depend on the number of threads.
+ *
+ * Usage: test_hyperanf TEMP_BASENAME
+ */
+int main( int argc, char** argv ) {
+   assert( argc == 2 );
+
+   generators::generator_parameters gp;
+   gp.type = generators::UNIFORM;
+   gp.n = 3000;
+   gp.avg_degree = 2;
+   gp.seed = 5;
+
+   bv_graph::graph::store( generators::generated_graph( gp, 1 ), argv[1], 
+                           -1, -1, -1, -1, 0 );
+
+   bv_graph::graph::graph_ptr seq = bv_graph::graph::load_sequential( argv[1] );
+   bv_graph::graph::graph_ptr g = bv_graph::graph::load( argv[1] );
+   vector<double> exact = exact_neighbourhood_function( to_adjacency( *seq ) );
+
+   hyperanf::anf_parameters p;
+   p.log2m = 8;
+
+   vector<double> nf, threaded;
+
+   hyperanf::neighbourhood_function( *seq, nf, p );
+
+   p.threads = 3;
+   hyperanf::neighbourhood_function( *g, threaded, p );
+
+   assert( threaded == nf );
+   assert( nf.size() <= exact.size() + 1 && nf.size() + 1 >= exact.size() );
+
+   for( unsigned t = 0; t < min( nf.size(), exact.size() ); t++ ) {
+      assert( t == 0 || nf[t] >= nf[t - 1] );
+      assert( fabs( nf[t] - exact[t] ) < .05 * exact[t] );
+   }
+
+   assert( fabs( hyperanf::average_distance( nf ) - hyperanf::average_distance( exact ) ) 
+           < .1 * hyperanf::average_distance( exact ) );
+
+   cerr << "HyperANF test passed.\n";
+
+   return 0;
+}
@@ -0,0 +1,145 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cassert>
+
+#include "../../../webgraph/webgraph.hpp"
+#include "../../../webgraph/pagerank.hpp"
+#include "../../../webgraph/transform.hpp"
+#include "../../../webgraph/csr_view.hpp"
+#include "../adjacency.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+/** The textbook power iteration, for reference. */
+vector<double> reference_pagerank( const adjacency& a, double alpha, int iterations ) {
+   const long n = a.size();
+   vector<double> rank( n, 1.0 / n ), next( n );
+
+   for( int k = 0; k < iterations; k++ ) {
+      double dangling = 0;
+
+      fill( next.begin(), next.end(), 0.0 );
+
+      for( long x = 0; x < n; x++ ) {
+         if( a[x].empty() )
+            dangling += rank[x];
+
+         for( unsigned j = 0; j < a[x].size(); j++ ) 
+            next[ a[x][j] ] += rank[x] / a[x].size();
+      }
+
+      for( long x = 0; x < n; x++ ) 
+         next[x] = alpha * ( next[x] + dangling / n ) + ( 1 - alpha ) / n;
+
+      rank.swap( next );
+   }
+
+   return rank;
+}
+
+double l1_distance( const vector<double>& a, const vector<double>& b ) {
+   double d = 0;
+
+   for( unsigned i = 0; i < a.size(); i++ ) 
+      d += fabs( a[i] - b[i] );
+
+   return d;
+}
+
+/*
+ * Checks push and pull PageRank against a plain power iteration, and that pull mode gives
+ * the same ranks with any number of threads, and from a compressed transpose, stored under
+ * TEMP_BASENAME.
+ *
+ * Usage: test_pagerank BASENAME TEMP_BASENAME
+ */
+int main( int argc, char** argv ) {
+   assert( argc == 3 );
+
+   bv_graph::graph::graph_ptr seq = bv_graph::graph::load_sequential( argv[1] );
+   bv_graph::graph::graph_ptr g = bv_graph::graph::load( argv[1] );
+   const long n = g->get_num_nodes();
+
+   vector<long> offsets;
+   vector<int> preds;
+
+   transform::transpose_in_memory( *g, offsets, preds );
+   bv_graph::graph::store( csr_view<long, int>( n, &offsets[0], &preds[0] ), argv[2], 
+                           -1, -1, -1, -1, 0 );
+
+   bv_graph::graph::graph_ptr t = bv_graph::graph::load( argv[2] );
+   bv_graph::graph::graph_ptr seq_t = bv_graph::graph::load_sequential( argv[2] );
+
+   pagerank::pagerank_parameters p;
+   p.tolerance = 0;
+   p.max_iterations = 30;
+
+   vector<double> expected = reference_pagerank( to_adjacency( *seq ), p.alpha, 
+                                                 p.max_iterations );
+
+   vector<double> push, pull, pull_threads;
+   double delta;
+
+   int iterations = pagerank::compute( *seq, push, p, &delta );
+   assert( iterations == p.max_iterations && delta > 0 );
+   assert( l1_distance( push, expected ) < 1e-9 );
+
+   p.pull = true;
+   pagerank::compute( *g, pull, p );
+   assert( l1_distance( pull, expected ) < 1e-9 );
+
+   p.threads = 3;
+   pagerank::compute( *g, pull_threads, p );
+   assert( pull_threads == pull );
+
+   // The stored transpose lists predecessors in the same order, so the sums are the same.
+   vector<double> from_transpose;
+
+   p.transpose = t.get();
+   pagerank::compute( *g, from_transpose, p );
+   assert( from_transpose == pull );
+
+   p.threads = 1;
+   p.transpose = seq_t.get();
+   pagerank::compute( *seq, from_transpose, p );
+   assert( from_transpose == pull );
+
+   p.transpose = NULL;
+
+   double sum = 0;
+   for( unsigned x = 0; x < pull.size(); x++ ) 
+      sum += pull[x];
+   assert( fabs( sum - 1 ) < 1e-9 );
+
+   // Float ranks, stopping on tolerance.
+   vector<float> single;
+   p.tolerance = 1e-4;
+   p.max_iterations = 1000;
+   iterations = pagerank::compute( *g, single, p, &delta );
+   assert( iterations < p.max_iterations && delta < p.tolerance );
+
+   cerr << "PageRank test passed.\n";
+
+   return 0;
+}
@@ -0,0 +1,170 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+
+#include "../../../webgraph/webgraph.hpp"
+#include "../../../webgraph/random_walks.hpp"
+#include "../adjacency.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+/** Personalized PageRank from s by power iteration, jumping to s from nodes without
+ * successors. */
+vector<double> reference_ppr( const adjacency& a, int s, double alpha ) {
+   const long n = a.size();
+   vector<double> rank( n ), next( n );
+
+   rank[s] = 1;
+
+   for( int k = 0; k < 200; k++ ) {
+      fill( next.begin(), next.end(), 0.0 );
+      next[s] = 1 - alpha;
+
+      for( long x = 0; x < n; x++ ) {
+         if( a[x].empty() ) 
+            next[s] += alpha * rank[x];
+         else
+            for( unsigned j = 0; j < a[x].size(); j++ ) 
+               next[ a[x][j] ] += alpha * rank[x] / a[x].size();
+      }
+
+      rank.swap( next );
+   }
+
+   return rank;
+}
+
+/*
+ * Checks graph::successor against full decoding, that walks follow arcs and do not depend
+ * on threads or grouping, and personalized PageRank against power iteration.
+ *
+ * Usage: test_random_walks BASENAME
+ */
+int main( int argc, char** argv ) {
+   assert( argc == 2 );
+
+   bv_graph::graph::graph_ptr g = bv_graph::graph::load( argv[1] );
+   bv_graph::graph::graph_ptr d = bv_graph::graph::load_decompressed( argv[1] );
+   const long n = g->get_num_nodes();
+
+   adjacency a = to_adjacency( *g );
+
+   // Decoding a prefix is quadratic in the outdegree, so only a few positions are checked
+   // on the compressed graph.
+   for( long x = 0; x < n; x++ ) {
+      const int k = a[x].size();
+
+      for( int i = 0; i < k; i++ ) 
+         assert( d->successor( x, i ) == (int)a[x][i] );
+
+      for( int i = 0; i < k; i = i < k - 1 ? min( k - 1, 2 * i + 1 ) : k ) 
+         assert( g->successor( x, i ) == (int)a[x][i] );
+   }
+
+   const int length = 8;
+   vector<int> starts;
+
+   for( long x = 0; x < n; x++ ) 
+      starts.insert( starts.end(), 2, x );
+
+   random_walks::walk_parameters p;
+   vector<int> walks, other;
+
+   p.seed = 17;
+   random_walks::walk( *g, starts, length, walks, p );
+
+   for( size_t w = 0; w < starts.size(); w++ ) {
+      const int* path = &walks[ w * ( length + 1 ) ];
+
+      assert( path[0] == starts[w] );
+
+      for( int t = 1; t <= length; t++ ) {
+         if( path[ t - 1 ] == -1 || a[ path[ t - 1 ] ].empty() ) 
+            assert( path[t] == -1 );
+         else {
+            const adjacency::value_type& s = a[ path[ t - 1 ] ];
+
+            assert( find( s.begin(), s.end(), (unsigned)path[t] ) != s.end() );
+         }
+      }
+   }
+
+   p.threads = 3;
+   random_walks::walk( *g, starts, length, other, p );
+   assert( other == walks );
+
+   p.bucket_bits = 0;
+   random_walks::walk( *d, starts, length, other, p );
+   assert( other == walks );
+
+   const double alpha = .85;
+   const int walks_per_source = 20000;
+   vector<int> sources;
+
+   for( int k = 0; k < 4; k++ ) 
+      sources.push_back( k * ( n / 4 ) );
+
+   vector< vector< pair<int, double> > > ppr, ppr_threads;
+
+   p = random_walks::walk_parameters();
+   random_walks::personalized_pagerank( *g, sources, walks_per_source, alpha, ppr, 0, p );
+
+   p.threads = 3;
+   random_walks::personalized_pagerank( *d, sources, walks_per_source, alpha, ppr_threads, 
+                                        0, p );
+   assert( ppr == ppr_threads );
+
+   for( size_t k = 0; k < sources.size(); k++ ) {
+      vector<double> expected = reference_ppr( a, sources[k], alpha );
+      vector<double> estimate( n );
+      double sum = 0, error = 0;
+
+      for( size_t i = 0; i < ppr[k].size(); i++ ) {
+         assert( i == 0 || ppr[k][i - 1].second >= ppr[k][i].second );
+
+         estimate[ ppr[k][i].first ] = ppr[k][i].second;
+         sum += ppr[k][i].second;
+      }
+
+      for( long x = 0; x < n; x++ ) 
+         error = max( error, fabs( estimate[x] - expected[x] ) );
+
+      cerr << "source " << sources[k] << ": sum " << sum << ", max error " << error << "\n";
+
+      assert( fabs( sum - 1 ) < .03 );
+      assert( error < .03 );
+   }
+
+   random_walks::personalized_pagerank( *d, sources, walks_per_source, alpha, ppr, 5, p );
+
+   for( size_t k = 0; k < sources.size(); k++ ) {
+      assert( ppr[k].size() <= 5 );
+      assert( equal( ppr[k].begin(), ppr[k].end(), ppr_threads[k].begin() ) );
+   }
+
+   cerr << "Random walks test passed.\n";
+
+   return 0;
+}
@@ -0,0 +1,115 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <cmath>
+#include <cassert>
+
+#include "../../../webgraph/webgraph.hpp"
+#include "../../../webgraph/triangles.hpp"
+#include "../../../webgraph/transform.hpp"
+#include "../../../webgraph/csr_view.hpp"
+#include "../adjacency.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+/** Counts, for each node x, the pairs of neighbours y < z of x that are neighbours. */
+vector<long> reference_triangles( const adjacency& a ) {
+   const long n = a.size();
+   vector< set<int> > u( n );
+
+   for( long x = 0; x < n; x++ ) 
+      for( unsigned j = 0; j < a[x].size(); j++ ) 
+         if( (long)a[x][j] != x ) {
+            u[x].insert( a[x][j] );
+            u[ a[x][j] ].insert( x );
+         }
+
+   vector<long> t( n );
+
+   for( long x = 0; x < n; x++ ) 
+      for( set<int>::iterator y = u[x].begin(); y != u[x].end(); ++y ) 
+         for( set<int>::iterator z = y; ++z != u[x].end(); ) 
+            t[x] += u[ *y ].count( *z );
+
+   return t;
+}
+
+/*
+ * Checks exact triangle counts, with one and more threads, against a count over sets of
+ * neighbours, and that sampling gets close to the exact transitivity. The transpose is
+ * stored under TEMP_BASENAME.
+ *
+ * Usage: test_triangles BASENAME TEMP_BASENAME
+ */
+int main( int argc, char** argv ) {
+   assert( argc == 3 );
+
+   bv_graph::graph::graph_ptr g = bv_graph::graph::load( argv[1] );
+   const long n = g->get_num_nodes();
+
+   vector<long> offsets;
+   vector<int> targets;
+
+   transform::transpose_in_memory( *g, offsets, targets );
+   bv_graph::graph::store( csr_view<long, int>( n, &offsets[0], &targets[0] ), argv[2], 
+                           -1, -1, -1, -1, 0 );
+
+   bv_graph::graph::graph_ptr t = bv_graph::graph::load( argv[2] );
+   bv_graph::graph::graph_ptr seq = bv_graph::graph::load_sequential( argv[1] );
+   bv_graph::graph::graph_ptr seq_t = bv_graph::graph::load_sequential( argv[2] );
+
+   vector<long> expected = reference_triangles( to_adjacency( *g ) );
+   long expected_total = 0;
+   for( long x = 0; x < n; x++ ) 
+      expected_total += expected[x];
+   expected_total /= 3;
+
+   vector<long> per_node, threaded;
+   vector<int> degree, threaded_degree;
+
+   long total = triangles::count( *seq, *seq_t, per_node, degree );
+   assert( total == expected_total && per_node == expected );
+
+   total = triangles::count( *g, *t, threaded, threaded_degree, 3 );
+   assert( total == expected_total && threaded == expected && threaded_degree == degree );
+
+   vector<double> c;
+   triangles::local_clustering( per_node, degree, c );
+   for( long x = 0; x < n; x++ ) 
+      assert( c[x] >= 0 && c[x] <= 1 );
+
+   const double exact = 3 * total / triangles::wedges( degree );
+   double tau, tau_threaded;
+
+   double estimate = triangles::sample( *g, *t, 100000, 7, 1, &tau );
+   assert( fabs( tau - exact ) < .02 );
+   assert( fabs( estimate - total ) < .1 * total );
+
+   triangles::sample( *g, *t, 100000, 7, 3, &tau_threaded );
+   assert( tau_threaded == tau );
+
+   cerr << "Triangles test passed (" << total << " triangles, transitivity " << exact 
+        << ", sampled " << tau << ").\n";
+
+   return 0;
+}
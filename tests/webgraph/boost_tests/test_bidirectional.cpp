@@ -0,0 +1,111 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "../../../webgraph/boost/bidirectional.hpp"
+#include "../../../webgraph/transform.hpp"
+#include "../../../webgraph/csr_view.hpp"
+
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/page_rank.hpp>
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cassert>
+
+using namespace std;
+using namespace webgraph;
+
+typedef bv_graph::boost_integration::bidirectional_graph bidirectional_graph;
+typedef boost::graph_traits<bidirectional_graph> traits;
+
+/*
+ * Checks the arcs into and out of each node of a bidirectional graph against the graph
+ * itself, and that BGL's PageRank gives the same ranks pulling through in_edges() as
+ * pushing through out_edges(). The transpose is stored under TEMP_BASENAME.
+ *
+ * Usage: test_bidirectional BASENAME TEMP_BASENAME
+ */
+int main( int argc, char** argv ) {
+   boost::function_requires< boost::BidirectionalGraphConcept<bidirectional_graph> >();
+
+   assert( argc == 3 );
+
+   bv_graph::graph::graph_ptr g = bv_graph::graph::load( argv[1] );
+   const long n = g->get_num_nodes();
+
+   vector<long> offsets;
+   vector<int> targets;
+
+   transform::transpose_in_memory( *g, offsets, targets );
+   bv_graph::graph::store( csr_view<long, int>( n, &offsets[0], &targets[0] ), argv[2], 
+                           -1, -1, -1, -1, 0 );
+
+   bidirectional_graph b( g, bv_graph::graph::load( argv[2] ) );
+
+   assert( (long)num_vertices( b ) == n );
+   assert( (long)num_edges( b ) == g->get_num_arcs() );
+
+   traits::vertex_iterator v, v_end;
+   long x = 0;
+
+   for( boost::tie( v, v_end ) = vertices( b ); v != v_end; ++v, ++x ) {
+      assert( *v == x );
+
+      traits::in_edge_iterator i, i_end;
+      long k = offsets[x];
+
+      for( boost::tie( i, i_end ) = in_edges( x, b ); i != i_end; ++i, ++k ) {
+         assert( k < offsets[ x + 1 ] );
+         assert( source( *i, b ) == targets[k] && target( *i, b ) == x );
+      }
+
+      assert( k == offsets[ x + 1 ] );
+      assert( (long)in_degree( x, b ) == offsets[ x + 1 ] - offsets[x] );
+
+      traits::out_edge_iterator o, o_end;
+      traits::adjacency_iterator a, a_end;
+
+      boost::tie( a, a_end ) = adjacent_vertices( x, b );
+
+      for( boost::tie( o, o_end ) = out_edges( x, b ); o != o_end; ++o, ++a ) {
+         assert( a != a_end );
+         assert( source( *o, b ) == x && target( *o, b ) == *a );
+      }
+
+      assert( a == a_end );
+      assert( degree( x, b ) == out_degree( x, b ) + in_degree( x, b ) );
+   }
+
+   assert( x == n );
+
+   vector<double> push( n ), pull( n );
+
+   boost::graph::page_rank( *g, boost::make_iterator_property_map( 
+                               push.begin(), boost::get( boost::vertex_index, *g ) ) );
+   boost::graph::page_rank( b, boost::make_iterator_property_map( 
+                               pull.begin(), get( boost::vertex_index, b ) ) );
+
+   for( long y = 0; y < n; y++ ) 
+      assert( fabs( push[y] - pull[y] ) <= 1e-9 * max( 1.0, fabs( push[y] ) ) );
+
+   cerr << "Bidirectional test passed.\n";
+
+   return 0;
+}
@@ -0,0 +1,74 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <cassert>
+
+#include "../../../webgraph/generators.hpp"
+#include "../adjacency.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+/*
+ * Checks that every model yields sorted, duplicate-free lists of valid nodes, that the
+ * graph does not depend on the number of threads, and that it does depend on the seed.
+ *
+ * Usage: test_generators
+ */
+int main( int, char** ) {
+   const char* names[] = { "uniform", "rmat", "pa", "copying" };
+
+   for( int m = 0; m < 4; m++ ) {
+      generators::generator_parameters p;
+      bool ok = generators::parse_model( names[m], p.type );
+      assert( ok );
+
+      // Not a multiple of BLOCK_SIZE, nor a power of two.
+      p.n = 3 * generators::BLOCK_SIZE + 1234;
+      p.avg_degree = 8;
+      p.seed = 17;
+
+      adjacency one = to_adjacency( generators::generated_graph( p, 1 ) );
+      adjacency four = to_adjacency( generators::generated_graph( p, 4 ) );
+
+      assert( one == four );
+
+      long arcs = 0;
+      for( unsigned x = 0; x < one.size(); x++ ) {
+         for( unsigned k = 0; k < one[x].size(); k++ ) {
+            assert( one[x][k] < (unsigned)p.n );
+            assert( k == 0 || one[x][k - 1] < one[x][k] );
+         }
+         arcs += one[x].size();
+      }
+
+      assert( arcs > p.n * p.avg_degree / 2 && arcs < p.n * p.avg_degree * 2 );
+
+      p.seed = 18;
+      assert( to_adjacency( generators::generated_graph( p, 2 ) ) != one );
+
+      cerr << names[m] << ": " << arcs << " arcs\n";
+   }
+
+   cerr << "OK\n";
+
+   return 0;
+}
@@ -0,0 +1,143 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cassert>
+
+#include "../../../webgraph/webgraph.hpp"
+#include "../../../webgraph/arc_list_builder.hpp"
+#include "../../../webgraph/csr_view.hpp"
+#include "../adjacency.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+/** Stores the first n lists of a, followed by extra empty lists, as basename. */
+void store_prefix( const adjacency& a, long n, long extra, const string& basename ) {
+   vector<long> offsets( 1, 0 );
+   vector<int> targets;
+
+   for( long x = 0; x < n + extra; x++ ) {
+      if( x < n ) 
+         targets.insert( targets.end(), a[x].begin(), a[x].end() );
+
+      offsets.push_back( targets.size() );
+   }
+
+   bv_graph::graph::store( csr_view<long, int>( n + extra, &offsets[0], 
+                                                targets.empty() ? NULL : &targets[0] ), 
+                           basename, -1, -1, -1, -1, 0 );
+}
+
+string contents( const string& filename ) {
+   ifstream in( filename.c_str(), ios::binary );
+   assert( in.good() );
+
+   return string( istreambuf_iterator<char>( in ), istreambuf_iterator<char>() );
+}
+
+/*
+ * Compresses the first half of a graph, then appends the rest from an arc list followed
+ * by two isolated nodes, and checks that the files are those of compressing it all at
+ * once. The isolated nodes are only kept if the number of nodes is given to the builder.
+ * Also checks that an arc out of an old node is rejected before the files are touched.
+ *
+ * Usage: test_append BASENAME TEMP_BASENAME
+ */
+int main( int argc, char** argv ) {
+   assert( argc == 3 );
+
+   bv_graph::graph::graph_ptr g = bv_graph::graph::load( argv[1] );
+   const long n = g->get_num_nodes(), half = n / 2, extra = 2;
+   const string whole = string( argv[2] ) + "-whole", part = argv[2];
+
+   adjacency a = to_adjacency( *g );
+
+   store_prefix( a, n, extra, whole );
+
+   for( int nodes_given = 0; nodes_given < 2; nodes_given++ ) {
+      store_prefix( a, half, 0, part );
+
+      arc_list_builder b;
+
+      for( long x = half; x < n; x++ ) 
+         for( unsigned j = 0; j < a[x].size(); j++ ) 
+            b.add_arc( x, a[x][j] );
+
+      if( nodes_given )
+         b.set_num_nodes( n + extra );
+
+      b.finish();
+
+      bv_graph::graph::append( b, part, half );
+
+      bv_graph::graph::graph_ptr h = bv_graph::graph::load( part );
+
+      if( !nodes_given ) {
+         // The builder cannot know about nodes after the last it saw.
+         assert( h->get_num_nodes() == b.get_num_nodes() );
+         assert( h->get_num_nodes() < n + extra );
+         continue;
+      }
+
+      assert( h->get_num_nodes() == n + extra );
+      assert( contents( part + ".graph" ) == contents( whole + ".graph" ) );
+      assert( contents( part + ".offsets" ) == contents( whole + ".offsets" ) );
+
+      adjacency c = to_adjacency( *h );
+
+      c.resize( n );
+      assert( c == a );
+   }
+
+   // An arc out of an old node, after one out of a new node.
+   store_prefix( a, half, 0, part );
+
+   const string graph_before = contents( part + ".graph" );
+   const string offsets_before = contents( part + ".offsets" );
+   arc_list_builder b;
+
+   b.add_arc( half, 0 );
+   b.add_arc( 0, half );
+   b.finish();
+
+   assert( b.get_min_source() == 0 );
+
+   bool rejected = false;
+
+   try {
+      bv_graph::graph::append( b, part, half );
+   } catch( invalid_argument& ) {
+      rejected = true;
+   }
+
+   assert( rejected );
+   assert( contents( part + ".graph" ) == graph_before );
+   assert( contents( part + ".offsets" ) == offsets_before );
+   assert( bv_graph::graph::load( part )->get_num_nodes() == half );
+
+   cerr << "Append test passed.\n";
+
+   return 0;
+}
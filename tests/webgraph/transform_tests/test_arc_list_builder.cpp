@@ -0,0 +1,106 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <set>
+#include <vector>
+#include <cstdlib>
+#include <cassert>
+
+#include "../../../webgraph/arc_list_builder.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+/** Checks that a finished builder scans, twice, to the arcs of expected on n nodes. */
+void check( const arc_list_builder& b, const set<pair<unsigned int, unsigned int> >& expected,
+            long n ) {
+   // scan twice, to check that the builder can be rescanned.
+   for( int pass = 0; pass < 2; pass++ ) {
+      set<pair<unsigned int, unsigned int> >::const_iterator e = expected.begin();
+      arc_list_builder::node_iterator i, end;
+      long x = 0;
+
+      for( boost::tie( i, end ) = b.get_node_iterator(); i != end; ++i, ++x ) {
+         assert( *i == x );
+
+         const vector<unsigned int>& s = successors( i );
+         assert( outdegree( i ) == (int)s.size() );
+
+         for( unsigned j = 0; j < s.size(); j++, ++e ) {
+            assert( e != expected.end() );
+            assert( e->first == x && e->second == s[j] );
+         }
+      }
+
+      assert( x == n );
+      assert( e == expected.end() );
+   }
+}
+
+/*
+ * Feeds random arcs (with plenty of duplicates) to an arc_list_builder with a tiny batch,
+ * so that many runs get spilled and merged, and checks the result against a std::set; then
+ * does the same with a fan-in of 3, so that runs are first merged into longer runs.
+ *
+ * Usage: test_arc_list_builder NODES ARCS BATCH_SIZE
+ */
+int main( int argc, char** argv ) {
+   assert( argc == 4 );
+
+   long n = atol( argv[1] ), m = atol( argv[2] ), batch = atol( argv[3] );
+
+   srand( time(NULL) );
+
+   set<pair<unsigned int, unsigned int> > expected;
+   vector<pair<unsigned int, unsigned int> > arcs;
+   
+   for( long i = 0; i < m; i++ ) {
+      unsigned int src = rand() % n, dst = rand() % n;
+      
+      expected.insert( make_pair( src, dst ) );
+      arcs.push_back( make_pair( src, dst ) );
+   }
+
+   const int fan_in[] = { arc_list_builder::DEFAULT_MAX_FAN_IN, 3 };
+
+   for( int f = 0; f < 2; f++ ) {
+      arc_list_builder b( batch );
+
+      b.set_max_fan_in( fan_in[f] );
+
+      for( long i = 0; i < m; i++ ) 
+         b.add_arc( arcs[i].first, arcs[i].second );
+
+      b.set_num_nodes( n );
+      b.finish();
+
+      cerr << "fan-in : " << fan_in[f] << endl
+           << "runs : " << b.get_num_runs() << endl
+           << "distinct arcs : " << expected.size() << endl;
+
+      assert( b.get_num_runs() <= fan_in[f] );
+
+      check( b, expected, n );
+   }
+
+   cerr << "OK\n";
+
+   return 0;
+}
@@ -0,0 +1,64 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <cassert>
+
+#include "../../../webgraph/webgraph.hpp"
+#include "../../../webgraph/csr_file.hpp"
+#include "../adjacency.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+/*
+ * Checks that a BV graph written as a CSR file, with targets of either size, maps back
+ * to the same graph, and that the views support random access.
+ *
+ * Usage: test_csr BASENAME TEMP_BASENAME
+ */
+int main( int argc, char** argv ) {
+   assert( argc == 3 );
+
+   bv_graph::graph::graph_ptr g = bv_graph::graph::load_sequential( argv[1] );
+   adjacency original = to_adjacency( *g );
+
+   csr::store( *g, argv[2], 4 );
+   boost::shared_ptr<csr::csr_file> f = csr::csr_file::load( argv[2] );
+
+   assert( f->get_num_nodes() == g->get_num_nodes() );
+   assert( f->get_num_arcs() == g->get_num_arcs() );
+   assert( to_adjacency( f->view32() ) == original );
+
+   for( long x = original.size() - 1; x >= 0; x -= 7 ) {
+      csr::csr_file::view32_type::succ_itor_pair s = f->view32().get_successors( x );
+      assert( vector<unsigned int>( s.first, s.second ) == original[x] );
+   }
+
+   csr::store( *g, argv[2], 8 );
+   f = csr::csr_file::load( argv[2] );
+
+   assert( f->get_target_bytes() == 8 );
+   assert( to_adjacency( f->view64() ) == original );
+
+   cerr << "OK\n";
+
+   return 0;
+}
@@ -0,0 +1,77 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cassert>
+
+#include "../../../webgraph/webgraph.hpp"
+#include "../../../webgraph/transform.hpp"
+#include "../../../webgraph/ordering.hpp"
+#include "../adjacency.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+/*
+ * Checks that every ordering yields a permutation, and that permuting a BV graph by
+ * an ordering and then by its inverse (with a tiny batch, so that runs are spilled)
+ * gives back the original graph.
+ *
+ * Usage: test_permute BASENAME
+ */
+int main( int argc, char** argv ) {
+   assert( argc == 2 );
+
+   bv_graph::graph::graph_ptr g = bv_graph::graph::load( argv[1] );
+   adjacency original = to_adjacency( *g );
+
+   vector<vector<int> > orders( 4 );
+
+   ordering::bfs_order( *g, orders[0] );
+   ordering::degree_order( *g, orders[1] );
+   ordering::llp_order( *g, orders[2], ordering::default_gammas() );
+
+   orders[3].resize( g->get_num_nodes() );
+   for( unsigned i = 0; i < orders[3].size(); i++ ) 
+      orders[3][i] = i;
+   random_shuffle( orders[3].begin(), orders[3].end() );
+
+   for( unsigned k = 0; k < orders.size(); k++ ) {
+      assert( ordering::is_permutation( orders[k] ) );
+
+      vector<int> perm;
+      ordering::to_permutation( orders[k], perm );
+
+      arc_list_builder b( 1000 );
+      transform::permute( *g, perm, b );
+
+      // the order is the inverse of the permutation.
+      arc_list_builder back( 1000 );
+      transform::permute( b, orders[k], back );
+
+      assert( to_adjacency( back ) == original );
+   }
+
+   cerr << "OK\n";
+
+   return 0;
+}
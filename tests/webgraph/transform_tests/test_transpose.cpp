@@ -0,0 +1,74 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cassert>
+
+#include "../../../webgraph/webgraph.hpp"
+#include "../../../webgraph/transform.hpp"
+#include "../adjacency.hpp"
+
+using namespace std;
+using namespace webgraph;
+
+/*
+ * Transposes a BV graph in memory (with one and with several threads) and externally
+ * (with a tiny batch, so that runs are spilled), and checks that the three agree and
+ * that reversing the arcs back gives the original graph.
+ *
+ * Usage: test_transpose BASENAME
+ */
+int main( int argc, char** argv ) {
+   assert( argc == 2 );
+
+   bv_graph::graph::graph_ptr g = bv_graph::graph::load( argv[1] );
+   long n = g->get_num_nodes();
+
+   adjacency original = to_adjacency( *g );
+
+   vector<long> offsets;
+   vector<int> targets;
+
+   transform::transpose_in_memory( *g, offsets, targets, 1 );
+   adjacency t1 = to_adjacency( csr_view<long, int>( n, &offsets[0], &targets[0] ) );
+
+   transform::transpose_in_memory( *g, offsets, targets, 4 );
+   adjacency t4 = to_adjacency( csr_view<long, int>( n, &offsets[0], &targets[0] ) );
+
+   arc_list_builder b( 1000 );
+   transform::transpose( *g, b );
+   adjacency te = to_adjacency( b );
+
+   cerr << "runs : " << b.get_num_runs() << endl;
+
+   assert( t1 == t4 );
+   assert( t1 == te );
+
+   // the transpose of the transpose.
+   arc_list_builder bb( 1000 );
+   transform::transpose( csr_view<long, int>( n, &offsets[0], &targets[0] ), bb );
+
+   assert( to_adjacency( bb ) == original );
+
+   cerr << "OK\n";
+
+   return 0;
+}
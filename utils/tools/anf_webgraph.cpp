@@ -0,0 +1,91 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Estimates the neighbourhood function and the distance distribution of a BV graph with
+ * HyperANF, and prints them with the average distance and the effective diameter.
+ *
+ *      ./anf_webgraph --source=graph [--log2m=7] [--threads=4]
+ *
+ * Memory use is 2^(log2m + 1) bytes per node. With a single thread the graph is scanned
+ * from disk, so it needs not fit in memory.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/hyperanf.hpp"
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   namespace anf = webgraph::hyperanf;
+   using namespace std;
+
+   string src;
+   anf::anf_parameters p;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "Basename of the graph")
+      ("log2m,m", po::value<int>(&p.log2m)->default_value( p.log2m ), 
+       "Base-2 logarithm of the number of registers per counter (4 to 16)")
+      ("max-distance,u", po::value<int>(&p.max_distance), "Stop at this distance")
+      ("seed", po::value<boost::uint64_t>(&p.seed)->default_value( p.seed ), 
+       "Seed for the hash function")
+      ("threads,t", po::value<int>(&p.threads)->default_value( p.threads ), 
+       "Number of threads")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   if( vm.count( "help" ) || !vm.count( "source" ) || p.log2m < 4 || p.log2m > 16 ) {
+      cerr << desc;
+
+      return 1;
+   }
+
+   ostream* log = &cerr;
+
+   // Splitting the scans among threads requires offsets.
+   bvg::graph::graph_ptr g = p.threads > 1 ? bvg::graph::load( src, log ) 
+      : bvg::graph::load_offline( src, log );
+
+   vector<double> nf, dd;
+
+   anf::neighbourhood_function( *g, nf, p, log );
+   anf::distance_distribution( nf, dd );
+
+   cout << "distance\tneighbourhood\tpairs\n";
+
+   for( size_t t = 0; t < nf.size(); t++ ) 
+      cout << t << "\t" << nf[t] << "\t" << dd[t] << "\n";
+
+   cout << "average distance\t" << anf::average_distance( nf ) << "\n"
+        << "effective diameter\t" << anf::effective_diameter( nf ) << "\n";
+
+   return 0;
+}
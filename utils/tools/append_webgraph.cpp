@@ -0,0 +1,151 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Appends new nodes to a BV graph in place, without recompressing it.
+ *
+ *      ./append_webgraph --source=new-nodes --dest=graph
+ *
+ * Node ids are absolute: if the graph has n nodes, the new nodes are n, n + 1, ... and
+ * their successors may be any node, old or new. With --graph-class=ArcList (the default)
+ * the source is a file of "source target" lines (- for standard input) whose sources
+ * are all at least n. An arc list does not tell about new nodes past the largest id it
+ * mentions, so --nodes gives the number of nodes of the extended graph when the last new
+ * nodes are isolated. With --graph-class=AsciiGraph the source is an ASCII graph
+ * covering all nodes, whose first n successor lists must be empty. Either way the input
+ * is checked before the graph is modified.
+ *
+ * The graph is loaded with all its offsets to rebuild the reference window, so it needs
+ * as much memory as graph::load(): the size of the .graph file plus 8 bytes per node.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <stdexcept>
+#include <boost/program_options.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/arc_list_builder.hpp"
+#include "../../asciigraph/offline_graph.hpp"
+#include "../../properties/properties.hpp"
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   using namespace std;
+
+   string src, dest, temp_dir, graph_class = "ArcList";
+   long batch_size = webgraph::arc_list_builder::DEFAULT_BATCH_SIZE, nodes = -1;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "The new nodes")
+      ("dest,d", po::value<string>(&dest), "Basename of the graph to extend")
+      ("graph-class,g", po::value<string>(&graph_class)->default_value( graph_class ),
+       "Class of the source (ArcList or AsciiGraph)")
+      ("nodes,n", po::value<long>(&nodes), 
+       "Number of nodes after appending (ArcList only; default: one more than the "
+       "largest node in the list)")
+      ("batch-size,b", po::value<long>(&batch_size)->default_value( batch_size ), 
+       "Number of arcs sorted in memory at once (ArcList only)")
+      ("temp-dir,T", po::value<string>(&temp_dir), 
+       "Directory for sorted runs (ArcList only; default $TMPDIR or /tmp)")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   if( vm.count( "help" ) || !vm.count( "source" ) || !vm.count( "dest" ) ) {
+      cerr << desc;
+
+      return 1;
+   }
+
+   ostream* log = &cerr;
+
+   webgraph::properties props;
+   ifstream prop_file( ( dest + ".properties" ).c_str() );
+   assert( prop_file.good() );
+   props.load( prop_file );
+
+   long n = atol( props.get_property( "nodes" ).c_str() );
+
+   if( graph_class == "AsciiGraph" ) {
+      webgraph::ascii_graph::offline_graph g = webgraph::ascii_graph::offline_graph::load( src );
+
+      assert( g.get_num_nodes() >= n );
+
+      try {
+         bvg::graph::append( g, dest, n, log );
+      } catch( invalid_argument& e ) {
+         cerr << e.what() << "; the graph is unchanged.\n";
+
+         return 1;
+      }
+   } else if( graph_class == "ArcList" ) {
+      webgraph::arc_list_builder b( batch_size, temp_dir, log );
+
+      if( src == "-" ) {
+         b.add_arcs( cin );
+      } else {
+         ifstream in( src.c_str() );
+         assert( in.good() );
+         b.add_arcs( in );
+      }
+      b.finish();
+
+      if( nodes >= 0 ) {
+         if( nodes < b.get_num_nodes() ) {
+            cerr << "The arc list mentions node " << b.get_num_nodes() - 1 
+                 << ", but --nodes is " << nodes << ".\n";
+
+            return 1;
+         }
+
+         b.set_num_nodes( nodes );
+      }
+
+      if( b.get_min_source() >= 0 && b.get_min_source() < n ) {
+         cerr << "The arc list has arcs out of node " << b.get_min_source() 
+              << ", but only nodes from " << n << " on are new.\n";
+
+         return 1;
+      }
+
+      if( b.get_num_nodes() < n ) {
+         cerr << "The graph already has " << n << " nodes, but the extended graph would "
+              << "have " << b.get_num_nodes() << ( nodes < 0 ? " (see --nodes).\n" : ".\n" );
+
+         return 1;
+      }
+
+      bvg::graph::append( b, dest, n, log );
+   } else {
+      cerr << "The only allowable parameters for graph-class are AsciiGraph and ArcList.\n";
+
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,141 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Runs breadth-first visits of a BV graph, and prints the number of nodes reached from
+ * each root and the distribution of distances over all visits.
+ *
+ *      ./bfs_webgraph --source=graph --root=0 --root=17 [--threads=4]
+ *      ./bfs_webgraph --source=graph --samples=100 --seed=1 --decompress
+ *
+ * With --dest, the distance and parent of each node in the visit from the first root are
+ * written as text, one node per line. --decompress keeps the lists in memory, which makes
+ * top-down steps much faster at the cost of 4 bytes per arc.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int.hpp>
+#include <boost/random/variate_generator.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/bfs.hpp"
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   using namespace std;
+
+   string src, dest;
+   vector<int> roots;
+   int samples = 0;
+   unsigned int seed = 0;
+   webgraph::bfs::bfs_parameters p;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "Basename of the graph")
+      ("root,r", po::value< vector<int> >(&roots), "A node to start a visit from")
+      ("samples,n", po::value<int>(&samples), "Number of random roots to visit from")
+      ("seed", po::value<unsigned int>(&seed)->default_value( seed ), 
+       "Seed for the random roots")
+      ("dest,d", po::value<string>(&dest), 
+       "File to write the distances and parents from the first root to")
+      ("threads,t", po::value<int>(&p.threads)->default_value( p.threads ), 
+       "Number of threads")
+      ("top-down-only", "Do not switch to bottom-up steps (saves the transpose)")
+      ("decompress", "Decompress the graph in memory")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   if( vm.count( "help" ) || !vm.count( "source" ) || ( roots.empty() && samples <= 0 ) ) {
+      cerr << desc;
+
+      return 1;
+   }
+
+   ostream* log = &cerr;
+
+   p.direction_switching = !vm.count( "top-down-only" );
+
+   bvg::graph::graph_ptr g = vm.count( "decompress" ) 
+      ? bvg::graph::load_decompressed( src, p.threads, log ) 
+      : bvg::graph::load( src, log );
+
+   const long n = g->get_num_nodes();
+
+   boost::mt19937 rng( seed );
+   boost::variate_generator<boost::mt19937&, boost::uniform_int<long> > 
+      random_node( rng, boost::uniform_int<long>( 0, n - 1 ) );
+
+   for( int k = 0; k < samples; k++ ) 
+      roots.push_back( random_node() );
+
+   webgraph::bfs::engine e( *g, p, log );
+
+   vector<int> distance, parent;
+   vector<long> distribution;
+
+   for( size_t k = 0; k < roots.size(); k++ ) {
+      if( roots[k] < 0 || roots[k] >= n ) {
+         cerr << "Node " << roots[k] << " is not in the graph.\n";
+         return 1;
+      }
+
+      long reached = e.visit( roots[k], distance, parent );
+      int eccentricity = 0;
+
+      for( long x = 0; x < n; x++ ) {
+         if( distance[x] < 0 )
+            continue;
+
+         if( distance[x] >= (int)distribution.size() )
+            distribution.resize( distance[x] + 1 );
+
+         distribution[ distance[x] ]++;
+         eccentricity = max( eccentricity, distance[x] );
+      }
+
+      cout << "root " << roots[k] << ": " << reached << " nodes reached, eccentricity " 
+           << eccentricity << "\n";
+
+      if( k == 0 && !dest.empty() ) {
+         ofstream out( dest.c_str() );
+
+         for( long x = 0; x < n; x++ ) 
+            out << distance[x] << " " << parent[x] << "\n";
+      }
+   }
+
+   cout << "distance\tpairs\n";
+
+   for( size_t d = 0; d < distribution.size(); d++ ) 
+      cout << d << "\t" << distribution[d] << "\n";
+
+   return 0;
+}
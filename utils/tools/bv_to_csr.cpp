@@ -0,0 +1,75 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Writes a BV graph in the binary CSR format of csr_file.hpp, which other tools can map
+ * into memory and use without any parsing.
+ *
+ *      ./bv_to_csr --source=graph --dest=graph [--target-bytes=8]
+ *
+ * writes graph.csr. The graph is scanned from disk, so it needs not fit in memory.
+ */
+
+#include <iostream>
+#include <string>
+#include <boost/program_options.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/csr_file.hpp"
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   using namespace std;
+
+   string src, dest;
+   int target_bytes = 4;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "Basename of the BV graph")
+      ("dest,d", po::value<string>(&dest), "Basename of the CSR graph")
+      ("target-bytes,b", po::value<int>(&target_bytes)->default_value( target_bytes ), 
+       "Size of a target in the CSR file (4 or 8)")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   if( vm.count( "help" ) || !vm.count( "source" ) || !vm.count( "dest" ) ) {
+      cerr << desc;
+
+      return 1;
+   }
+
+   if( target_bytes != 4 && target_bytes != 8 ) {
+      cerr << "Targets can only be 4 or 8 bytes long.\n";
+
+      return 1;
+   }
+
+   bvg::graph::graph_ptr g = bvg::graph::load_offline( src );
+
+   webgraph::csr::store( *g, dest, target_bytes, &cerr );
+
+   return 0;
+}
@@ -0,0 +1,159 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Computes the weakly or strongly connected components of a BV graph, and prints how many
+ * components there are of each size.
+ *
+ *      ./components_webgraph --source=graph [--dest=graph.wcc] [--threads=4]
+ *      ./components_webgraph --source=graph --strong [--transpose=graph-t] [--threads=4]
+ *
+ * With --dest, the component of each node is written as text, one node per line. Weak
+ * components with a single thread are computed scanning the graph from disk, so it needs
+ * not fit in memory.
+ *
+ * Strong components are computed by Tarjan's algorithm, or by coloring with --threads
+ * threads if the transpose is given; in that case the bow-tie structure around the
+ * largest component (the nodes that reach it, and those it reaches) is printed too.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <iterator>
+#include <algorithm>
+#include <boost/program_options.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/components.hpp"
+#include "../../webgraph/bfs.hpp"
+
+/** Prints the sizes of the largest strong component, of the sets of nodes reaching it and
+ * reached from it (excluding it), and of the rest. */
+void print_bow_tie( const webgraph::bv_graph::graph& g, const webgraph::bv_graph::graph& t,
+                    const std::vector<int>& component, const std::vector<long>& sizes, 
+                    int threads ) {
+   using namespace std;
+
+   const long n = g.get_num_nodes();
+   const int giant = max_element( sizes.begin(), sizes.end() ) - sizes.begin();
+   const int root = find( component.begin(), component.end(), giant ) - component.begin();
+
+   webgraph::bfs::bfs_parameters p;
+   p.threads = threads;
+   p.direction_switching = false;
+
+   vector<int> out, in, parent;
+
+   webgraph::bfs::engine( g, p ).visit( root, out, parent );
+   webgraph::bfs::engine( t, p ).visit( root, in, parent );
+
+   long in_size = 0, out_size = 0;
+
+   for( long x = 0; x < n; x++ ) 
+      if( component[x] != giant ) {
+         in_size += in[x] != -1;
+         out_size += out[x] != -1;
+      }
+
+   cout << "bow-tie\tnodes\n" 
+        << "scc\t" << sizes[ giant ] << "\n"
+        << "in\t" << in_size << "\n"
+        << "out\t" << out_size << "\n"
+        << "other\t" << n - sizes[ giant ] - in_size - out_size << "\n";
+}
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   using namespace std;
+
+   string src, dest, transpose;
+   int threads = 1;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "Basename of the graph")
+      ("dest,d", po::value<string>(&dest), "File to write the component of each node to")
+      ("threads,t", po::value<int>(&threads)->default_value( threads ), 
+       "Number of threads")
+      ("strong", "Compute strongly connected components")
+      ("transpose,T", po::value<string>(&transpose), 
+       "Basename of the transpose, for strong components")
+      ("decompress", "Decompress the graphs in memory, for strong components")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   if( vm.count( "help" ) || !vm.count( "source" ) ) {
+      cerr << desc;
+
+      return 1;
+   }
+
+   ostream* log = &cerr;
+
+   const bool strong = vm.count( "strong" );
+   const bool decompress = strong && vm.count( "decompress" );
+
+   // Splitting the scan among threads, or strong components, require offsets.
+   bvg::graph::graph_ptr g = decompress ? bvg::graph::load_decompressed( src, threads, log )
+      : threads > 1 || strong ? bvg::graph::load( src, log ) 
+      : bvg::graph::load_offline( src, log );
+
+   vector<int> component;
+   vector<long> sizes;
+   map<long, long> count;
+
+   if( !strong ) 
+      webgraph::components::weakly_connected( *g, component, sizes, threads, log );
+   else if( transpose.empty() )
+      webgraph::components::strongly_connected( *g, component, sizes, log );
+   else {
+      bvg::graph::graph_ptr t = decompress 
+         ? bvg::graph::load_decompressed( transpose, threads, log ) 
+         : bvg::graph::load( transpose, log );
+
+      webgraph::components::strongly_connected( *g, *t, component, sizes, threads, log );
+
+      if( !sizes.empty() )
+         print_bow_tie( *g, *t, component, sizes, threads );
+   }
+
+   webgraph::components::size_distribution( sizes, count );
+
+   cout << "size\tcomponents\n";
+
+   for( map<long, long>::const_iterator i = count.begin(); i != count.end(); ++i ) 
+      cout << i->first << "\t" << i->second << "\n";
+
+   if( !dest.empty() ) {
+      ofstream out( dest.c_str() );
+
+      copy( component.begin(), component.end(), ostream_iterator<int>( out, "\n" ) );
+   }
+
+   return 0;
+}
@@ -0,0 +1,114 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Computes the core number of each node of a BV graph, and prints how many nodes have each
+ * core number.
+ *
+ *      ./cores_webgraph --source=graph --transpose=graph-t [--type=all] [--threads=4]
+ *
+ * --type chooses the degree: in, out or all (the degree in the symmetrized graph, where
+ * opposite arcs make one edge); the transpose is not needed for in. With --dest, the core number of each node
+ * is written as text, one node per line. --decompress keeps the lists in memory, which
+ * makes peeling much faster at the cost of 4 bytes per arc per graph.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <boost/program_options.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/cores.hpp"
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   namespace cores = webgraph::cores;
+   using namespace std;
+
+   string src, transpose, dest, type_name = "all";
+   int threads = 1;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "Basename of the graph")
+      ("transpose,T", po::value<string>(&transpose), "Basename of the transpose")
+      ("type", po::value<string>(&type_name)->default_value( type_name ), 
+       "Degree: in, out or all")
+      ("dest,d", po::value<string>(&dest), "File to write the core numbers to")
+      ("threads,t", po::value<int>(&threads)->default_value( threads ), 
+       "Number of threads (peeling level by level)")
+      ("decompress", "Decompress the graphs in memory")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   cores::degree_type type = type_name == "in" ? cores::IN 
+      : type_name == "out" ? cores::OUT : cores::ALL;
+
+   if( vm.count( "help" ) || !vm.count( "source" ) || 
+       ( type_name != "in" && type_name != "out" && type_name != "all" ) ||
+       ( type != cores::IN && transpose.empty() ) ) {
+      cerr << desc;
+
+      return 1;
+   }
+
+   ostream* log = &cerr;
+   const bool decompress = vm.count( "decompress" );
+
+   bvg::graph::graph_ptr g = decompress ? bvg::graph::load_decompressed( src, threads, log )
+      : bvg::graph::load( src, log );
+   bvg::graph::graph_ptr t;
+
+   if( type != cores::IN )
+      t = decompress ? bvg::graph::load_decompressed( transpose, threads, log ) 
+         : bvg::graph::load( transpose, log );
+
+   vector<int> core;
+   int degeneracy = threads > 1 
+      ? cores::decompose_parallel( *g, t.get(), type, core, threads, log ) 
+      : cores::decompose( *g, t.get(), type, core, log );
+
+   vector<long> count( degeneracy + 1 );
+   for( size_t x = 0; x < core.size(); x++ ) 
+      count[ core[x] ]++;
+
+   cout << "core\tnodes\n";
+
+   for( int k = 0; k <= degeneracy; k++ ) 
+      if( count[k] != 0 )
+         cout << k << "\t" << count[k] << "\n";
+
+   if( !dest.empty() ) {
+      ofstream out( dest.c_str() );
+
+      copy( core.begin(), core.end(), ostream_iterator<int>( out, "\n" ) );
+   }
+
+   return 0;
+}
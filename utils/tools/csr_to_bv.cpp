@@ -0,0 +1,79 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Compresses a graph in the binary CSR format of csr_file.hpp as a BV graph.
+ *
+ *      ./csr_to_bv --source=graph --dest=graph [-w 7 -m 3 ...]
+ *
+ * reads graph.csr, which is mapped into memory rather than read.
+ */
+
+#include <iostream>
+#include <string>
+#include <boost/program_options.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/csr_file.hpp"
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   namespace csr = webgraph::csr;
+   using namespace std;
+
+   string src, dest;
+   int window_size = -1, 
+      max_ref_count = -1, 
+      min_interval_length = -1, 
+      zeta_k = -1;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "Basename of the CSR graph")
+      ("dest,d", po::value<string>(&dest), "Basename of the BV graph")
+      ("window-size,w", po::value<int>(&window_size), "Reference window size")
+      ("max-ref-count,m", po::value<int>(&max_ref_count), "Maximum number of backward references")
+      ("min-interval-length", po::value<int>(&min_interval_length), "Minimum interval length")
+      ("zeta-k,k", po::value<int>(&zeta_k), "The k parameter for zeta-k codes")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   if( vm.count( "help" ) || !vm.count( "source" ) || !vm.count( "dest" ) ) {
+      cerr << desc;
+
+      return 1;
+   }
+
+   boost::shared_ptr<csr::csr_file> f = csr::csr_file::load( src );
+
+   if( f->get_target_bytes() == 4 )
+      bvg::graph::store( f->view32(), dest, window_size, max_ref_count, min_interval_length, 
+                         zeta_k, 0, &cerr );
+   else
+      bvg::graph::store( f->view64(), dest, window_size, max_ref_count, min_interval_length, 
+                         zeta_k, 0, &cerr );
+
+   return 0;
+}
@@ -0,0 +1,102 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Prints the degree statistics of a BV graph, computed in one scan.
+ *
+ *      ./degrees_webgraph --source=graph [--threads=4] [--dest=graph.degrees]
+ *
+ * With --dest, the indegrees and outdegrees are written in the binary format of
+ * degrees::store(); with --distribution, the number of nodes of each indegree and
+ * outdegree is printed too.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/degrees.hpp"
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   using namespace std;
+
+   string src, dest;
+   int threads = 1;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "Basename of the graph")
+      ("dest,d", po::value<string>(&dest), "File to write the degrees to")
+      ("threads,t", po::value<int>(&threads)->default_value( threads ), 
+       "Number of threads")
+      ("distribution", "Print the degree distributions")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   if( vm.count( "help" ) || !vm.count( "source" ) ) {
+      cerr << desc;
+
+      return 1;
+   }
+
+   ostream* log = &cerr;
+
+   // Loading with all offsets lets threads start anywhere in the graph.
+   bvg::graph::graph_ptr g = threads > 1 ? bvg::graph::load( src, log ) 
+      : bvg::graph::load_sequential( src, log );
+
+   webgraph::degrees::statistics s;
+   webgraph::degrees::compute( *g, s, threads, log );
+
+   cout << "nodes\t" << s.nodes << "\n"
+        << "arcs\t" << s.arcs << "\n"
+        << "mean degree\t" << s.mean_degree << "\n"
+        << "max indegree\t" << s.max_indegree << "\n"
+        << "max outdegree\t" << s.max_outdegree << "\n"
+        << "dangling\t" << s.dangling << "\n"
+        << "self-loops\t" << s.self_loops << "\n"
+        << "bits/node\t" << s.bits_per_node << "\n"
+        << "bits/link\t" << s.bits_per_link << "\n";
+
+   if( vm.count( "distribution" ) ) {
+      cout << "\ndegree\tindegree\toutdegree\n";
+
+      for( int d = 0; d <= max( s.max_indegree, s.max_outdegree ); d++ ) {
+         const long in = d < (int)s.in_distribution.size() ? s.in_distribution[d] : 0;
+         const long out = d < (int)s.out_distribution.size() ? s.out_distribution[d] : 0;
+
+         if( in != 0 || out != 0 )
+            cout << d << "\t" << in << "\t" << out << "\n";
+      }
+   }
+
+   if( !dest.empty() ) 
+      webgraph::degrees::store( s, dest );
+
+   return 0;
+}
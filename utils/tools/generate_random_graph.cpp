@@ -17,16 +17,31 @@
  *
  */
 
+/*
+ * Generates a synthetic graph, either as a .graph-txt file or directly as a BV graph.
+ * The graph depends only on the model, its parameters and the seed, not on the number of
+ * threads, so runs are reproducible:
+ *
+ *      ./generate_random_graph --model=copying -v 100000000 -e 1500000000 -t 8 \
+ *            --format=bv --dest=copy-100M
+ *
+ * writes copy-100M.graph, .offsets and .properties, never holding the graph in memory.
+ * With --format=ascii (the default) --dest is the name of the file written.
+ */
+
 #include <iostream>
 #include <fstream>
-#include <sstream>
-#include <cstdlib>
-#include <cassert>
+#include <string>
 #include <vector>
 #include <boost/program_options.hpp>
 #include <boost/progress.hpp>
 
-unsigned generate_uniform_random_graph( unsigned num_vertices, unsigned num_edges, std::ostream& dest_file );
+#include "../../webgraph/generators.hpp"
+#include "../../webgraph/webgraph.hpp"
+
+namespace gen = webgraph::generators;
+
+long write_ascii( const gen::generated_graph& g, std::ostream& dest_file );
 
 int main( int argc, char* argv[] ) {
    namespace po = boost::program_options;
@@ -34,83 +49,145 @@ int main( int argc, char* argv[] ) {
 
    po::options_description desc( "Usage - " );
 
-   string dest_filename;
-   unsigned num_vertices, num_edges;
+   string dest_filename, model = "uniform", format = "ascii";
+   long num_vertices = 0, num_edges = 0;
+   int threads = 1;
+   gen::generator_parameters p;
 
    desc.add_options()
-      ("dest,d", po::value<string>(&dest_filename), "Destination file name")
-      ("vertices,v", po::value<unsigned>(&num_vertices), "Number of vertices")
-      ("edges,e", po::value<unsigned>(&num_edges), "Expected number of edges")
+      ("help,h", "Print help message")
+      ("dest,d", po::value<string>(&dest_filename), 
+       "Destination file name (basename with --format=bv)")
+      ("vertices,v", po::value<long>(&num_vertices), "Number of vertices")
+      ("edges,e", po::value<long>(&num_edges), "Expected number of edges")
+      ("model,m", po::value<string>(&model)->default_value( model ), 
+       "uniform, rmat, pa (preferential attachment) or copying")
+      ("seed,s", po::value<boost::uint64_t>(&p.seed)->default_value( p.seed ), 
+       "Random seed")
+      ("threads,t", po::value<int>(&threads)->default_value( threads ), 
+       "Number of generating threads")
+      ("format,f", po::value<string>(&format)->default_value( format ), 
+       "ascii or bv")
+      ("rmat-a", po::value<double>(&p.rmat_a)->default_value( p.rmat_a ), 
+       "R-MAT probability of the top left quadrant")
+      ("rmat-b", po::value<double>(&p.rmat_b)->default_value( p.rmat_b ), 
+       "R-MAT probability of the top right quadrant")
+      ("rmat-c", po::value<double>(&p.rmat_c)->default_value( p.rmat_c ), 
+       "R-MAT probability of the bottom left quadrant")
+      ("copy-probability", 
+       po::value<double>(&p.copy_probability)->default_value( p.copy_probability ), 
+       "pa: probability that a link copies another; copying: probability that a "
+       "successor of the prototype is copied")
+      ("locality", po::value<double>(&p.locality)->default_value( p.locality ), 
+       "copying: fraction of new successors close to their node")
+      ("locality-window", 
+       po::value<int>(&p.locality_window)->default_value( p.locality_window ), 
+       "copying: how far prototypes and close successors may be")
       ;
 
    po::variables_map vm;
    po::store( po::parse_command_line( argc, argv, desc), vm );
    po::notify( vm );
 
-   if( !vm.count( "dest" ) || !vm.count("vertices") || !vm.count("edges") ) {
+   if( vm.count( "help" ) || !vm.count( "dest" ) || !vm.count("vertices") || 
+       !vm.count("edges") ) {
       cerr << desc;
 
       return 1;
    }
 
-   ofstream dest_file( dest_filename.c_str() );
+   if( !gen::parse_model( model, p.type ) ) {
+      cerr << "The only allowable models are uniform, rmat, pa and copying.\n";
+
+      return 1;
+   }
+
+   if( format != "ascii" && format != "bv" ) {
+      cerr << "The only allowable formats are ascii and bv.\n";
+
+      return 1;
+   }
+
+   if( num_vertices < 2 ) {
+      cerr << "There must be at least two vertices.\n";
 
-   cerr << "Generating random graph...";
-   unsigned edges = generate_uniform_random_graph( num_vertices, num_edges, dest_file );
+      return 1;
+   }
+
+   p.n = num_vertices;
+   p.avg_degree = (double)num_edges / num_vertices;
+
+   gen::generated_graph g( p, threads );
+
+   cerr << "Generating random graph...\n";
+
+   if( format == "bv" ) {
+      namespace bvg = webgraph::bv_graph;
+
+      bvg::graph::store( g, dest_filename, bvg::graph::DEFAULT_WINDOW_SIZE, 
+                         bvg::graph::DEFAULT_MAX_REF_COUNT, 
+                         bvg::graph::DEFAULT_MIN_INTERVAL_LENGTH, bvg::graph::DEFAULT_ZETA_K, 
+                         0, &cerr );
+   } else {
+      ofstream dest_file( dest_filename.c_str() );
+      long edges = write_ascii( g, dest_file );
 
-   cerr << "\nEdges = " << edges << endl;
+      cerr << "\nEdges = " << edges << endl;
+   }
    
    return 0;
 }
 
-unsigned generate_uniform_random_graph( unsigned num_vertices, unsigned num_edges, std::ostream& dest_file ) {
-   unsigned expected_edges_per_vertex = num_edges / num_vertices;
-   unsigned total_edges = 0;
-
+/** Writes g in the .graph-txt format, formatting numbers by hand as ostream formatting
+ * would be the bottleneck. Returns the number of arcs written.
+ */
+long write_ascii( const gen::generated_graph& g, std::ostream& dest_file ) {
    using namespace std;
 
-   srandom(time(NULL));
+   const long n = g.get_num_nodes();
+   long total_edges = 0;
 
-   boost::progress_display progress( num_vertices );
+   boost::progress_display progress( n, cerr );
 
-   dest_file << num_vertices << "\n";
+   dest_file << n << "\n";
 
-   for( unsigned i = 0; i < num_vertices; i++ ) {
-      unsigned edges_for_this_vertex = random() % (2*expected_edges_per_vertex);
+   vector<char> buffer;
+   buffer.reserve( 1 << 20 );
+   char digits[ 16 ];
 
-      vector<unsigned> this_succ_list;
-      
-      unsigned edges_generated = 0;
-      while( edges_generated < edges_for_this_vertex ) {
-         unsigned next_edge = random() % (num_vertices-1);
-         // the point is to not allow i as a choice.
-         if( next_edge >= i )
-            ++next_edge;
+   gen::generated_graph::node_iterator i, end;
+   for( boost::tie( i, end ) = g.get_node_iterator(); i != end; ++i ) {
+      pair<const int*, const int*> s = i.get_successors();
 
-         assert( 0 <= next_edge );
-         assert( next_edge < num_vertices );
+      total_edges += s.second - s.first;
 
-         if( find( this_succ_list.begin(), this_succ_list.end(), next_edge ) == this_succ_list.end() ) {
-            this_succ_list.push_back( next_edge );
-            ++edges_generated;
-         }
-      }
+      for( const int* t = s.first; t != s.second; ++t ) {
+         if( t != s.first ) 
+            buffer.push_back( ' ' );
 
-      total_edges += edges_generated;
+         int len = 0;
+         unsigned int v = *t;
+         do {
+            digits[ len++ ] = '0' + v % 10;
+            v /= 10;
+         } while( v != 0 );
 
-      sort( this_succ_list.begin(), this_succ_list.end() );
+         while( len > 0 ) 
+            buffer.push_back( digits[ --len ] );
+      }
+
+      buffer.push_back( '\n' );
 
-      // now dump the successor list.
-      if( this_succ_list.size() > 0 ) {
-         dest_file << this_succ_list[0];
-         for( unsigned j = 1; j < this_succ_list.size(); j++ ) {
-            dest_file << " " << this_succ_list[j];
-         }
+      if( buffer.size() >= ( 1 << 20 ) - 4096 ) {
+         dest_file.write( &buffer[0], buffer.size() );
+         buffer.clear();
       }
 
-      dest_file << "\n";
       ++progress;
    }
 
+   if( !buffer.empty() ) 
+      dest_file.write( &buffer[0], buffer.size() );
+
    return total_edges;
 }
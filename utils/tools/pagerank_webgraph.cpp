@@ -0,0 +1,119 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Computes the PageRank of the nodes of a BV graph and writes it as text, one rank per
+ * line, in node order.
+ *
+ *      ./pagerank_webgraph --source=graph --dest=graph.ranks [--threads=4] [--transpose=graph-t]
+ *
+ * With a single thread and without --pull or --transpose, the graph is streamed from disk
+ * once per iteration. Otherwise the ranks are pulled from the transpose, and the
+ * iterations are split among --threads threads: the transpose given by --transpose is
+ * loaded with its offsets, or else built in memory, which takes 4 bytes per arc.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <boost/program_options.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/pagerank.hpp"
+
+template<class rank_type>
+void compute_and_write( const webgraph::bv_graph::graph& g, 
+                        const webgraph::pagerank::pagerank_parameters& p, 
+                        const std::string& dest, std::ostream* log ) {
+   using namespace std;
+
+   vector<rank_type> rank;
+   double delta;
+
+   int iterations = webgraph::pagerank::compute( g, rank, p, &delta, log );
+
+   *log << "Stopped after " << iterations << " iterations, delta " << delta << "\n";
+
+   ofstream out( dest.c_str() );
+   out.precision( 10 );
+
+   copy( rank.begin(), rank.end(), ostream_iterator<rank_type>( out, "\n" ) );
+}
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   using namespace std;
+
+   string src, dest, transpose;
+   webgraph::pagerank::pagerank_parameters p;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "Basename of the graph")
+      ("dest,d", po::value<string>(&dest), "File to write the ranks to")
+      ("alpha,a", po::value<double>(&p.alpha)->default_value( p.alpha ), "Damping factor")
+      ("tolerance,e", po::value<double>(&p.tolerance)->default_value( p.tolerance ), 
+       "Stop when the l1 norm of the change drops below this")
+      ("max-iterations,i", po::value<int>(&p.max_iterations)->default_value( p.max_iterations ),
+       "Maximum number of iterations")
+      ("threads,t", po::value<int>(&p.threads)->default_value( p.threads ), 
+       "Number of threads (more than one implies --pull)")
+      ("pull,p", "Iterate on the transpose, built in memory")
+      ("transpose,T", po::value<string>(&transpose), 
+       "Basename of the transpose of the graph, to iterate on (implies --pull)")
+      ("float,f", "Keep ranks in single precision")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   if( vm.count( "help" ) || !vm.count( "source" ) || !vm.count( "dest" ) ) {
+      cerr << desc;
+
+      return 1;
+   }
+
+   ostream* log = &cerr;
+
+   p.pull = vm.count( "pull" ) || vm.count( "transpose" ) || p.threads > 1;
+
+   // Decoding a graph with several threads requires offsets.
+   bvg::graph::graph_ptr g = p.pull && p.threads > 1 ? bvg::graph::load( src ) 
+      : bvg::graph::load_offline( src );
+   bvg::graph::graph_ptr t;
+
+   if( vm.count( "transpose" ) ) {
+      t = p.threads > 1 ? bvg::graph::load( transpose ) : bvg::graph::load_offline( transpose );
+      p.transpose = t.get();
+   }
+
+   if( vm.count( "float" ) )
+      compute_and_write<float>( *g, p, dest, log );
+   else
+      compute_and_write<double>( *g, p, dest, log );
+
+   return 0;
+}
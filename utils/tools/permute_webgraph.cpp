@@ -0,0 +1,149 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Renumbers the nodes of a BV graph and writes the result as a BV graph.
+ *
+ *      ./permute_webgraph --source=graph --dest=graph-llp --order=llp --write-perm=graph.llp
+ *      ./permute_webgraph --source=graph --dest=graph-p --perm=graph.llp
+ *
+ * The permutation is either read from a file (--perm), one integer per line giving the
+ * new number of each node in turn, or computed with --order=bfs, degree or llp. Arcs are
+ * mapped, sorted in batches of --batch-size, spilled to --temp-dir and merged straight
+ * into the compressor, so the graph never has to fit in memory; only the permutation does.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/transform.hpp"
+#include "../../webgraph/ordering.hpp"
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   using namespace std;
+
+   string src, dest, temp_dir, perm_file, order_name, write_perm;
+   long batch_size = webgraph::arc_list_builder::DEFAULT_BATCH_SIZE;
+   int window_size = -1, 
+      max_ref_count = -1, 
+      min_interval_length = -1, 
+      zeta_k = -1,
+      iterations = 100;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "Basename of the graph to permute")
+      ("dest,d", po::value<string>(&dest), "Basename of the permuted graph (may be omitted with --write-perm)")
+      ("perm,p", po::value<string>(&perm_file), "Read the permutation from this file")
+      ("order,o", po::value<string>(&order_name), "Compute the permutation: bfs, degree or llp")
+      ("write-perm", po::value<string>(&write_perm), "Save the permutation to this file")
+      ("iterations", po::value<int>(&iterations)->default_value( iterations ), 
+       "Maximum label propagation sweeps per gamma (llp only)")
+      ("batch-size,b", po::value<long>(&batch_size)->default_value( batch_size ), 
+       "Number of arcs handled in memory at once")
+      ("temp-dir,T", po::value<string>(&temp_dir), 
+       "Directory for sorted runs (default $TMPDIR or /tmp)")
+      ("window-size,w", po::value<int>(&window_size), "Reference window size")
+      ("max-ref-count,m", po::value<int>(&max_ref_count), "Maximum number of backward references")
+      ("min-interval-length", po::value<int>(&min_interval_length), "Minimum interval length")
+      ("zeta-k,k", po::value<int>(&zeta_k), "The k parameter for zeta-k codes")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   if( vm.count( "help" ) || !vm.count( "source" ) || vm.count( "perm" ) == vm.count( "order" ) 
+       || ( !vm.count( "dest" ) && !vm.count( "write-perm" ) ) ) {
+      cerr << "Exactly one of --perm and --order must be given.\n" << desc;
+
+      return 1;
+   }
+
+   ostream* log = &cerr;
+   vector<int> perm;
+
+   if( vm.count( "perm" ) ) {
+      ifstream in( perm_file.c_str() );
+      int p;
+
+      assert( in.good() );
+      while( in >> p ) 
+         perm.push_back( p );
+   } else {
+      vector<int> order;
+
+      if( order_name == "bfs" ) {
+         webgraph::ordering::bfs_order( *bvg::graph::load( src ), order );
+      } else if( order_name == "degree" ) {
+         webgraph::ordering::degree_order( *bvg::graph::load_offline( src ), order );
+      } else if( order_name == "llp" ) {
+         webgraph::ordering::llp_order( *bvg::graph::load_sequential( src ), order, 
+                                        webgraph::ordering::default_gammas(), 
+                                        iterations, log );
+      } else {
+         cerr << "Unknown order " << order_name << "; use bfs, degree or llp.\n";
+
+         return 1;
+      }
+
+      webgraph::ordering::to_permutation( order, perm );
+   }
+
+   if( !webgraph::ordering::is_permutation( perm ) ) {
+      cerr << "Not a permutation.\n";
+
+      return 1;
+   }
+
+   if( vm.count( "write-perm" ) ) {
+      ofstream out( write_perm.c_str() );
+
+      for( unsigned i = 0; i < perm.size(); i++ ) 
+         out << perm[i] << "\n";
+   }
+
+   if( vm.count( "dest" ) ) {
+      bvg::graph::graph_ptr g = bvg::graph::load_offline( src );
+
+      if( (long)perm.size() != g->get_num_nodes() ) {
+         cerr << "The permutation has " << perm.size() << " entries, but the graph has " 
+              << g->get_num_nodes() << " nodes.\n";
+
+         return 1;
+      }
+
+      webgraph::arc_list_builder b( batch_size, temp_dir, log );
+
+      webgraph::transform::permute( *g, perm, b, log );
+
+      bvg::graph::store( b, dest, window_size, max_ref_count, min_interval_length, 
+                         zeta_k, 0, log );
+   }
+
+   return 0;
+}
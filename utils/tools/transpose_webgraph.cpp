@@ -0,0 +1,109 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Writes the transpose of a BV graph (the graph with every arc reversed) as a BV graph.
+ *
+ *      ./transpose_webgraph --source=graph --dest=graph-t
+ *
+ * If the graph has at most --batch-size arcs it is transposed in memory, using --threads
+ * threads; otherwise reversed arcs are sorted in batches of --batch-size, spilled to
+ * --temp-dir and merged straight into the compressor.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/transform.hpp"
+#include "../../webgraph/csr_view.hpp"
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   using namespace std;
+
+   string src, dest, temp_dir;
+   long batch_size = webgraph::arc_list_builder::DEFAULT_BATCH_SIZE;
+   int threads = 1,
+      window_size = -1, 
+      max_ref_count = -1, 
+      min_interval_length = -1, 
+      zeta_k = -1;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "Basename of the graph to transpose")
+      ("dest,d", po::value<string>(&dest), "Basename of the transpose")
+      ("batch-size,b", po::value<long>(&batch_size)->default_value( batch_size ), 
+       "Number of arcs handled in memory at once")
+      ("temp-dir,T", po::value<string>(&temp_dir), 
+       "Directory for sorted runs (default $TMPDIR or /tmp)")
+      ("threads,t", po::value<int>(&threads)->default_value( threads ), 
+       "Number of threads for the in-memory transpose")
+      ("window-size,w", po::value<int>(&window_size), "Reference window size")
+      ("max-ref-count,m", po::value<int>(&max_ref_count), "Maximum number of backward references")
+      ("min-interval-length", po::value<int>(&min_interval_length), "Minimum interval length")
+      ("zeta-k,k", po::value<int>(&zeta_k), "The k parameter for zeta-k codes")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   if( vm.count( "help" ) || !vm.count( "source" ) || !vm.count( "dest" ) ) {
+      cerr << desc;
+
+      return 1;
+   }
+
+   ostream* log = &cerr;
+
+   // Only the metadata is loaded at first, to decide which way to go.
+   bvg::graph::graph_ptr g = bvg::graph::load_offline( src );
+
+   if( g->get_num_arcs() <= batch_size ) {
+      if( threads > 1 )
+         g = bvg::graph::load( src );
+
+      vector<long> offsets;
+      vector<int> targets;
+
+      webgraph::transform::transpose_in_memory( *g, offsets, targets, threads, log );
+
+      webgraph::csr_view<long, int> t( g->get_num_nodes(), &offsets[0], 
+                                       targets.empty() ? NULL : &targets[0] );
+
+      bvg::graph::store( t, dest, window_size, max_ref_count, min_interval_length, 
+                         zeta_k, 0, log );
+   } else {
+      webgraph::arc_list_builder b( batch_size, temp_dir, log );
+
+      webgraph::transform::transpose( *g, b, log );
+
+      bvg::graph::store( b, dest, window_size, max_ref_count, min_interval_length, 
+                         zeta_k, 0, log );
+   }
+
+   return 0;
+}
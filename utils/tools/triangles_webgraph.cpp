@@ -0,0 +1,122 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Counts the triangles of a BV graph, taking arcs as undirected, and prints the
+ * transitivity and the average local clustering coefficient.
+ *
+ *      ./triangles_webgraph --source=graph --transpose=graph-t [--threads=4]
+ *      ./triangles_webgraph --source=graph --transpose=graph-t --samples=1000000
+ *
+ * The transpose can be omitted for symmetric graphs. With --dest, the number of
+ * triangles and the clustering coefficient of each node are written as text, one node per
+ * line. With --samples the count is estimated from that many random wedges instead.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/triangles.hpp"
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   using namespace std;
+
+   string src, transpose, dest;
+   int threads = 1;
+   long samples = 0;
+   boost::uint32_t seed = 0;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "Basename of the graph")
+      ("transpose,T", po::value<string>(&transpose), 
+       "Basename of the transpose (default: the graph is symmetric)")
+      ("dest,d", po::value<string>(&dest), 
+       "File to write the triangles and clustering coefficient of each node to")
+      ("samples,n", po::value<long>(&samples), "Estimate from this many random wedges")
+      ("seed", po::value<boost::uint32_t>(&seed)->default_value( seed ), 
+       "Seed for sampling")
+      ("threads,t", po::value<int>(&threads)->default_value( threads ), 
+       "Number of threads")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   if( vm.count( "help" ) || !vm.count( "source" ) ) {
+      cerr << desc;
+
+      return 1;
+   }
+
+   ostream* log = &cerr;
+
+   // Sampling needs random access, and splitting scans among threads offsets.
+   const bool offsets = samples > 0 || threads > 1;
+
+   bvg::graph::graph_ptr g = offsets ? bvg::graph::load( src, log ) 
+      : bvg::graph::load_offline( src, log );
+   bvg::graph::graph_ptr t = transpose.empty() ? g 
+      : offsets ? bvg::graph::load( transpose, log ) 
+      : bvg::graph::load_offline( transpose, log );
+
+   if( samples > 0 ) {
+      double transitivity;
+      double triangles = webgraph::triangles::sample( *g, *t, samples, seed, threads, 
+                                                      &transitivity, log );
+
+      cout << "triangles\t" << triangles << "\n"
+           << "transitivity\t" << transitivity << "\n";
+
+      return 0;
+   }
+
+   vector<long> per_node;
+   vector<int> degree;
+   vector<double> coefficient;
+
+   long triangles = webgraph::triangles::count( *g, *t, per_node, degree, threads, log );
+   webgraph::triangles::local_clustering( per_node, degree, coefficient );
+
+   double average = 0;
+   for( size_t x = 0; x < coefficient.size(); x++ ) 
+      average += coefficient[x];
+
+   cout << "triangles\t" << triangles << "\n"
+        << "transitivity\t" << 3 * triangles / webgraph::triangles::wedges( degree ) << "\n"
+        << "average clustering\t" << average / max( (size_t)1, coefficient.size() ) << "\n";
+
+   if( !dest.empty() ) {
+      ofstream out( dest.c_str() );
+
+      for( size_t x = 0; x < per_node.size(); x++ ) 
+         out << per_node[x] << " " << coefficient[x] << "\n";
+   }
+
+   return 0;
+}
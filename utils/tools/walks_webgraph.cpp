@@ -0,0 +1,139 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Random walks and personalized PageRank on a BV graph.
+ *
+ *      ./walks_webgraph --source=graph --node=12 --node=40 --walks=10 --length=20
+ *      ./walks_webgraph --source=graph --node=12 --ppr --walks=100000 [--top=20]
+ *
+ * Without --ppr, prints each walk on a line, stopping early at nodes without successors.
+ * With --ppr, estimates the personalized PageRank of each source from --walks walks that
+ * stop with probability 1 - alpha at each step, and prints the --top nodes with their
+ * scores. --random picks that many start nodes uniformly instead of --node.
+ * --decompress keeps the lists in memory.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int.hpp>
+#include <boost/random/variate_generator.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/random_walks.hpp"
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   namespace rw = webgraph::random_walks;
+   using namespace std;
+
+   string src;
+   vector<int> nodes;
+   int random = 0, walks = 1, length = 10, top = 10;
+   double alpha = .85;
+   rw::walk_parameters p;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "Basename of the graph")
+      ("node,n", po::value< vector<int> >(&nodes)->composing(), "Start node (repeatable)")
+      ("random,r", po::value<int>(&random), "Start from this many random nodes")
+      ("walks,w", po::value<int>(&walks)->default_value( walks ), 
+       "Walks from each start node")
+      ("length,l", po::value<int>(&length)->default_value( length ), "Steps of each walk")
+      ("ppr", "Estimate personalized PageRank instead of printing walks")
+      ("alpha,a", po::value<double>(&alpha)->default_value( alpha ), 
+       "Probability of continuing a walk (with --ppr)")
+      ("top", po::value<int>(&top)->default_value( top ), 
+       "Nodes to print per source (with --ppr; 0 for all)")
+      ("seed", po::value<boost::uint64_t>(&p.seed)->default_value( p.seed ), "Random seed")
+      ("threads,t", po::value<int>(&p.threads)->default_value( p.threads ), 
+       "Number of threads")
+      ("decompress", "Decompress the graph in memory")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   if( vm.count( "help" ) || !vm.count( "source" ) || ( nodes.empty() && random <= 0 ) || 
+       walks <= 0 || length < 0 || alpha < 0 || alpha >= 1 ) {
+      cerr << desc;
+
+      return 1;
+   }
+
+   ostream* log = &cerr;
+
+   bvg::graph::graph_ptr g = vm.count( "decompress" ) 
+      ? bvg::graph::load_decompressed( src, p.threads, log ) : bvg::graph::load( src, log );
+
+   if( random > 0 ) {
+      boost::mt19937 engine( (boost::uint32_t)p.seed );
+      boost::uniform_int<int> node( 0, g->get_num_nodes() - 1 );
+      boost::variate_generator< boost::mt19937&, boost::uniform_int<int> > draw( engine, node );
+
+      for( int i = 0; i < random; i++ ) 
+         nodes.push_back( draw() );
+   }
+
+   for( size_t i = 0; i < nodes.size(); i++ ) {
+      if( nodes[i] < 0 || nodes[i] >= g->get_num_nodes() ) {
+         cerr << "No node " << nodes[i] << " in " << src << "\n";
+
+         return 1;
+      }
+   }
+
+   if( vm.count( "ppr" ) ) {
+      vector< vector< pair<int, double> > > ppr;
+
+      rw::personalized_pagerank( *g, nodes, walks, alpha, ppr, top, p );
+
+      for( size_t k = 0; k < nodes.size(); k++ ) {
+         cout << "source " << nodes[k] << "\n";
+
+         for( size_t i = 0; i < ppr[k].size(); i++ ) 
+            cout << ppr[k][i].first << "\t" << ppr[k][i].second << "\n";
+      }
+   }
+   else {
+      vector<int> starts, paths;
+
+      for( size_t k = 0; k < nodes.size(); k++ ) 
+         starts.insert( starts.end(), walks, nodes[k] );
+
+      rw::walk( *g, starts, length, paths, p );
+
+      for( size_t w = 0; w < starts.size(); w++ ) {
+         for( int t = 0; t <= length && paths[ w * ( length + 1 ) + t ] != -1; t++ ) 
+            cout << ( t > 0 ? " " : "" ) << paths[ w * ( length + 1 ) + t ];
+
+         cout << "\n";
+      }
+   }
+
+   return 0;
+}
@@ -0,0 +1,72 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Prints how the bits of a BV graph are spent: for each component of the format
+ * (outdegrees, references, blocks, intervals, residuals...) the number of values coded,
+ * the bits they take and a log2 histogram of their magnitudes.
+ *
+ *      ./webgraph_stats --source=graph
+ *
+ * The graph is scanned from disk, so it needs not fit in memory.
+ */
+
+#include <iostream>
+#include <string>
+#include <boost/program_options.hpp>
+
+#include "../../webgraph/webgraph.hpp"
+#include "../../webgraph/compression_stats.hpp"
+
+int main( int argc, char* argv[] ) {
+   namespace po = boost::program_options;
+   namespace bvg = webgraph::bv_graph;
+   using namespace std;
+
+   string src;
+
+   po::options_description desc( "Usage - " );
+
+   desc.add_options()
+      ("help,h", "Print help message")
+      ("source,s", po::value<string>(&src), "Basename of the graph")
+      ;
+
+   po::variables_map vm;
+   po::store( po::parse_command_line( argc, argv, desc), vm );
+   po::notify( vm );
+
+   if( vm.count( "help" ) || !vm.count( "source" ) ) {
+      cerr << desc;
+
+      return 1;
+   }
+
+   bvg::graph::graph_ptr g = bvg::graph::load_offline( src );
+   bvg::compression_stats stats;
+
+   g->scan_stats( stats, &cerr );
+
+   cout << g->get_num_nodes() << " nodes, " << g->get_num_arcs() << " arcs, "
+        << (double)stats.get_graph_bits() / g->get_num_arcs() << " bits/link\n\n";
+   
+   stats.report( cout );
+
+   return 0;
+}
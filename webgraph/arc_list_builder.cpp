@@ -0,0 +1,437 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "arc_list_builder.hpp"
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <queue>
+#include <stdexcept>
+#include <functional>
+#include <algorithm>
+
+#include <unistd.h>
+
+#include "../bitstreams/input_bitstream.hpp"
+#include "../bitstreams/output_bitstream.hpp"
+
+namespace webgraph {
+
+using namespace std;
+
+typedef arc_list_builder::arc_key arc_key;
+
+////////////////////////////////////////////////////////////////////////////////
+/*!
+ * Reads back one sorted run, either from a spilled file or straight from the in-memory
+ * batch.
+ */
+class run_reader {
+private:
+   boost::shared_ptr<ibitstream> ibs;
+   const arc_key* mem;
+   long remaining;
+   bool first;
+   unsigned int prev_src, prev_dst;
+
+public:
+   run_reader( const std::string& file, long arcs ) :
+      ibs( new ibitstream( file ) ), mem( NULL ), remaining( arcs ), first( true ), prev_src( 0 ), prev_dst( 0 ) {
+   }
+
+   run_reader( const arc_key* mem, long arcs ) :
+      mem( mem ), remaining( arcs ), first( true ), prev_src( 0 ), prev_dst( 0 ) {
+   }
+
+   bool next( arc_key& key ) {
+      if( remaining == 0 )
+         return false;
+      remaining--;
+
+      if( mem != NULL ) {
+         key = *mem++;
+         return true;
+      }
+
+      // See run_writer for the format.
+      unsigned int gap = ibs->read_delta();
+
+      if( gap == 0 && !first ) {
+         prev_dst += ibs->read_delta() + 1;
+      } else {
+         prev_src += gap;
+         prev_dst = ibs->read_delta();
+      }
+      first = false;
+
+      key = (arc_key)prev_src << 32 | prev_dst;
+      return true;
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/*!
+ * Writes one sorted run. Each arc is written as the &delta; code of the gap from the
+ * previous source; if the gap is 0 this is followed by the &delta; code of the gap from the
+ * previous target minus one, otherwise by the target itself. The first arc is always
+ * written as source and target.
+ */
+class run_writer {
+private:
+   obitstream obs;
+   long written;
+   unsigned int prev_src, prev_dst;
+
+public:
+   run_writer( const std::string& file ) :
+      obs( file ), written( 0 ), prev_src( 0 ), prev_dst( 0 ) {
+   }
+
+   long arcs() const {
+      return written;
+   }
+
+   void write( arc_key key ) {
+      unsigned int src = (unsigned int)( key >> 32 ), dst = (unsigned int)key;
+
+      if( src == prev_src && written > 0 ) {
+         obs.write_delta( 0 );
+         obs.write_delta( dst - prev_dst - 1 );
+      } else {
+         obs.write_delta( src - prev_src );
+         obs.write_delta( dst );
+      }
+
+      prev_src = src;
+      prev_dst = dst;
+      written++;
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/*!
+ * Merges runs, handing out either one successor list at a time or one arc at a time.
+ */
+class run_merger {
+private:
+   typedef std::pair<arc_key, int> head;
+
+   std::vector<boost::shared_ptr<run_reader> > readers;
+   std::priority_queue<head, std::vector<head>, std::greater<head> > heads;
+
+public:
+   std::vector<unsigned int> succ;
+
+   void add_run( boost::shared_ptr<run_reader> r ) {
+      arc_key k;
+
+      readers.push_back( r );
+      if( r->next( k ) )
+         heads.push( head( k, readers.size() - 1 ) );
+   }
+
+   /** Gives the next arc, in order and without duplicates, if any is left. */
+   bool next( arc_key& key ) {
+      if( heads.empty() )
+         return false;
+
+      key = heads.top().first;
+
+      // the same arc may appear in several runs.
+      while( !heads.empty() && heads.top().first == key ) {
+         head h = heads.top();
+         heads.pop();
+
+         if( readers[ h.second ]->next( h.first ) )
+            heads.push( h );
+      }
+
+      return true;
+   }
+
+   /** Loads the successors of node x into succ; nodes must be asked for in order. */
+   void load( long x ) {
+      succ.clear();
+
+      while( !heads.empty() && (long)( heads.top().first >> 32 ) == x ) {
+         head h = heads.top();
+         heads.pop();
+
+         unsigned int dst = (unsigned int)h.first;
+
+         // the same arc may appear in several runs.
+         if( succ.empty() || succ.back() != dst )
+            succ.push_back( dst );
+
+         if( readers[ h.second ]->next( h.first ) )
+            heads.push( h );
+      }
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+void radix_sort( vector<arc_key>& keys, vector<arc_key>& scratch ) {
+   const int DIGIT_BITS = 16, DIGITS = 64 / DIGIT_BITS, RADIX = 1 << DIGIT_BITS;
+   const long n = keys.size();
+
+   if( n < 2 )
+      return;
+
+   // one histogram per digit, all filled in a single scan.
+   vector<long> count( DIGITS * RADIX );
+
+   for( long i = 0; i < n; i++ ) 
+      for( int d = 0; d < DIGITS; d++ )
+         count[ d * RADIX + ( ( keys[i] >> ( d * DIGIT_BITS ) ) & ( RADIX - 1 ) ) ]++;
+
+   scratch.resize( n );
+
+   arc_key* from = &keys[0];
+   arc_key* to = &scratch[0];
+
+   for( int d = 0; d < DIGITS; d++ ) {
+      long* c = &count[ d * RADIX ];
+      const int shift = d * DIGIT_BITS;
+
+      // if every key has the same digit here, this pass would be the identity.
+      if( c[ ( from[0] >> shift ) & ( RADIX - 1 ) ] == n )
+         continue;
+
+      long sum = 0;
+      for( int i = 0; i < RADIX; i++ ) {
+         long t = c[i];
+         c[i] = sum;
+         sum += t;
+      }
+
+      for( long i = 0; i < n; i++ ) 
+         to[ c[ ( from[i] >> shift ) & ( RADIX - 1 ) ]++ ] = from[i];
+
+      std::swap( from, to );
+   }
+
+   if( from != &keys[0] )
+      keys.swap( scratch );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+arc_list_builder::arc_list_builder( long batch_size, string temp_dir, ostream* log ) :
+   batch_size( batch_size ), max_fan_in( DEFAULT_MAX_FAN_IN ), temp_dir( temp_dir ), 
+   log( log ),
+   max_node( -1 ), min_source( -1 ), num_nodes( -1 ), num_added( 0 ), finished( false ) {
+   assert( batch_size > 0 );
+
+   if( this->temp_dir.empty() ) {
+      const char* t = getenv( "TMPDIR" );
+      this->temp_dir = ( t != NULL && *t != '\0' ) ? t : "/tmp";
+   }
+}
+
+arc_list_builder::~arc_list_builder() {
+   for( vector<string>::iterator i = run_files.begin(); i != run_files.end(); i++ ) 
+      unlink( i->c_str() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void arc_list_builder::sort_batch() {
+   radix_sort( batch, scratch );
+   batch.erase( unique( batch.begin(), batch.end() ), batch.end() );
+}
+
+/** Creates an empty temporary file in temp_dir and returns its name. */
+string arc_list_builder::temp_file() const {
+   string name = temp_dir + "/webgraph-arcs-XXXXXX";
+   vector<char> templ( name.begin(), name.end() );
+   templ.push_back( '\0' );
+
+   int fd = mkstemp( &templ[0] );
+
+   if( fd < 0 )
+      throw runtime_error( "Cannot create a run in " + temp_dir + ": " + strerror( errno ) );
+
+   close( fd );
+
+   return &templ[0];
+}
+
+/** Sorts the batch and writes it out as a run (see run_writer for the format). */
+void arc_list_builder::spill_batch() {
+   sort_batch();
+
+   string name = temp_file();
+
+   {
+      run_writer w( name );
+
+      for( vector<arc_key>::const_iterator i = batch.begin(); i != batch.end(); i++ ) 
+         w.write( *i );
+   }
+
+   run_files.push_back( name );
+   run_arcs.push_back( batch.size() );
+
+   if( log != NULL )
+      *log << "Spilled run " << run_files.size() << " (" << batch.size() 
+           << " distinct arcs) to " << name << endl;
+
+   batch.clear();
+}
+
+/*!
+ * Merges the oldest runs into a single run, removing duplicates across them, until at most
+ * max_fan_in runs are left. Runs are merged max_fan_in at a time, as in passes over all of
+ * them, except for the last merge, which takes just enough runs. The runs merged are
+ * removed at once, so the disk space needed grows by at most a group at a time, and every
+ * run is always in run_files, to be removed by the destructor should anything fail.
+ */
+void arc_list_builder::merge_runs() {
+   while( (long)run_files.size() > max_fan_in ) {
+      const long k = min( (long)max_fan_in, (long)run_files.size() - max_fan_in + 1 );
+
+      run_files.push_back( temp_file() );
+      run_arcs.push_back( 0 );
+
+      {
+         run_merger m;
+         run_writer w( run_files.back() );
+         arc_key key;
+
+         for( long i = 0; i < k; i++ ) 
+            m.add_run( boost::shared_ptr<run_reader>( 
+                          new run_reader( run_files[i], run_arcs[i] ) ) );
+
+         while( m.next( key ) ) 
+            w.write( key );
+
+         run_arcs.back() = w.arcs();
+      }
+
+      for( long i = 0; i < k; i++ ) 
+         unlink( run_files[i].c_str() );
+
+      run_files.erase( run_files.begin(), run_files.begin() + k );
+      run_arcs.erase( run_arcs.begin(), run_arcs.begin() + k );
+
+      if( log != NULL )
+         *log << "Merged " << k << " runs into one (" << run_arcs.back() 
+              << " distinct arcs), " << run_files.size() << " runs left" << endl;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long arc_list_builder::add_arcs( istream& in ) {
+   string line;
+   long read = 0;
+
+   while( getline( in, line ) ) {
+      const char* p = line.c_str();
+
+      while( *p == ' ' || *p == '\t' ) 
+         p++;
+
+      if( *p == '\0' || *p == '#' || *p == '\r' )
+         continue;
+
+      char* e;
+      unsigned long src = strtoul( p, &e, 10 );
+      assert( e != p );
+      p = e;
+      unsigned long dst = strtoul( p, &e, 10 );
+      assert( e != p );
+
+      add_arc( src, dst );
+      read++;
+   }
+
+   return read;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void arc_list_builder::finish() {
+   assert( !finished );
+
+   // the last batch stays in memory; only spill it if others are already on disk.
+   if( run_files.empty() ) {
+      sort_batch();
+   } else if( !batch.empty() ) {
+      spill_batch();
+   }
+
+   merge_runs();
+
+   vector<arc_key>().swap( scratch );
+   if( !run_files.empty() ) 
+      vector<arc_key>().swap( batch );
+
+   finished = true;
+}
+
+long arc_list_builder::get_num_nodes() const {
+   if( num_nodes >= 0 ) {
+      assert( max_node < num_nodes );
+      return num_nodes;
+   }
+   return max_node + 1;
+}
+
+pair<arc_list_builder::node_iterator, arc_list_builder::node_iterator> 
+arc_list_builder::get_node_iterator() const {
+   assert( finished );
+
+   boost::shared_ptr<run_merger> m( new run_merger() );
+
+   if( run_files.empty() ) {
+      m->add_run( boost::shared_ptr<run_reader>( 
+                     new run_reader( batch.empty() ? NULL : &batch[0], batch.size() ) ) );
+   } else {
+      for( unsigned i = 0; i < run_files.size(); i++ ) 
+         m->add_run( boost::shared_ptr<run_reader>( 
+                        new run_reader( run_files[i], run_arcs[i] ) ) );
+   }
+
+   long n = get_num_nodes();
+
+   return make_pair( node_iterator( m, n ), node_iterator( boost::shared_ptr<run_merger>(), n ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+arc_list_builder::node_iterator::node_iterator( boost::shared_ptr<run_merger> m, long n ) :
+   merger( m ), curr( m == NULL ? n : 0 ), n( n ) {
+   if( merger != NULL && curr < n )
+      merger->load( curr );
+}
+
+void arc_list_builder::node_iterator::increment() {
+   assert( curr < n );
+
+   if( ++curr < n )
+      merger->load( curr );
+}
+
+int outdegree( const arc_list_builder::node_iterator& i ) {
+   return i.merger->succ.size();
+}
+
+const vector<unsigned int>& successors( const arc_list_builder::node_iterator& i ) {
+   return i.merger->succ;
+}
+
+}
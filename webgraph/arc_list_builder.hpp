@@ -0,0 +1,250 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef ARC_LIST_BUILDER_HPP_
+#define ARC_LIST_BUILDER_HPP_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "successor_source.hpp"
+
+namespace webgraph {
+
+class run_merger;
+
+/*!
+ * Builds a graph out of an arbitrary, unsorted and possibly duplicated sequence of arcs,
+ * using a bounded amount of memory.
+ *
+ * Arcs are accumulated into a batch of at most batch_size arcs. When the batch fills up it
+ * is radix-sorted, duplicates are removed, and it is spilled to a temporary file (a "run")
+ * as gap-coded pairs. Scanning the builder k-way merges the runs on the fly and produces
+ * sorted successor lists, node 0 first, so the result can be handed straight to
+ * bv_graph::graph::store without ever being materialized. If everything fits in a single
+ * batch nothing is written to disk.
+ *
+ * At most max_fan_in runs are open at once: if more were spilled, finish() merges groups
+ * of max_fan_in runs into longer runs, pass after pass, until a single merge is enough.
+ * Each such pass reads and writes all the arcs once more.
+ *
+ * Memory use is about 16 bytes per batch arc (the batch plus the radix sort scratch
+ * space), plus one bitstream buffer (and file descriptor) per run while merging.
+ *
+ * Typical use:
+ *
+ *    arc_list_builder b( 10000000, "/scratch" );
+ *    b.add_arcs( std::cin );
+ *    b.finish();
+ *    bv_graph::graph::store( b, "out", -1, -1, -1, -1, 0 );
+ */
+class arc_list_builder : public boost::noncopyable {
+public:
+   typedef boost::uint64_t arc_key;
+
+   /** The default number of arcs held in memory at once. */
+   static const long DEFAULT_BATCH_SIZE = 1000000;
+
+   /** The default number of runs merged at once. */
+   static const int DEFAULT_MAX_FAN_IN = 64;
+
+   /*!
+    * Sequential iterator over the nodes of a finished builder; dereferences to the node
+    * index. Copies share the underlying merge, so this is a single pass iterator - call
+    * get_node_iterator() again to rescan.
+    */
+   class node_iterator : public boost::iterator_facade<
+      node_iterator,
+      long,
+      boost::single_pass_traversal_tag,
+      long> {
+   private:
+      boost::shared_ptr<run_merger> merger;
+      long curr;
+      long n;
+
+   public:
+      node_iterator() : curr(0), n(0) {}
+      node_iterator( boost::shared_ptr<run_merger> m, long n );
+
+      friend int outdegree( const node_iterator& i );
+      friend const std::vector<unsigned int>& successors( const node_iterator& i );
+
+   private:
+      friend class boost::iterator_core_access;
+
+      void increment();
+
+      long dereference() const {
+         return curr;
+      }
+
+      bool equal( const node_iterator& rhs ) const {
+         return curr == rhs.curr;
+      }
+   };
+
+private:
+   long batch_size;
+   int max_fan_in;
+   std::string temp_dir;
+   std::ostream* log;
+
+   std::vector<arc_key> batch;
+   std::vector<arc_key> scratch;
+
+   std::vector<std::string> run_files;
+   std::vector<long> run_arcs;
+
+   long max_node;
+   long min_source;
+   long num_nodes;
+   long num_added;
+   bool finished;
+
+   void sort_batch();
+   void spill_batch();
+   void merge_runs();
+   std::string temp_file() const;
+
+public:
+   /*!
+    * @param batch_size the number of arcs to hold in memory before spilling a run.
+    * @param temp_dir where to put runs; if empty, $TMPDIR or /tmp is used.
+    * @param log a stream to report progress on, or <code>NULL</code>.
+    */
+   arc_list_builder( long batch_size = DEFAULT_BATCH_SIZE, std::string temp_dir = "",
+                     std::ostream* log = NULL );
+
+   /** Removes the runs. */
+   ~arc_list_builder();
+
+   void add_arc( unsigned int src, unsigned int dst ) {
+      assert( !finished );
+
+      if( (long)batch.size() == batch_size )
+         spill_batch();
+
+      // grow by hand, so that the batch never ends up much larger than batch_size.
+      if( batch.size() == batch.capacity() ) 
+         batch.reserve( std::min( 2 * batch.capacity() + 1024, (size_t)batch_size ) );
+
+      batch.push_back( (arc_key)src << 32 | dst );
+
+      if( (long)src > max_node ) max_node = src;
+      if( (long)dst > max_node ) max_node = dst;
+      if( min_source < 0 || (long)src < min_source ) min_source = src;
+      num_added++;
+   }
+
+   /*!
+    * Reads arcs as whitespace-separated "source target" pairs, one per line. Empty lines
+    * and lines starting with '#' are skipped. Returns the number of arcs read.
+    */
+   long add_arcs( std::istream& in );
+
+   /*!
+    * Fixes the number of nodes. By default it is one more than the largest node seen,
+    * which loses trailing isolated nodes.
+    */
+   void set_num_nodes( long n ) {
+      num_nodes = n;
+   }
+
+   /** Sets the number of runs merged at once, at least 2; must come before finish(). */
+   void set_max_fan_in( int f ) {
+      assert( f >= 2 && !finished );
+      max_fan_in = f;
+   }
+
+   /*!
+    * Sorts what is left in the current batch. No arcs can be added afterwards, and the
+    * builder can then be scanned any number of times.
+    */
+   void finish();
+
+   long get_num_nodes() const;
+
+   /** The smallest source of the arcs added, or -1 if there are none. Appending to a graph
+    * with n nodes requires it to be at least n. */
+   long get_min_source() const {
+      return min_source;
+   }
+
+   /** The number of arcs added, duplicates included. */
+   long get_num_added_arcs() const {
+      return num_added;
+   }
+
+   /** The number of runs on disk: those spilled so far, or, after finish(), those left
+    * to merge while scanning. */
+   long get_num_runs() const {
+      return run_files.size();
+   }
+
+   std::pair<node_iterator, node_iterator> get_node_iterator() const;
+};
+
+int outdegree( const arc_list_builder::node_iterator& i );
+const std::vector<unsigned int>& successors( const arc_list_builder::node_iterator& i );
+
+/*!
+ * Sorts keys in place with an LSD radix sort on 16 bit digits, skipping digits on which
+ * all keys agree. scratch is used as temporary space and is resized as needed.
+ */
+void radix_sort( std::vector<arc_list_builder::arc_key>& keys,
+                 std::vector<arc_list_builder::arc_key>& scratch );
+
+////////////////////////////////////////////////////////////////////////////////
+template<>
+struct successor_source_traits<arc_list_builder> {
+   typedef arc_list_builder::node_iterator node_iterator;
+
+   static long num_nodes( const arc_list_builder& g ) {
+      return g.get_num_nodes();
+   }
+
+   static std::pair<node_iterator, node_iterator> nodes( const arc_list_builder& g ) {
+      return g.get_node_iterator();
+   }
+
+   static int successors( const node_iterator& i, std::vector<unsigned int>& dest ) {
+      const std::vector<unsigned int>& s = webgraph::successors( i );
+
+      if( s.size() > dest.size() )
+         dest.resize( s.size() );
+
+      std::copy( s.begin(), s.end(), dest.begin() );
+
+      return s.size();
+   }
+};
+
+}
+
+#endif /*ARC_LIST_BUILDER_HPP_*/
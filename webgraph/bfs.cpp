@@ -0,0 +1,245 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "bfs.hpp"
+#include "transform.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <boost/cstdint.hpp>
+
+namespace webgraph { namespace bfs {
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+pair<const int*, const int*> accessor::successors( int x ) {
+   if( g->is_decompressed() )
+      return g->get_decompressed_successors( x );
+
+   bv_graph::graph::successor_iterator i, end;
+
+   buffer.clear();
+
+   for( boost::tie( i, end ) = g->get_successors( x ); i != end; ++i ) 
+      buffer.push_back( *i );
+
+   const int* b = buffer.empty() ? NULL : &buffer[0];
+
+   return make_pair( b, b + buffer.size() );
+}
+
+namespace {
+
+/*!
+ * State shared by the threads of a step of a visit. Work is handed out in chunks (of the
+ * frontier queue top-down, of the nodes bottom-up), claimed through work; the nodes found
+ * by a chunk, and the number of arcs out of them, go to its own slot of found and
+ * found_arcs.
+ */
+struct step_job {
+   const bv_graph::graph* g;
+   const vector<long>* pred_offsets;
+   const vector<int>* preds;
+   const vector<int>* outdegree;
+
+   int* distance;
+   int* parent;
+   int level;
+
+   const vector<int>* frontier;
+   const vector<boost::uint64_t>* frontier_bits;
+
+   parallel::chunks work;
+
+   vector< vector<int> > found;
+   vector<long> found_arcs;
+
+   /** Claims, for the next level, the unvisited successors of the frontier. */
+   void top_down() {
+      accessor a( *g );
+      long c, from, to;
+
+      while( work.claim( c, from, to ) ) {
+         vector<int>& f = found[c];
+         long arcs = 0;
+
+         for( long k = from; k < to; k++ ) {
+            const int x = (*frontier)[k];
+            const int* s, *end;
+
+            for( boost::tie( s, end ) = a.successors( x ); s != end; ++s ) {
+               const int y = *s;
+
+               if( distance[y] == -1 && 
+                   __sync_bool_compare_and_swap( distance + y, -1, level + 1 ) ) {
+                  parent[y] = x;
+                  f.push_back( y );
+
+                  if( !outdegree->empty() )
+                     arcs += (*outdegree)[y];
+               }
+            }
+         }
+
+         found_arcs[c] = arcs;
+      }
+   }
+
+   /** Gives each unvisited node of the chunk the first of its predecessors in the
+    * frontier as parent, if any. Only the chunk's own nodes are written. */
+   void bottom_up() {
+      const long* o = &(*pred_offsets)[0];
+      const int* p = preds->empty() ? NULL : &(*preds)[0];
+      const boost::uint64_t* bits = &(*frontier_bits)[0];
+      long c, from, to;
+
+      while( work.claim( c, from, to ) ) {
+         vector<int>& f = found[c];
+         long arcs = 0;
+
+         for( long y = from; y < to; y++ ) {
+            if( distance[y] != -1 ) 
+               continue;
+
+            for( const int* x = p + o[y]; x != p + o[y + 1]; ++x ) 
+               if( bits[ *x >> 6 ] & ( boost::uint64_t( 1 ) << ( *x & 63 ) ) ) {
+                  distance[y] = level + 1;
+                  parent[y] = *x;
+                  f.push_back( y );
+                  arcs += (*outdegree)[y];
+                  break;
+               }
+         }
+
+         found_arcs[c] = arcs;
+      }
+   }
+
+   /** Runs what on the given number of threads over items, in chunks of at least
+    * min_chunk, and waits for all of them. Too few items for 16 chunks are handled by
+    * the calling thread alone: starting threads would cost more, and long paths make for
+    * many tiny frontiers. */
+   void run( int threads, long items, long min_chunk, void (step_job::*what)() ) {
+      if( items < 16 * min_chunk )
+         threads = 1;
+
+      work.reset( items, threads, min_chunk );
+
+      found.resize( work.count() );
+      for( long c = 0; c < work.count(); c++ ) 
+         found[c].clear();
+      found_arcs.assign( work.count(), 0 );
+
+      parallel::run( threads, this, what );
+   }
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+engine::engine( const bv_graph::graph& g, const bfs_parameters& p, ostream* log ) : 
+   g( g ), params( p ) {
+   assert( g.get_offset_step() > 0 || g.is_decompressed() );
+
+   params.threads = parallel::random_access_threads( g, params.threads );
+
+   if( !params.direction_switching )
+      return;
+
+   transform::transpose_in_memory( g, pred_offsets, preds, params.threads, log );
+
+   // Every source occurs in the transpose once per arc.
+   outdegree.resize( g.get_num_nodes() );
+
+   for( vector<int>::const_iterator x = preds.begin(); x != preds.end(); ++x ) 
+      outdegree[ *x ]++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long engine::visit( int source, vector<int>& distance, vector<int>& parent, 
+                    ostream* log ) const {
+   const long n = g.get_num_nodes();
+
+   assert( source >= 0 && source < n );
+
+   distance.assign( n, -1 );
+   parent.assign( n, -1 );
+
+   distance[ source ] = 0;
+   parent[ source ] = source;
+
+   step_job job;
+   job.g = &g;
+   job.pred_offsets = &pred_offsets;
+   job.preds = &preds;
+   job.outdegree = &outdegree;
+   job.distance = &distance[0];
+   job.parent = &parent[0];
+
+   vector<int> frontier( 1, source );
+   vector<boost::uint64_t> frontier_bits;
+
+   long frontier_arcs = params.direction_switching ? outdegree[ source ] : 0;
+   long unvisited_arcs = params.direction_switching ? (long)preds.size() - frontier_arcs : 0;
+   long reached = 1;
+   bool bottom_up = false;
+
+   for( int level = 0; !frontier.empty(); level++ ) {
+      if( params.direction_switching ) {
+         if( !bottom_up ) 
+            bottom_up = frontier_arcs > unvisited_arcs / params.alpha;
+         else
+            bottom_up = frontier.size() >= n / params.beta;
+      }
+
+      job.level = level;
+      job.frontier = &frontier;
+
+      if( bottom_up ) {
+         frontier_bits.assign( ( n + 63 ) / 64, 0 );
+
+         for( vector<int>::const_iterator x = frontier.begin(); x != frontier.end(); ++x ) 
+            frontier_bits[ *x >> 6 ] |= boost::uint64_t( 1 ) << ( *x & 63 );
+
+         job.frontier_bits = &frontier_bits;
+         job.run( params.threads, n, 4096, &step_job::bottom_up );
+      } else
+         job.run( params.threads, frontier.size(), 64, &step_job::top_down );
+
+      frontier.clear();
+      frontier_arcs = 0;
+
+      for( size_t c = 0; c < job.found.size(); c++ ) {
+         frontier.insert( frontier.end(), job.found[c].begin(), job.found[c].end() );
+         frontier_arcs += job.found_arcs[c];
+      }
+
+      unvisited_arcs -= frontier_arcs;
+      reached += frontier.size();
+
+      if( log != NULL )
+         *log << "Level " << level + 1 << ( bottom_up ? " (bottom-up): " : ": " ) 
+              << frontier.size() << " nodes\n";
+   }
+
+   return reached;
+}
+
+} }
@@ -0,0 +1,104 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef BFS_HPP_
+#define BFS_HPP_
+
+#include <vector>
+#include <iostream>
+#include <utility>
+#include <boost/utility.hpp>
+
+#include "webgraph.hpp"
+
+/*!
+ * Breadth-first visits of compressed graphs, level by level, with the direction switching
+ * of Beamer, Asanović and Patterson (2012).
+ *
+ * A top-down step decodes the successors of the nodes of the frontier, held in a queue;
+ * a bottom-up step looks, for each unvisited node, for a predecessor in the frontier,
+ * held in a bitmap, and stops at the first one. Bottom-up steps are much cheaper once the
+ * frontier covers a good part of the graph, but need the transpose, which is built in
+ * memory when the engine is created (4 bytes per arc).
+ *
+ * Both kinds of step split their work in chunks among the threads, each of which decodes
+ * lists with its own accessor. Distances do not depend on the number of threads; with more
+ * than one thread, the parent of a node is any of its predecessors at the previous level.
+ */
+namespace webgraph { namespace bfs {
+
+struct bfs_parameters {
+   int threads;
+   /// Whether to switch to bottom-up steps; requires building the transpose.
+   bool direction_switching;
+   /// Go bottom-up when the arcs out of the frontier are more than 1 / alpha of the arcs
+   /// out of unvisited nodes...
+   double alpha;
+   /// ...and back top-down when the frontier holds less than 1 / beta of the nodes.
+   double beta;
+
+   bfs_parameters() : threads( 1 ), direction_switching( true ), alpha( 14 ), beta( 24 ) {}
+};
+
+/*!
+ * Per-thread access to successor lists. Lists of graphs loaded with
+ * graph::load_decompressed() are returned in place; others are decoded into a private
+ * buffer. Random access from several threads needs a graph loaded with all offsets.
+ */
+class accessor {
+private:
+   const bv_graph::graph* g;
+   std::vector<int> buffer;
+
+public:
+   accessor( const bv_graph::graph& g ) : g( &g ) {}
+
+   /** The successors of x, valid until the next call. */
+   std::pair<const int*, const int*> successors( int x );
+};
+
+/*!
+ * Visits g from any number of sources, one at a time. The transpose and the outdegrees
+ * are computed once, when the engine is created, and shared by all visits.
+ */
+class engine : public boost::noncopyable {
+private:
+   const bv_graph::graph& g;
+   bfs_parameters params;
+
+   std::vector<long> pred_offsets;
+   std::vector<int> preds;
+   std::vector<int> outdegree;
+
+public:
+   engine( const bv_graph::graph& g, const bfs_parameters& p = bfs_parameters(), 
+           std::ostream* log = NULL );
+
+   /*!
+    * Visits g from source. On return distance[x] is the distance of x from source and
+    * parent[x] its parent in the visit tree (source is its own parent), or both are -1
+    * if x is unreachable. Returns the number of nodes reached.
+    */
+   long visit( int source, std::vector<int>& distance, std::vector<int>& parent, 
+               std::ostream* log = NULL ) const;
+};
+
+} }
+
+#endif /*BFS_HPP_*/
@@ -0,0 +1,180 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef WEBGRAPH_BOOST_BIDIRECTIONAL_HPP
+#define WEBGRAPH_BOOST_BIDIRECTIONAL_HPP
+
+#include <cassert>
+#include <utility>
+#include <boost/shared_ptr.hpp>
+
+#include "integration.hpp"
+#include "in_edge_iterator.hpp"
+
+namespace webgraph { namespace bv_graph { namespace boost_integration {
+
+   /*!
+    * A BV graph paired with its transpose, which models the BGL bidirectional graph
+    * concept: out_edges() come from the graph and in_edges() from the successors in the
+    * transpose, both decoded on the fly, so algorithms that need predecessors run on
+    * compressed data and no adjacency list is stored. Each call to out_edges() or
+    * in_edges() still allocates an iterator, and a bit stream unless the graph is
+    * decompressed (see graph::get_successors). Both graphs must be online; the transpose
+    * needs random access (graph::load) for in_edges().
+    */
+   class bidirectional_graph {
+   private:
+      graph::graph_ptr g, transpose;
+
+   public:
+      bidirectional_graph( graph::graph_ptr g, graph::graph_ptr transpose ) 
+         : g( g ), transpose( transpose ) {
+         assert( g->get_num_nodes() == transpose->get_num_nodes() );
+         assert( g->get_num_arcs() == transpose->get_num_arcs() );
+      }
+
+      const graph& get_graph() const {
+         return *g;
+      }
+
+      const graph& get_transpose() const {
+         return *transpose;
+      }
+   };
+}}}
+
+namespace boost {
+
+   struct bv_bidirectional_traversal_category :
+      public virtual bv_graph_traversal_category,
+      public virtual bidirectional_graph_tag
+   {};
+
+   template<>
+   struct graph_traits< bvg_boost::bidirectional_graph > {
+      typedef bvg_traits::vertex_descriptor vertex_descriptor;
+      typedef bvg_traits::edge_descriptor edge_descriptor;
+
+      typedef directed_tag directed_category;
+      typedef disallow_parallel_edge_tag edge_parallel_category;
+      typedef bv_bidirectional_traversal_category traversal_category;
+
+      typedef bvg_traits::vertex_iterator vertex_iterator;
+      typedef bvg_traits::vertices_size_type vertices_size_type;
+      typedef bvg_traits::edge_iterator edge_iterator;
+      typedef bvg_traits::edges_size_type edges_size_type;
+      typedef bvg_traits::out_edge_iterator out_edge_iterator;
+      typedef bvg_traits::degree_size_type degree_size_type;
+      typedef bvg_traits::adjacency_iterator adjacency_iterator;
+
+      ////////////////////////////////////////////////////////////////////////////////
+      /*! 
+       * in_edge_iterator - required by the bidirectional graph concept
+       */
+      typedef bvg_boost::in_edge_iterator in_edge_iterator;
+   };
+}
+
+namespace webgraph { namespace bv_graph { namespace boost_integration {
+
+   // The functions are declared here rather than in boost, as for the graph alone, so that
+   // BGL algorithms and concept checks find them by argument-dependent lookup.
+
+   typedef boost::graph_traits<bidirectional_graph> bidir_traits;
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /*!
+    * Vertex List Graph, Edge List Graph, Incidence Graph and Adjacency Graph, as for the
+    * graph alone.
+    */
+   inline std::pair< bidir_traits::vertex_iterator, bidir_traits::vertex_iterator >
+   vertices( const bidirectional_graph& g ) {
+      return boost::vertices( g.get_graph() );
+   }
+
+   inline bidir_traits::vertices_size_type num_vertices( const bidirectional_graph& g ) {
+      return boost::num_vertices( g.get_graph() );
+   }
+
+   inline bidir_traits::vertex_descriptor 
+   source( bidir_traits::edge_descriptor e, const bidirectional_graph& g ) {
+      return e.first;
+   }
+
+   inline bidir_traits::vertex_descriptor 
+   target( bidir_traits::edge_descriptor e, const bidirectional_graph& g ) {
+      return e.second;
+   }
+
+   inline std::pair< bidir_traits::edge_iterator, bidir_traits::edge_iterator >
+   edges( const bidirectional_graph& g ) {
+      return boost::edges( g.get_graph() );
+   }
+
+   inline bidir_traits::edges_size_type num_edges( const bidirectional_graph& g ) {
+      return boost::num_edges( g.get_graph() );
+   }
+
+   inline std::pair< bidir_traits::out_edge_iterator, bidir_traits::out_edge_iterator >
+   out_edges( const bidir_traits::vertex_descriptor& v, const bidirectional_graph& g ) {
+      return boost::out_edges( v, g.get_graph() );
+   }
+
+   inline bidir_traits::degree_size_type 
+   out_degree( const bidir_traits::vertex_descriptor& v, const bidirectional_graph& g ) {
+      return g.get_graph().outdegree( v );
+   }
+
+   inline std::pair< bidir_traits::adjacency_iterator, bidir_traits::adjacency_iterator >
+   adjacent_vertices( const bidir_traits::vertex_descriptor& v, 
+                      const bidirectional_graph& g ) {
+      return g.get_graph().get_successors( v );
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /*!
+    * Required for BidirectionalGraph: the arcs into v, from the transpose.
+    */
+   inline std::pair< bidir_traits::in_edge_iterator, bidir_traits::in_edge_iterator >
+   in_edges( const bidir_traits::vertex_descriptor& v, const bidirectional_graph& g ) {
+      return std::make_pair( in_edge_iterator( v, g.get_transpose() ), 
+                             in_edge_iterator() );
+   }
+
+   inline bidir_traits::degree_size_type 
+   in_degree( const bidir_traits::vertex_descriptor& v, const bidirectional_graph& g ) {
+      return g.get_transpose().outdegree( v );
+   }
+
+   inline bidir_traits::degree_size_type 
+   degree( const bidir_traits::vertex_descriptor& v, const bidirectional_graph& g ) {
+      return out_degree( v, g ) + in_degree( v, g );
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /*!
+    * The vertex index property map, as for the graph alone.
+    */
+   inline boost::vertex_index_accessor get( boost::vertex_index_t, 
+                                            const bidirectional_graph& g ) {
+      return boost::vertex_index_accessor();
+   }
+}}}
+
+#endif
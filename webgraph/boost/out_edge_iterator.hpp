@@ -33,26 +33,23 @@ namespace webgraph { namespace bv_graph { namespace boost_integration {
    private:
       vertex_descriptor v;
       webgraph::bv_graph::graph::successor_iterator s, s_end;
-      edge_descriptor cur_edge;
 
    public:
       out_edge_iterator( const vertex_descriptor& v,
-                         const webgraph::bv_graph::graph& g ) {
+                         const webgraph::bv_graph::graph& g ) : v( v ) {
          boost::tie( s, s_end ) = g.get_successors( v );
-         cur_edge = make_pair( v, *s );
       }
 
-      out_edge_iterator() {}
+      out_edge_iterator() : v( 0 ) {}
 
       friend class boost::iterator_core_access;
    private:
       void increment() {
          ++s;
-         cur_edge = make_pair( v, *s );
       }
 
       edge_descriptor dereference() const {
-         return cur_edge;
+         return make_pair( v, *s );
       }
       
       bool equal( const out_edge_iterator& other ) const {
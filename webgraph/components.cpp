@@ -0,0 +1,639 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "components.hpp"
+#include "bfs.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+
+namespace webgraph { namespace components {
+
+using namespace std;
+
+namespace {
+
+/*!
+ * Replaces each label, which is a node of the component it labels, with the number of the
+ * component, in the order of the smallest nodes of the components, and fills sizes.
+ */
+void renumber( vector<int>& label, vector<long>& sizes ) {
+   const long n = label.size();
+   vector<int> id( n, -1 );
+
+   sizes.clear();
+
+   for( long x = 0; x < n; x++ ) {
+      int& c = id[ label[x] ];
+
+      if( c == -1 ) {
+         c = sizes.size();
+         sizes.push_back( 0 );
+      }
+
+      label[x] = c;
+      sizes[c]++;
+   }
+}
+
+/*!
+ * A union-find forest that threads may update concurrently. Each root is linked to the
+ * smaller of the two roots being merged, so the root of a tree is always its smallest node
+ * and links never form cycles.
+ */
+class concurrent_forest {
+private:
+   vector<int> parent;
+
+public:
+   concurrent_forest( long n ) : parent( n ) {
+      for( long x = 0; x < n; x++ ) 
+         parent[x] = x;
+   }
+
+   /** Returns the root of x, making every other node on the way point to its grandparent.
+    * A failed update only means that another thread shortened the path first. */
+   int find( int x ) {
+      for( ;; ) {
+         const int p = parent[x];
+
+         if( p == x )
+            return x;
+
+         const int gp = parent[p];
+
+         if( p != gp )
+            __sync_bool_compare_and_swap( &parent[x], p, gp );
+
+         x = p;
+      }
+   }
+
+   /** Merges the trees of x and y. Linking fails if the larger root got a parent in the
+    * meantime, in which case we start again from the new roots. */
+   void unite( int x, int y ) {
+      for( ;; ) {
+         x = find( x );
+         y = find( y );
+
+         if( x == y )
+            return;
+
+         if( x < y )
+            swap( x, y );
+
+         if( __sync_bool_compare_and_swap( &parent[x], x, y ) )
+            return;
+      }
+   }
+};
+
+/*!
+ * State shared by the threads of weakly_connected(), which claim chunks of nodes.
+ */
+struct union_job {
+   const bv_graph::graph* g;
+   concurrent_forest* forest;
+   parallel::chunks nodes;
+
+   /** Merges the endpoints of the arcs out of each chunk. */
+   void scan() {
+      vector<unsigned int> succ;
+      long from, to;
+
+      while( nodes.claim( from, to ) ) {
+         bv_graph::graph::node_iterator i, end;
+         long x = from;
+
+         for( boost::tie( i, end ) = g->get_node_iterator( from ); x < to; ++i, ++x ) {
+            int d = bv_graph::successor_array( i, succ );
+
+            for( int j = 0; j < d; j++ ) 
+               forest->unite( x, succ[j] );
+         }
+      }
+   }
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long weakly_connected( const bv_graph::graph& g, vector<int>& component, 
+                       vector<long>& sizes, int threads, ostream* log ) {
+   const long n = g.get_num_nodes();
+
+   threads = parallel::scan_threads( g, threads );
+
+   concurrent_forest forest( n );
+
+   union_job job;
+   job.g = &g;
+   job.forest = &forest;
+   job.nodes.reset( n, threads );
+
+   if( log != NULL )
+      *log << "Merging arcs (" << threads << " threads)...\n";
+
+   parallel::run( threads, &job, &union_job::scan );
+
+   component.resize( n );
+
+   for( long x = 0; x < n; x++ ) 
+      component[x] = forest.find( x );
+
+   renumber( component, sizes );
+
+   if( log != NULL )
+      *log << sizes.size() << " weakly connected components.\n";
+
+   return sizes.size();
+}
+
+namespace {
+
+/// The number of times, on average, each node left may be queued by a coloring round of
+/// the parallel strongly_connected() before it gives up.
+const long PROPAGATION_BUDGET = 16;
+
+/// A node on the depth-first stack of strongly_connected(), and the part of its list,
+/// kept in an arena shared by the whole stack, that is still to be visited.
+struct frame {
+   int x;
+   long begin;
+   long next;
+   long end;
+};
+
+/*!
+ * Tarjan's algorithm, restricted to the nodes x with component[x] == -1: the others, and
+ * their arcs, are ignored. Each component found is labelled by its root.
+ */
+void tarjan( const bv_graph::graph& g, vector<int>& component ) {
+   const long n = g.get_num_nodes();
+
+   // component[x] is -1 until x is in a component; until then, x is on the Tarjan stack
+   // if it has an index. Nodes already in a component count as visited.
+   vector<int> index( n, -1 ), low( n );
+   vector<int> stack;
+   vector<frame> frames;
+   vector<int> arena;
+   bfs::accessor a( g );
+   int next_index = 0;
+
+   for( long x = 0; x < n; x++ ) 
+      if( component[x] != -1 ) 
+         index[x] = 0;
+
+   for( long root = 0; root < n; root++ ) {
+      if( index[ root ] != -1 )
+         continue;
+
+      int x = root;
+
+      for( ;; ) {
+         // Enter x.
+         index[x] = low[x] = next_index++;
+         stack.push_back( x );
+
+         const int* s, *end;
+         boost::tie( s, end ) = a.successors( x );
+
+         const long begin = arena.size();
+         frame f = { x, begin, begin, begin + ( end - s ) };
+         arena.insert( arena.end(), s, end );
+         frames.push_back( f );
+
+         // Go on from the top frame until a new node is found, or the stack is empty.
+         x = -1;
+
+         while( !frames.empty() && x == -1 ) {
+            frame& top = frames.back();
+
+            if( top.next < top.end ) {
+               const int y = arena[ top.next++ ];
+
+               if( index[y] == -1 ) 
+                  x = y;
+               else if( component[y] == -1 ) 
+                  low[ top.x ] = min( low[ top.x ], index[y] );
+
+               continue;
+            }
+
+            const int v = top.x;
+
+            arena.resize( top.begin );
+            frames.pop_back();
+
+            if( low[v] == index[v] ) {
+               int y;
+
+               do {
+                  y = stack.back();
+                  stack.pop_back();
+                  component[y] = v;
+               } while( y != v );
+            }
+
+            if( !frames.empty() )
+               low[ frames.back().x ] = min( low[ frames.back().x ], low[v] );
+         }
+
+         if( x == -1 )
+            break;
+      }
+   }
+}
+
+/*!
+ * State shared by the threads of a sweep of the parallel strongly_connected(): a visit of
+ * g or of its transpose, level by level, restricted to the nodes not yet in a component.
+ * Frontier chunks are claimed through work; the nodes a chunk adds to the next frontier go
+ * to its own slot of found. Trimming also reads the reverse of h, and keeps the number of
+ * predecessors and successors of each node among the nodes left in in_left and out_left.
+ */
+struct sweep_job {
+   const bv_graph::graph* h;
+   const bv_graph::graph* reverse;
+   int* component;
+   int* color;
+   int* queued;
+   int* in_left;
+   int* out_left;
+
+   const vector<int>* frontier;
+   parallel::chunks work;
+
+   vector< vector<int> > found;
+
+   /** Gives the color of the frontier to the nodes it reaches that do not have it yet. */
+   void forward() {
+      bfs::accessor a( *h );
+      long c, from, to;
+
+      while( work.claim( c, from, to ) ) 
+         for( long k = from; k < to; k++ ) {
+            const int x = (*frontier)[k];
+            const int* s, *end;
+
+            for( boost::tie( s, end ) = a.successors( x ); s != end; ++s ) {
+               const int y = *s, old = color[y];
+
+               if( component[y] == -1 && old != color[x] &&
+                   __sync_bool_compare_and_swap( color + y, old, color[x] ) ) 
+                  found[c].push_back( y );
+            }
+         }
+   }
+
+   /** Raises the color of the successors of the frontier to that of their predecessor,
+    * queueing each raised node once. */
+   void propagate() {
+      bfs::accessor a( *h );
+      long c, from, to;
+
+      while( work.claim( c, from, to ) ) 
+         for( long k = from; k < to; k++ ) {
+            const int x = (*frontier)[k];
+            const int* s, *end;
+
+            for( boost::tie( s, end ) = a.successors( x ); s != end; ++s ) {
+               const int y = *s;
+
+               if( component[y] != -1 )
+                  continue;
+
+               for( ;; ) {
+                  const int old = color[y], v = color[x];
+
+                  if( old >= v )
+                     break;
+
+                  if( __sync_bool_compare_and_swap( color + y, old, v ) ) {
+                     if( __sync_bool_compare_and_swap( queued + y, 0, 1 ) )
+                        found[c].push_back( y );
+                     break;
+                  }
+               }
+            }
+         }
+   }
+
+   /** Puts in the component of each node of the frontier the predecessors of the same
+    * color (h is the transpose). */
+   void backward() {
+      bfs::accessor a( *h );
+      long c, from, to;
+
+      while( work.claim( c, from, to ) ) 
+         for( long k = from; k < to; k++ ) {
+            const int x = (*frontier)[k];
+            const int* s, *end;
+
+            for( boost::tie( s, end ) = a.successors( x ); s != end; ++s ) {
+               const int y = *s;
+
+               if( component[y] == -1 && color[y] == color[x] &&
+                   __sync_bool_compare_and_swap( component + y, -1, component[x] ) ) 
+                  found[c].push_back( y );
+            }
+         }
+   }
+
+   /** Counts the predecessors and successors of the frontier among the nodes left, loops
+    * excluded. Nothing is added to the frontier. */
+   void count_left() {
+      bfs::accessor a( *h ), b( *reverse );
+      long c, from, to;
+
+      while( work.claim( c, from, to ) ) 
+         for( long k = from; k < to; k++ ) {
+            const int x = (*frontier)[k];
+            const int* s, *end;
+
+            out_left[x] = in_left[x] = 0;
+
+            for( boost::tie( s, end ) = a.successors( x ); s != end; ++s ) 
+               out_left[x] += *s != x && component[ *s ] == -1;
+
+            for( boost::tie( s, end ) = b.successors( x ); s != end; ++s ) 
+               in_left[x] += *s != x && component[ *s ] == -1;
+         }
+   }
+
+   /** Removes the frontier, just set apart, from the counts of its neighbours, and sets
+    * apart those left with no predecessor or no successor. */
+   void trim() {
+      bfs::accessor a( *h ), b( *reverse );
+      long c, from, to;
+
+      while( work.claim( c, from, to ) ) 
+         for( long k = from; k < to; k++ ) {
+            const int x = (*frontier)[k];
+            const int* s, *end;
+
+            for( boost::tie( s, end ) = a.successors( x ); s != end; ++s ) 
+               if( *s != x && component[ *s ] == -1 && 
+                   __sync_sub_and_fetch( in_left + *s, 1 ) == 0 &&
+                   __sync_bool_compare_and_swap( component + *s, -1, *s ) ) 
+                  found[c].push_back( *s );
+
+            for( boost::tie( s, end ) = b.successors( x ); s != end; ++s ) 
+               if( *s != x && component[ *s ] == -1 && 
+                   __sync_sub_and_fetch( out_left + *s, 1 ) == 0 &&
+                   __sync_bool_compare_and_swap( component + *s, -1, *s ) ) 
+                  found[c].push_back( *s );
+         }
+   }
+
+   /** Runs what on h until the frontier is empty, with the given number of threads.
+    * Returns false, leaving the sweep unfinished, if the frontiers add up to more than
+    * budget nodes (no limit if budget is negative). */
+   bool run( const bv_graph::graph& h, vector<int>& f, int threads, 
+             void (sweep_job::*what)(), long budget = -1 ) {
+      this->h = &h;
+      frontier = &f;
+
+      while( !f.empty() ) {
+         if( budget >= 0 && ( budget -= f.size() ) < 0 ) {
+            if( queued != NULL )
+               for( size_t k = 0; k < f.size(); k++ ) 
+                  queued[ f[k] ] = 0;
+
+            f.clear();
+            return false;
+         }
+
+
+         // Starting threads costs more than visiting a few nodes, and long paths make for
+         // many tiny frontiers.
+         const int t = f.size() < 1024 ? 1 : threads;
+
+         work.reset( f.size(), t, 64 );
+
+         found.resize( work.count() );
+         for( size_t c = 0; c < found.size(); c++ ) 
+            found[c].clear();
+
+         parallel::run( t, this, what );
+
+         f.clear();
+
+         for( size_t c = 0; c < found.size(); c++ ) 
+            f.insert( f.end(), found[c].begin(), found[c].end() );
+
+         if( queued != NULL )
+            for( size_t k = 0; k < f.size(); k++ ) 
+               queued[ f[k] ] = 0;
+      }
+
+      return true;
+   }
+};
+
+}
+
+/*!
+ * Sets apart, as components of their own, the nodes left with no predecessor or no
+ * successor among the nodes left, then the nodes left so by their removal, and so on, in
+ * time linear in the size of the part of the graph that is left. Returns the number of
+ * nodes still left.
+ */
+long trim( sweep_job& job, const bv_graph::graph& g, const bv_graph::graph& transpose, 
+           vector<int>& component, int threads ) {
+   const long n = component.size();
+   int* queued = job.queued;
+   vector<int> left, frontier;
+
+   for( long x = 0; x < n; x++ ) 
+      if( component[x] == -1 ) 
+         left.push_back( x );
+
+   job.queued = NULL;
+   job.reverse = &transpose;
+
+   frontier = left;
+   job.run( g, frontier, threads, &sweep_job::count_left );
+
+   for( size_t k = 0; k < left.size(); k++ ) {
+      const int x = left[k];
+
+      if( job.in_left[x] == 0 || job.out_left[x] == 0 ) {
+         component[x] = x;
+         frontier.push_back( x );
+      }
+   }
+
+   job.run( g, frontier, threads, &sweep_job::trim );
+   job.queued = queued;
+
+   long k = 0;
+
+   for( size_t j = 0; j < left.size(); j++ ) 
+      k += component[ left[j] ] == -1;
+
+   return k;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long strongly_connected( const bv_graph::graph& g, vector<int>& component, 
+                         vector<long>& sizes, ostream* log ) {
+   assert( g.get_offset_step() > 0 || g.is_decompressed() );
+
+   component.assign( g.get_num_nodes(), -1 );
+   tarjan( g, component );
+
+   renumber( component, sizes );
+
+   if( log != NULL )
+      *log << sizes.size() << " strongly connected components.\n";
+
+   return sizes.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long strongly_connected( const bv_graph::graph& g, const bv_graph::graph& transpose, 
+                         vector<int>& component, vector<long>& sizes, int threads, 
+                         ostream* log, long sequential_nodes ) {
+   const long n = g.get_num_nodes();
+
+   assert( transpose.get_num_nodes() == n );
+   assert( g.get_offset_step() > 0 || g.is_decompressed() );
+   assert( transpose.get_offset_step() > 0 || transpose.is_decompressed() );
+
+   threads = parallel::random_access_threads( transpose, 
+                                              parallel::random_access_threads( g, threads ) );
+
+   // Until the end, component[x] is a node of the component of x, or -1.
+   vector<int> color( n, -1 ), queued( n ), in_left( n ), out_left( n );
+   vector<int> frontier;
+
+   component.assign( n, -1 );
+
+   sweep_job job;
+   job.component = &component[0];
+   job.color = &color[0];
+   job.queued = NULL;
+   job.in_left = &in_left[0];
+   job.out_left = &out_left[0];
+
+   long left = trim( job, g, transpose, component, threads );
+   long pivot = -1;
+   double best = -1;
+
+   for( long x = 0; x < n; x++ ) {
+      const double d = double( g.outdegree( x ) ) * transpose.outdegree( x );
+
+      if( component[x] == -1 && d > best ) {
+         best = d;
+         pivot = x;
+      }
+   }
+
+   if( log != NULL )
+      *log << n - left << " nodes trimmed\n";
+
+   if( pivot != -1 ) {
+      if( log != NULL )
+         *log << "Forward-backward from node " << pivot << " (" << threads 
+              << " threads)...\n";
+
+      color[ pivot ] = pivot;
+      frontier.assign( 1, pivot );
+      job.run( g, frontier, threads, &sweep_job::forward );
+
+      component[ pivot ] = pivot;
+      frontier.assign( 1, pivot );
+      job.run( transpose, frontier, threads, &sweep_job::backward );
+   }
+
+   job.queued = &queued[0];
+
+   bool slow = false;
+
+   for( int round = 1; ; round++ ) {
+      left = trim( job, g, transpose, component, threads );
+
+      if( left == 0 )
+         break;
+
+      // Each round costs a pass over all nodes, and may settle a single component.
+      if( left < sequential_nodes || slow ) {
+         if( log != NULL )
+            *log << "Tarjan's algorithm on the last " << left << " nodes\n";
+
+         tarjan( g, component );
+         break;
+      }
+
+      frontier.clear();
+
+      for( long x = 0; x < n; x++ ) 
+         if( component[x] == -1 ) {
+            color[x] = x;
+            frontier.push_back( x );
+         }
+
+      if( log != NULL )
+         *log << "Coloring round " << round << ": " << frontier.size() << " nodes left\n";
+
+      // A color may have to travel the whole of a long path, raising on its way nodes
+      // already raised by smaller colors; past the budget Tarjan's algorithm is cheaper.
+      if( !job.run( g, frontier, threads, &sweep_job::propagate, PROPAGATION_BUDGET * left ) ) {
+         if( log != NULL )
+            *log << "Coloring too slow; Tarjan's algorithm on the last " << left 
+                 << " nodes\n";
+
+         tarjan( g, component );
+         break;
+      }
+
+      for( long x = 0; x < n; x++ ) 
+         if( component[x] == -1 && color[x] == x ) {
+            component[x] = x;
+            frontier.push_back( x );
+         }
+
+      job.run( transpose, frontier, threads, &sweep_job::backward );
+
+      long still_left = 0;
+
+      for( long x = 0; x < n; x++ ) 
+         still_left += component[x] == -1;
+
+      slow = left - still_left < left / 16;
+   }
+
+   renumber( component, sizes );
+
+   if( log != NULL )
+      *log << sizes.size() << " strongly connected components.\n";
+
+   return sizes.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void size_distribution( const vector<long>& sizes, map<long, long>& count ) {
+   count.clear();
+
+   for( vector<long>::const_iterator s = sizes.begin(); s != sizes.end(); ++s ) 
+      count[ *s ]++;
+}
+
+} }
@@ -0,0 +1,103 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef COMPONENTS_HPP_
+#define COMPONENTS_HPP_
+
+#include <vector>
+#include <map>
+#include <iostream>
+
+#include "webgraph.hpp"
+
+/*!
+ * Connected components of compressed graphs.
+ *
+ * Components are numbered from 0 in the order of their smallest node, so the numbering
+ * does not depend on the number of threads.
+ */
+namespace webgraph { namespace components {
+
+/// The number of nodes left below which the parallel strongly_connected() goes on
+/// sequentially.
+const long SEQUENTIAL_NODES = 1 << 14;
+
+/*!
+ * Computes the weakly connected components of g (the components of g with arcs taken as
+ * undirected) with a single sequential scan, merging the endpoints of each arc in a
+ * union-find forest. Neither random access nor the transpose is needed, so g may be loaded
+ * with graph::load_sequential() or graph::load_offline().
+ *
+ * If g was loaded with all offsets (graph::load), the scan is split into ranges of nodes,
+ * each decoded by one of the given number of threads; the threads share the forest, which
+ * is updated without locks: roots are linked to the smaller of the two, by
+ * compare-and-swap, and finds halve the paths they follow.
+ *
+ * On return component[x] is the component of x and sizes[c] the number of nodes in
+ * component c. Returns the number of components.
+ */
+long weakly_connected( const bv_graph::graph& g, std::vector<int>& component, 
+                       std::vector<long>& sizes, int threads = 1, 
+                       std::ostream* log = NULL );
+
+/*!
+ * Computes the strongly connected components of g with Tarjan's algorithm, visiting g
+ * depth-first with an explicit stack, so that long paths need no deep recursion. The
+ * lists of the nodes on the stack are kept decoded, which takes at most 4 bytes per arc.
+ * g needs random access: it must be loaded with offsets or decompressed (see
+ * graph::load_decompressed), which is much faster.
+ *
+ * On return component[x] is the component of x and sizes[c] the number of nodes in
+ * component c. Returns the number of components.
+ */
+long strongly_connected( const bv_graph::graph& g, std::vector<int>& component, 
+                         std::vector<long>& sizes, std::ostream* log = NULL );
+
+/*!
+ * Computes the strongly connected components of g, given its transpose, with the given
+ * number of threads. Both graphs need random access, as above, and all offsets (or to be
+ * decompressed) for more than one thread.
+ *
+ * Nodes without predecessors or successors are first set apart, as components of their
+ * own, and so are, in turn, the nodes that have none among the nodes left (trimming), so
+ * that chains are removed in linear time. The component of the node with the largest
+ * product of degrees, usually the giant component of a crawl, is found next as the
+ * intersection of the nodes reachable from it and of those reaching it. The rest is split
+ * by coloring (Orzan, 2004): every node takes the largest color among the nodes reaching
+ * it, by parallel propagation; each node whose color is its own is then the root of a
+ * component, made of the nodes of its color that reach it. Trimming and coloring are
+ * repeated on the nodes left. As a round may settle a single component, and costs a pass
+ * over all nodes, the nodes left are handed to Tarjan's algorithm once there are fewer
+ * than sequential_nodes of them, once a round settles less than a sixteenth of them, or
+ * once propagation queues more than a few times as many nodes as are left, as colors
+ * travelling down a long path do.
+ *
+ * Components are numbered as by the other version.
+ */
+long strongly_connected( const bv_graph::graph& g, const bv_graph::graph& transpose, 
+                         std::vector<int>& component, std::vector<long>& sizes, 
+                         int threads = 1, std::ostream* log = NULL, 
+                         long sequential_nodes = SEQUENTIAL_NODES );
+
+/** Fills count with the number of components of each size. */
+void size_distribution( const std::vector<long>& sizes, std::map<long, long>& count );
+
+} }
+
+#endif /*COMPONENTS_HPP_*/
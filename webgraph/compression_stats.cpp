@@ -0,0 +1,167 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+
+#include "compression_stats.hpp"
+#include "../utils/fast.hpp"
+
+namespace webgraph { namespace bv_graph {
+
+using namespace std;
+
+compression_stats::compression_stats() {
+   for( int c = 0; c < NUM_COMPONENTS; c++ ) 
+      histogram[c].resize( NUM_BUCKETS );
+   
+   clear();
+}
+
+void compression_stats::clear() {
+   for( int c = 0; c < NUM_COMPONENTS; c++ ) {
+      count[c] = bits_for[c] = sum[c] = 0;
+      fill( histogram[c].begin(), histogram[c].end(), 0 );
+   }
+}
+
+void compression_stats::merge( const compression_stats& other ) {
+   for( int c = 0; c < NUM_COMPONENTS; c++ ) {
+      count[c] += other.count[c];
+      bits_for[c] += other.bits_for[c];
+      sum[c] += other.sum[c];
+
+      for( int b = 0; b < NUM_BUCKETS; b++ ) 
+         histogram[c][b] += other.histogram[c][b];
+   }
+}
+
+long long compression_stats::get_graph_bits() const {
+   long long t = 0;
+
+   for( int c = 0; c < NUM_COMPONENTS; c++ ) 
+      if( c != OFFSETS ) 
+         t += bits_for[c];
+
+   return t;
+}
+
+const char* compression_stats::component_name( component c ) {
+   static const char* names[NUM_COMPONENTS] = {
+      "outdegrees", "references", "blockcounts", "blocks", 
+      "intervalcounts", "intervals", "residuals", "offsets"
+   };
+
+   return names[c];
+}
+
+/*!
+ * Prints a table with one line per component (values coded, bits, share of the graph
+ * file, bits per value and mean value), followed by the nonempty histograms.
+ */
+void compression_stats::report( ostream& out ) const {
+   long long total = get_graph_bits();
+
+   out << setw(16) << left << "component" << right
+       << setw(14) << "values" 
+       << setw(16) << "bits" 
+       << setw(9) << "%graph"
+       << setw(12) << "bits/value" 
+       << setw(12) << "avg value" << "\n";
+
+   for( int c = 0; c < NUM_COMPONENTS; c++ ) {
+      if( count[c] == 0 ) 
+         continue;
+
+      out << setw(16) << left << component_name( component(c) ) << right
+          << setw(14) << count[c]
+          << setw(16) << bits_for[c]
+          << setw(9) << fixed << setprecision(2) 
+          << ( c == OFFSETS || total == 0 ? 0.0 : 100.0 * bits_for[c] / total )
+          << setw(12) << (double)bits_for[c] / count[c]
+          << setw(12) << (double)sum[c] / count[c] << "\n";
+   }
+
+   out << setw(16) << left << "total" << right << setw(30) << total << "\n";
+
+   for( int c = 0; c < NUM_COMPONENTS; c++ ) {
+      if( count[c] == 0 ) 
+         continue;
+
+      out << "\n" << component_name( component(c) ) << " (log2 histogram):\n";
+
+      int last = NUM_BUCKETS - 1;
+      while( last > 0 && histogram[c][last] == 0 ) 
+         last--;
+
+      for( int b = 0; b <= last; b++ ) {
+         long lo = ( 1L << b ) - 1, hi = ( 1L << ( b + 1 ) ) - 2;
+
+         out << "  [" << setw(10) << lo << ", " << setw(10) << hi << "] "
+             << setw(14) << histogram[c][b]
+             << setw(9) << setprecision(2) << 100.0 * histogram[c][b] / count[c] << "%\n";
+      }
+   }
+
+   out.unsetf( ios::fixed );
+}
+
+/*!
+ * Stores the number of values of each component (numberof<component>), the bits spent
+ * on them (bitsfor<component>) and the bits per value (avgbitsfor<component>) in a
+ * property set.
+ */
+void compression_stats::set_properties( properties& props ) const {
+   for( int c = 0; c < NUM_COMPONENTS; c++ ) {
+      string name = component_name( component(c) );
+
+      props.set_property( "numberof" + name, utils::to_string( count[c] ) );
+      props.set_property( "bitsfor" + name, utils::to_string( bits_for[c] ) );
+      props.set_property( "avgbitsfor" + name, 
+                          utils::to_string( count[c] == 0 ? 0.0 : (double)bits_for[c] / count[c] ) );
+   }
+}
+
+/*!
+ * Adds the counts and bits stored by set_properties() in a property set, such as the
+ * one of a graph that is being extended. Histograms and value sums are not stored, so
+ * they are left alone.
+ *
+ * @return false (and nothing is added) if the properties lack some component.
+ */
+bool compression_stats::merge_properties( const properties& props ) {
+   for( int c = 0; c < NUM_COMPONENTS; c++ ) {
+      string name = component_name( component(c) );
+
+      if( !props.has_property( "numberof" + name ) || !props.has_property( "bitsfor" + name ) )
+         return false;
+   }
+
+   for( int c = 0; c < NUM_COMPONENTS; c++ ) {
+      string name = component_name( component(c) );
+
+      count[c] += atoll( props.get_property( "numberof" + name ).c_str() );
+      bits_for[c] += atoll( props.get_property( "bitsfor" + name ).c_str() );
+   }
+
+   return true;
+}
+
+} }
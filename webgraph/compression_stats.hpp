@@ -0,0 +1,101 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef COMPRESSION_STATS_HPP_
+#define COMPRESSION_STATS_HPP_
+
+#include <vector>
+#include <iostream>
+
+#include "../properties/properties.hpp"
+
+namespace webgraph { namespace bv_graph {
+
+/*!
+ * Collects, for each component of the BV format, how many values were coded, how many
+ * bits they took and a histogram of their magnitudes. This replaces the STATS print
+ * writers of the Java version, which dumped every single value to a file.
+ *
+ * Bucket i of a histogram counts the values v with floor(log2(v + 1)) == i, i.e. bucket
+ * 0 holds the zeroes, bucket 1 holds 1 and 2, bucket 2 holds 3 to 6, and so on. The
+ * values recorded are the ones actually written (after gap and int2nat transformations),
+ * so the histograms tell directly which code would suit each component.
+ *
+ * graph::store fills one of these while compressing, and graph::scan_stats fills one by
+ * reading an existing graph.
+ */
+class compression_stats {
+public:
+   enum component {
+      OUTDEGREES,
+      REFERENCES,
+      BLOCK_COUNTS,
+      BLOCKS,
+      INTERVAL_COUNTS,
+      INTERVALS,      // left extremes and lengths
+      RESIDUALS,
+      OFFSETS,        // only recorded while compressing
+      NUM_COMPONENTS
+   };
+
+   static const int NUM_BUCKETS = 33;
+
+   compression_stats();
+
+   void clear();
+   void merge( const compression_stats& other );
+
+   /** Records a value of component c which took the given number of bits. */
+   void add( component c, int value, int bits ) {
+      unsigned long v = (unsigned long)value + 1;
+      int b = 0;
+
+      while( v >>= 1 ) 
+         b++;
+
+      count[c]++;
+      bits_for[c] += bits;
+      sum[c] += value;
+      histogram[c][b]++;
+   }
+
+   long long get_count( component c ) const { return count[c]; }
+   long long get_bits( component c ) const { return bits_for[c]; }
+   long long get_sum( component c ) const { return sum[c]; }
+   const std::vector<long long>& get_histogram( component c ) const { return histogram[c]; }
+
+   /** Total bits of the graph file, i.e. of every component but the offsets. */
+   long long get_graph_bits() const;
+
+   static const char* component_name( component c );
+
+   void report( std::ostream& out ) const;
+   void set_properties( properties& props ) const;
+   bool merge_properties( const properties& props );
+
+private:
+   long long count[NUM_COMPONENTS];
+   long long bits_for[NUM_COMPONENTS];
+   long long sum[NUM_COMPONENTS];
+   std::vector<long long> histogram[NUM_COMPONENTS];
+};
+
+} }
+
+#endif
@@ -0,0 +1,390 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "cores.hpp"
+#include "bfs.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+
+namespace webgraph { namespace cores {
+
+using namespace std;
+
+namespace {
+
+/*!
+ * Calls f( y ) once for each y other than x in either of the sorted lists [a, a_end) and
+ * [b, b_end): a node that is both a successor and a predecessor of x is a single
+ * neighbour in the symmetrized graph.
+ */
+template<class iterator_type, class function_type>
+void for_each_merged( int x, iterator_type a, iterator_type a_end, 
+                      iterator_type b, iterator_type b_end, function_type& f ) {
+   while( a != a_end || b != b_end ) {
+      int y;
+
+      if( b == b_end || ( a != a_end && *a < *b ) ) 
+         y = *a++;
+      else if( a == a_end || *b < *a ) 
+         y = *b++;
+      else {
+         y = *a++;
+         b++;
+      }
+
+      if( y != x )
+         f( y );
+   }
+}
+
+struct counter {
+   int count;
+
+   void operator()( int ) {
+      count++;
+   }
+};
+
+/** Fills degree with the degrees of the given type, in one sequential scan of g, and of
+ * the transpose too for the symmetrized graph. */
+void initial_degrees( const bv_graph::graph& g, const bv_graph::graph* transpose, 
+                      degree_type type, vector<int>& degree ) {
+   const long n = g.get_num_nodes();
+   vector<unsigned int> succ, pred;
+   bv_graph::graph::node_iterator i, end, ti, tend;
+   long x = 0;
+
+   degree.assign( n, 0 );
+
+   if( type == ALL ) {
+      boost::tie( ti, tend ) = transpose->get_node_iterator( 0 );
+
+      for( boost::tie( i, end ) = g.get_node_iterator( 0 ); x < n; ++i, ++ti, ++x ) {
+         const int d = bv_graph::successor_array( i, succ );
+         const int e = bv_graph::successor_array( ti, pred );
+         counter c = { 0 };
+
+         for_each_merged( x, succ.begin(), succ.begin() + d, pred.begin(), pred.begin() + e,
+                          c );
+         degree[x] = c.count;
+      }
+
+      return;
+   }
+
+   for( boost::tie( i, end ) = g.get_node_iterator( 0 ); x < n; ++i, ++x ) {
+      const int d = bv_graph::successor_array( i, succ );
+
+      for( int j = 0; j < d; j++ ) {
+         if( (long)succ[j] == x )
+            continue;
+
+         if( type == OUT ) 
+            degree[x]++;
+         else
+            degree[ succ[j] ]++;
+      }
+   }
+}
+
+/*!
+ * The neighbours whose degree drops when a node is peeled: its successors for indegrees,
+ * its predecessors for outdegrees, both for the symmetrized graph. Each thread has its
+ * own.
+ */
+class neighbourhood {
+private:
+   degree_type type;
+   bfs::accessor successors;
+   bfs::accessor predecessors;
+
+public:
+   neighbourhood( const bv_graph::graph& g, const bv_graph::graph* transpose, 
+                  degree_type type ) : 
+      type( type ), successors( g ), predecessors( transpose != NULL ? *transpose : g ) {}
+
+   /** Calls f( y ) once for each neighbour y of x other than x. */
+   template<class function_type>
+   void for_each( int x, function_type& f ) {
+      const int* s = NULL, *s_end = NULL, *p = NULL, *p_end = NULL;
+
+      if( type != OUT ) 
+         boost::tie( s, s_end ) = successors.successors( x );
+      if( type != IN ) 
+         boost::tie( p, p_end ) = predecessors.successors( x );
+
+      for_each_merged( x, s, s_end, p, p_end, f );
+   }
+};
+
+/*!
+ * The bucket queue of Batagelj and Zaversnik: nodes sorted by degree in vert, with
+ * pos[x] the position of x and bin[d] that of the first node of degree d.
+ */
+struct bucket_queue {
+   vector<int>& degree;
+   vector<int> vert, pos, bin;
+   int current;
+
+   bucket_queue( vector<int>& degree ) : degree( degree ), current( 0 ) {
+      const long n = degree.size();
+      const int max_degree = n == 0 ? 0 : *max_element( degree.begin(), degree.end() );
+
+      bin.assign( max_degree + 1, 0 );
+      for( long x = 0; x < n; x++ ) 
+         bin[ degree[x] ]++;
+
+      for( int d = 0, start = 0; d <= max_degree; d++ ) {
+         const int count = bin[d];
+         bin[d] = start;
+         start += count;
+      }
+
+      vert.resize( n );
+      pos.resize( n );
+
+      for( long x = 0; x < n; x++ ) {
+         pos[x] = bin[ degree[x] ]++;
+         vert[ pos[x] ] = x;
+      }
+
+      for( int d = max_degree; d > 0; d-- ) 
+         bin[d] = bin[d - 1];
+      bin[0] = 0;
+   }
+
+   /** Lowers the degree of y, a neighbour of the node being peeled, if it is larger. */
+   void operator()( int y ) {
+      const int d = degree[y];
+
+      if( d <= degree[ current ] )
+         return;
+
+      // Swap y with the first node of its bin, which then starts one later.
+      const int py = pos[y], pw = bin[d], w = vert[pw];
+
+      if( y != w ) {
+         pos[y] = pw;
+         vert[py] = w;
+         pos[w] = py;
+         vert[pw] = y;
+      }
+
+      bin[d]++;
+      degree[y]--;
+   }
+};
+
+/*!
+ * State shared by the threads of a step of decompose_parallel(). Items (remaining nodes,
+ * or nodes to peel) are handed out in chunks, claimed through work; the nodes a chunk
+ * finds go to its own slot of found.
+ */
+struct peel_job {
+   const bv_graph::graph* g;
+   const bv_graph::graph* t;
+   degree_type type;
+
+   int* degree;
+   int* core;
+   int level;
+
+   const vector<int>* items;
+   parallel::chunks work;
+
+   vector< vector<int> > found;
+
+   /** Finds the remaining nodes of the current level. */
+   void select() {
+      long c, from, to;
+
+      while( work.claim( c, from, to ) ) 
+         for( long k = from; k < to; k++ ) 
+            if( degree[ (*items)[k] ] <= level ) 
+               found[c].push_back( (*items)[k] );
+   }
+
+   /// Lowers the degrees of the neighbours of a peeled node, down to the level, and
+   /// collects those that reach it.
+   struct lower {
+      int* degree;
+      int level;
+      vector<int>* found;
+
+      void operator()( int y ) {
+         if( degree[y] <= level )
+            return;
+
+         const int old = __sync_fetch_and_sub( degree + y, 1 );
+
+         if( old == level + 1 ) 
+            found->push_back( y );
+         else if( old <= level ) 
+            __sync_fetch_and_add( degree + y, 1 );
+      }
+   };
+
+   /** Peels the nodes of the chunk. */
+   void peel() {
+      neighbourhood nb( *g, t, type );
+      long c, from, to;
+
+      while( work.claim( c, from, to ) ) {
+         lower f = { degree, level, &found[c] };
+
+         for( long k = from; k < to; k++ ) {
+            const int x = (*items)[k];
+
+            core[x] = level;
+            nb.for_each( x, f );
+         }
+      }
+   }
+
+   /** Runs what over the given items, with the given number of threads unless there are
+    * too few items to make starting them worthwhile, and gathers what was found. */
+   void run( int threads, const vector<int>& items, void (peel_job::*what)(), 
+             vector<int>& result ) {
+      if( items.size() < 1024 )
+         threads = 1;
+
+      this->items = &items;
+      work.reset( items.size(), threads, 64 );
+
+      found.resize( work.count() );
+      for( size_t c = 0; c < found.size(); c++ ) 
+         found[c].clear();
+
+      parallel::run( threads, this, what );
+
+      result.clear();
+
+      for( size_t c = 0; c < found.size(); c++ ) 
+         result.insert( result.end(), found[c].begin(), found[c].end() );
+   }
+};
+
+/** Checks that g and the transpose can be used to compute cores of the given type. */
+void check( const bv_graph::graph& g, const bv_graph::graph* transpose, degree_type type ) {
+   assert( g.get_offset_step() > 0 || g.is_decompressed() );
+   assert( type == IN || transpose != NULL );
+   assert( transpose == NULL || transpose->get_num_nodes() == g.get_num_nodes() );
+   assert( transpose == NULL || transpose->get_offset_step() > 0 || 
+           transpose->is_decompressed() );
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int decompose( const bv_graph::graph& g, const bv_graph::graph* transpose, degree_type type,
+               vector<int>& core, ostream* log ) {
+   const long n = g.get_num_nodes();
+
+   check( g, transpose, type );
+
+   if( log != NULL )
+      *log << "Computing degrees...\n";
+
+   initial_degrees( g, transpose, type, core );
+
+   if( log != NULL )
+      *log << "Peeling...\n";
+
+   // Degrees become core numbers as nodes are peeled.
+   bucket_queue q( core );
+   neighbourhood nb( g, transpose, type );
+   int max_core = 0;
+
+   for( long i = 0; i < n; i++ ) {
+      q.current = q.vert[i];
+      nb.for_each( q.current, q );
+      max_core = max( max_core, core[ q.current ] );
+   }
+
+   if( log != NULL )
+      *log << "Largest core number: " << max_core << "\n";
+
+   return max_core;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int decompose_parallel( const bv_graph::graph& g, const bv_graph::graph* transpose, 
+                        degree_type type, vector<int>& core, int threads, ostream* log ) {
+   const long n = g.get_num_nodes();
+
+   check( g, transpose, type );
+
+   threads = parallel::random_access_threads( g, threads );
+
+   if( transpose != NULL ) 
+      threads = parallel::random_access_threads( *transpose, threads );
+
+   if( log != NULL )
+      *log << "Computing degrees...\n";
+
+   vector<int> degree;
+   initial_degrees( g, transpose, type, degree );
+
+   core.assign( n, -1 );
+
+   peel_job job;
+   job.g = &g;
+   job.t = transpose;
+   job.type = type;
+   job.degree = &degree[0];
+   job.core = &core[0];
+
+   vector<int> remaining( n ), frontier, next;
+
+   for( long x = 0; x < n; x++ ) 
+      remaining[x] = x;
+
+   int max_core = 0;
+
+   while( !remaining.empty() ) {
+      // Levels with no node left are skipped.
+      int level = degree[ remaining[0] ];
+      for( size_t k = 1; k < remaining.size(); k++ ) 
+         level = min( level, degree[ remaining[k] ] );
+
+      job.level = max_core = level;
+      job.run( threads, remaining, &peel_job::select, frontier );
+
+      if( log != NULL )
+         *log << "Level " << level << ": " << frontier.size() << " nodes to peel first, " 
+              << remaining.size() << " left (" << threads << " threads)\n";
+
+      while( !frontier.empty() ) {
+         job.run( threads, frontier, &peel_job::peel, next );
+         frontier.swap( next );
+      }
+
+      size_t k = 0;
+      for( size_t j = 0; j < remaining.size(); j++ ) 
+         if( core[ remaining[j] ] == -1 ) 
+            remaining[ k++ ] = remaining[j];
+
+      remaining.resize( k );
+   }
+
+   return max_core;
+}
+
+} }
@@ -0,0 +1,69 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef CORES_HPP_
+#define CORES_HPP_
+
+#include <vector>
+#include <iostream>
+
+#include "webgraph.hpp"
+
+/*!
+ * k-core decomposition of compressed graphs. The k-core is the largest subgraph in which
+ * every node has degree at least k, and the core number of a node the largest k such that
+ * the node is in the k-core.
+ *
+ * As in Batagelj and Zaversnik (2003), degrees can be indegrees, outdegrees, or degrees in
+ * the symmetrized graph, in which a pair of opposite arcs makes a single edge; loops are
+ * ignored. Initial degrees come from a single sequential scan of g (and of the transpose,
+ * for the symmetrized graph). Nodes are then peeled in order of degree, and the lists of
+ * each peeled node are decoded by random access: successors from g, predecessors from its
+ * transpose, merged for the symmetrized graph, which is never built. Both graphs must be
+ * loaded with offsets or decompressed; the transpose is not needed for indegree cores.
+ */
+namespace webgraph { namespace cores {
+
+enum degree_type {
+   IN,
+   OUT,
+   ALL
+};
+
+/*!
+ * Computes core numbers with the bucket queue of Batagelj and Zaversnik, in time linear in
+ * the size of the graph; on return core[x] is the core number of x. Returns the largest
+ * core number (the degeneracy of the graph).
+ */
+int decompose( const bv_graph::graph& g, const bv_graph::graph* transpose, degree_type type,
+               std::vector<int>& core, std::ostream* log = NULL );
+
+/*!
+ * Computes the same core numbers by peeling level by level, in parallel (Kabir and
+ * Madduri, 2017): for k = 0, 1, ..., the threads peel the remaining nodes of degree at
+ * most k, decrementing the degrees of their neighbours atomically, until none is left at
+ * level k. More than one thread needs all offsets (or decompressed graphs).
+ */
+int decompose_parallel( const bv_graph::graph& g, const bv_graph::graph* transpose, 
+                        degree_type type, std::vector<int>& core, int threads = 1, 
+                        std::ostream* log = NULL );
+
+} }
+
+#endif /*CORES_HPP_*/
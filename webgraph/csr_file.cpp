@@ -0,0 +1,93 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "csr_file.hpp"
+
+#include <cstring>
+
+namespace webgraph { namespace csr {
+
+using namespace std;
+
+namespace {
+   const char MAGIC[ 8 ] = { 'W', 'G', 'C', 'S', 'R', 0, 0, 0 };
+
+   boost::uint64_t read_le( const char* p, int bytes ) {
+      boost::uint64_t v = 0;
+
+      for( int b = bytes - 1; b >= 0; b-- ) 
+         v = ( v << 8 ) | (unsigned char)p[b];
+
+      return v;
+   }
+
+   bool little_endian_host() {
+      const boost::uint32_t one = 1;
+      return *reinterpret_cast<const unsigned char*>( &one ) == 1;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void detail::write_header( ostream& out, int target_bytes, long n, long arcs ) {
+   le_writer w( out );
+
+   for( int i = 0; i < 8; i++ ) 
+      w.write( MAGIC[i], 1 );
+
+   w.write( VERSION, 4 );
+   w.write( target_bytes, 4 );
+   w.write( n, 8 );
+   w.write( arcs, 8 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** Maps basename.csr into memory, checking its header and size.
+ */
+boost::shared_ptr<csr_file> csr_file::load( const string& basename ) {
+   // The arrays are used as they are in the file.
+   assert( little_endian_host() );
+
+   boost::shared_ptr<csr_file> result( new csr_file );
+
+   // Views are used for random access as much as for scans.
+   result->file.reset( new ascii_graph::mapped_file( basename + ".csr", false ) );
+
+   const char* p = result->file->begin();
+   const size_t size = result->file->size();
+
+   assert( size >= HEADER_SIZE && memcmp( p, MAGIC, 8 ) == 0 );
+   assert( read_le( p + 8, 4 ) == (boost::uint64_t)VERSION );
+
+   result->target_bytes = read_le( p + 12, 4 );
+   result->n = read_le( p + 16, 8 );
+   result->arcs = read_le( p + 24, 8 );
+
+   assert( result->target_bytes == 4 || result->target_bytes == 8 );
+   assert( size == HEADER_SIZE + 8 * ( result->n + 1 ) + 
+           (size_t)result->target_bytes * result->arcs );
+
+   result->offsets = reinterpret_cast<const boost::uint64_t*>( p + HEADER_SIZE );
+   result->targets = p + HEADER_SIZE + 8 * ( result->n + 1 );
+
+   assert( result->offsets[ result->n ] == (boost::uint64_t)result->arcs );
+
+   return result;
+}
+
+} }
@@ -0,0 +1,200 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef CSR_FILE_HPP_
+#define CSR_FILE_HPP_
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cassert>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/progress.hpp>
+#include <boost/tuple/tuple.hpp>
+
+#include "csr_view.hpp"
+#include "successor_source.hpp"
+#include "../asciigraph/mapped_file.hpp"
+
+/*!
+ * A binary compressed sparse row format, meant for handing graphs to other tools and for
+ * loading them at memory speed. A file basename.csr holds, all little endian,
+ *
+ *   - a 32-byte header: the 8 magic bytes "WGCSR\0\0\0", the format version (4 bytes),
+ *     the size of a target (4 bytes: 4 or 8), the number of nodes n and the number of
+ *     arcs (8 bytes each);
+ *   - the n + 1 offsets of the lists in the target array, 8 bytes each;
+ *   - the targets, 4 or 8 bytes each, every list sorted.
+ *
+ * Offsets and targets are thus naturally aligned, so a mapping of the file is directly
+ * usable as a csr_view, with no parsing at all.
+ */
+namespace webgraph { namespace csr {
+
+const int VERSION = 0;
+const size_t HEADER_SIZE = 32;
+
+/*!
+ * A CSR file, mapped into memory. Use view32() or view64(), depending on
+ * get_target_bytes(), to access the graph; the views are valid as long as the file is.
+ * Loading requires a little-endian host.
+ */
+class csr_file : public boost::noncopyable {
+private:
+   boost::shared_ptr<ascii_graph::mapped_file> file;
+   long n, arcs;
+   int target_bytes;
+   const boost::uint64_t* offsets;
+   const void* targets;
+
+   csr_file() : n( 0 ), arcs( 0 ), target_bytes( 0 ), offsets( NULL ), targets( NULL ) {}
+
+public:
+   typedef csr_view<boost::uint64_t, boost::uint32_t> view32_type;
+   typedef csr_view<boost::uint64_t, boost::uint64_t> view64_type;
+
+   static boost::shared_ptr<csr_file> load( const std::string& basename );
+
+   long get_num_nodes() const {
+      return n;
+   }
+
+   long get_num_arcs() const {
+      return arcs;
+   }
+
+   int get_target_bytes() const {
+      return target_bytes;
+   }
+
+   view32_type view32() const {
+      assert( target_bytes == 4 );
+      return view32_type( n, offsets, static_cast<const boost::uint32_t*>( targets ) );
+   }
+
+   view64_type view64() const {
+      assert( target_bytes == 8 );
+      return view64_type( n, offsets, static_cast<const boost::uint64_t*>( targets ) );
+   }
+};
+
+namespace detail {
+   /** Buffers values on their way to a stream, little endian whatever the host. */
+   class le_writer {
+   private:
+      std::ostream& out;
+      std::vector<char> buffer;
+
+   public:
+      le_writer( std::ostream& o ) : out( o ) {
+         buffer.reserve( 1 << 16 );
+      }
+
+      ~le_writer() {
+         flush();
+      }
+
+      void write( boost::uint64_t v, int bytes ) {
+         for( int b = 0; b < bytes; b++, v >>= 8 ) 
+            buffer.push_back( (char)( v & 0xff ) );
+
+         if( buffer.size() >= ( 1 << 16 ) - 8 ) 
+            flush();
+      }
+
+      void flush() {
+         if( !buffer.empty() ) 
+            out.write( &buffer[0], buffer.size() );
+         buffer.clear();
+      }
+   };
+
+   void write_header( std::ostream& out, int target_bytes, long n, long arcs );
+}
+
+/*!
+ * Writes g, any graph with a specialization of successor_source_traits, as
+ * basename.csr with targets of the given size (4 or 8 bytes). The graph is scanned once;
+ * offsets and targets are written to their places in the file as they come, so nothing
+ * but the current list is held in memory.
+ */
+template<class source_type>
+void store( const source_type& g, const std::string& basename, int target_bytes = 4,
+            std::ostream* log = NULL ) {
+   typedef successor_source_traits<source_type> traits;
+
+   assert( target_bytes == 4 || target_bytes == 8 );
+
+   const std::string filename = basename + ".csr";
+   const long n = traits::num_nodes( g );
+
+   std::ofstream offsets_out( filename.c_str(), std::ios::binary | std::ios::trunc );
+   assert( offsets_out.good() );
+   detail::write_header( offsets_out, target_bytes, n, 0 );
+
+   // A second stream on the same file writes the targets, past the offsets.
+   std::fstream targets_out( filename.c_str(), std::ios::binary | std::ios::in | std::ios::out );
+   assert( targets_out.good() );
+   targets_out.seekp( HEADER_SIZE + 8 * ( n + 1 ) );
+
+   boost::shared_ptr<boost::progress_display> pp;
+   if( log != NULL ) {
+      *log << "Writing CSR graph...\n";
+      pp.reset( new boost::progress_display( n, *log ) );
+   }
+
+   long arcs = 0, x = 0;
+
+   {
+      detail::le_writer offsets_w( offsets_out ), targets_w( targets_out );
+      std::vector<unsigned int> succ;
+      typename traits::node_iterator i, end;
+
+      for( boost::tie( i, end ) = traits::nodes( g ); x < n && i != end; ++i, ++x ) {
+         int d = traits::successors( i, succ );
+
+         offsets_w.write( arcs, 8 );
+
+         for( int k = 0; k < d; k++ ) 
+            targets_w.write( succ[k], target_bytes );
+
+         arcs += d;
+
+         if( pp != NULL )
+            ++(*pp);
+      }
+
+      offsets_w.write( arcs, 8 );
+   }
+
+   assert( x == n );
+
+   targets_out.close();
+
+   offsets_out.seekp( 0 );
+   detail::write_header( offsets_out, target_bytes, n, arcs );
+   offsets_out.close();
+}
+
+} }
+
+#endif /*CSR_FILE_HPP_*/
@@ -0,0 +1,115 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef CSR_VIEW_HPP_
+#define CSR_VIEW_HPP_
+
+#include <utility>
+#include <cassert>
+#include <boost/iterator/iterator_facade.hpp>
+
+namespace webgraph {
+
+/*!
+ * A read-only view over a graph held in compressed sparse row form: an array of n + 1
+ * offsets into an array of targets, with the successors of node x stored (sorted) in
+ * targets[ offsets[x] ] .. targets[ offsets[x+1] - 1 ].
+ *
+ * The view does not own the arrays - they may live in vectors, in a memory-mapped file or
+ * anywhere else, as long as they outlive the view.
+ */
+template<class offset_type = long, class target_type = int>
+class csr_view {
+private:
+   long n;
+   const offset_type* offsets;
+   const target_type* targets;
+
+public:
+   typedef const target_type* successor_iterator;
+   typedef std::pair<successor_iterator, successor_iterator> succ_itor_pair;
+
+   /*!
+    * Sequential iterator over the nodes of a csr_view; dereferences to the node index.
+    */
+   class node_iterator : public boost::iterator_facade<
+      node_iterator,
+      long,
+      boost::forward_traversal_tag,
+      long> {
+   private:
+      const csr_view* owner;
+      long curr;
+
+   public:
+      node_iterator() : owner(NULL), curr(0) {}
+      node_iterator( const csr_view* o, long c ) : owner(o), curr(c) {}
+
+      const csr_view* get_owner() const {
+         return owner;
+      }
+
+   private:
+      friend class boost::iterator_core_access;
+
+      void increment() {
+         ++curr;
+      }
+
+      long dereference() const {
+         return curr;
+      }
+
+      bool equal( const node_iterator& rhs ) const {
+         return curr == rhs.curr;
+      }
+   };
+
+   csr_view() : n(0), offsets(NULL), targets(NULL) {}
+
+   csr_view( long n, const offset_type* offsets, const target_type* targets ) :
+      n(n), offsets(offsets), targets(targets) {
+   }
+
+   long get_num_nodes() const {
+      return n;
+   }
+
+   long get_num_arcs() const {
+      return n == 0 ? 0 : (long)offsets[n];
+   }
+
+   long outdegree( long x ) const {
+      assert( x >= 0 && x < n );
+      return (long)( offsets[x + 1] - offsets[x] );
+   }
+
+   succ_itor_pair get_successors( long x ) const {
+      assert( x >= 0 && x < n );
+      return std::make_pair( targets + offsets[x], targets + offsets[x + 1] );
+   }
+
+   std::pair<node_iterator, node_iterator> get_node_iterator( long from = 0 ) const {
+      return std::make_pair( node_iterator( this, from ), node_iterator( this, n ) );
+   }
+};
+
+}
+
+#endif /*CSR_VIEW_HPP_*/
@@ -0,0 +1,130 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * graph::load_decompressed() lives here rather than in webgraph.cpp so that only the
+ * programs that use it need to link with boost::thread.
+ */
+
+#include <vector>
+#include <algorithm>
+
+#include "webgraph.hpp"
+#include "parallel.hpp"
+
+namespace webgraph { namespace bv_graph {
+
+using namespace std;
+
+namespace {
+
+/*!
+ * State shared by the threads of graph::decompress(), which claim chunks of nodes.
+ */
+struct decompress_job {
+   const graph* g;
+   parallel::chunks nodes;
+
+   vector<long>* offsets;
+   vector<int>* targets;
+
+   /** Stores the outdegree of x in offsets[x + 1]; only the outdegree is decoded. */
+   void count() {
+      long from, to;
+
+      while( nodes.claim( from, to ) ) 
+         for( long x = from; x < to; x++ ) 
+            (*offsets)[ x + 1 ] = g->outdegree( x );
+   }
+
+   /** Decodes the lists of each chunk with a node iterator started at its first node. */
+   void fill() {
+      vector<unsigned int> succ;
+      long from, to;
+
+      while( nodes.claim( from, to ) ) {
+         graph::node_iterator i, end;
+         long x = from;
+
+         for( boost::tie( i, end ) = g->get_node_iterator( from ); x < to; ++i, ++x ) {
+            int d = successor_array( i, succ );
+
+            copy( succ.begin(), succ.begin() + d, targets->begin() + (*offsets)[x] );
+         }
+      }
+   }
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** Creates a new graph by loading a compressed graph file with all offsets, and then
+ * decompressing it into memory. Random access (get_successors() and outdegree()) is then
+ * served from plain arrays, at the cost of 4 bytes per arc and 8 per node on top of the
+ * compressed graph, which is kept for node iterators.
+ *
+ * @param basename the basename of the graph.
+ * @param threads the number of threads decoding the graph.
+ * @param log a stream to report progress on, or <code>NULL</code>.
+ */
+graph::graph_ptr graph::load_decompressed( string basename, int threads, ostream* log ) {
+   graph_ptr g = load( basename, log );
+
+   g->decompress( max( 1, threads ), log );
+
+   return g;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** Fills decompressed_offsets and decompressed_targets. Each thread decodes its own
+ * ranges of nodes, sequentially, so that references are resolved from the window and
+ * not by decoding referenced lists again.
+ */
+void graph::decompress( int threads, ostream* log ) {
+   assert( offset_step == 1 );
+
+   vector<long> offsets( n + 1 );
+   vector<int> targets;
+
+   decompress_job job;
+   job.g = this;
+   job.offsets = &offsets;
+   job.targets = &targets;
+
+   if( log != NULL )
+      *log << "Decompressing graph (" << threads << " threads)...\n";
+
+   job.nodes.reset( n, threads );
+   parallel::run( threads, &job, &decompress_job::count );
+
+   for( long x = 0; x < n; x++ ) 
+      offsets[ x + 1 ] += offsets[ x ];
+
+   assert( offsets[ n ] == m );
+
+   targets.resize( offsets[ n ] );
+
+   job.nodes.reset( n, threads );
+   parallel::run( threads, &job, &decompress_job::fill );
+
+   decompressed_targets.swap( targets );
+   decompressed_offsets.swap( offsets );
+}
+
+} }
@@ -0,0 +1,275 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "degrees.hpp"
+#include "csr_file.hpp"
+#include "parallel.hpp"
+
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <boost/filesystem/operations.hpp>
+
+namespace webgraph { namespace degrees {
+
+using namespace std;
+
+namespace {
+
+const char MAGIC[ 8 ] = { 'W', 'G', 'D', 'E', 'G', 0, 0, 0 };
+const int VERSION = 0;
+const size_t HEADER_SIZE = 48;
+
+boost::uint64_t read_le( const char* p, int bytes ) {
+   boost::uint64_t v = 0;
+
+   for( int b = bytes - 1; b >= 0; b-- ) 
+      v = ( v << 8 ) | (unsigned char)p[b];
+
+   return v;
+}
+
+/** Adds d to a histogram, growing it as needed. */
+inline void count( vector<long>& histogram, int d ) {
+   if( d >= (int)histogram.size() ) 
+      histogram.resize( d + 1 );
+
+   histogram[d]++;
+}
+
+/*!
+ * State shared by the threads of compute() and load(), which claim chunks of nodes; each
+ * thread takes a slot of partial results through next_slot.
+ */
+struct degree_job {
+   const bv_graph::graph* g;
+   long n;
+   parallel::chunks nodes;
+
+   int* indegree;
+   int* outdegree;
+   bool atomic;
+
+   // What count_degrees() reads.
+   const int* degree;
+
+   struct partial {
+      vector<long> histogram;
+      long arcs;
+      long self_loops;
+
+      partial() : arcs( 0 ), self_loops( 0 ) {}
+   };
+
+   vector<partial> partials;
+   long next_slot;
+
+   /** Decodes each chunk, counting outdegrees, indegrees and self-loops. */
+   void scan() {
+      partial& p = partials[ __sync_fetch_and_add( &next_slot, 1 ) ];
+      vector<unsigned int> succ;
+      long from, to;
+
+      while( nodes.claim( from, to ) ) {
+         bv_graph::graph::node_iterator i, end;
+         long x = from;
+
+         for( boost::tie( i, end ) = g->get_node_iterator( from ); x < to; ++i, ++x ) {
+            const int d = bv_graph::successor_array( i, succ );
+
+            outdegree[x] = d;
+            count( p.histogram, d );
+            p.arcs += d;
+
+            for( int j = 0; j < d; j++ ) {
+               p.self_loops += succ[j] == (unsigned)x;
+
+               if( atomic ) 
+                  __sync_fetch_and_add( &indegree[ succ[j] ], 1 );
+               else
+                  indegree[ succ[j] ]++;
+            }
+         }
+      }
+   }
+
+   /** Counts the values of degree in each chunk. */
+   void count_degrees() {
+      partial& p = partials[ __sync_fetch_and_add( &next_slot, 1 ) ];
+      long from, to;
+
+      while( nodes.claim( from, to ) ) 
+         for( long x = from; x < to; x++ ) 
+            count( p.histogram, degree[x] );
+   }
+
+   /** Runs what with the given number of threads, and returns the merged results. */
+   partial run( int threads, void (degree_job::*what)() ) {
+      nodes.reset( n, threads );
+      partials.assign( threads, partial() );
+      next_slot = 0;
+
+      parallel::run( threads, this, what );
+
+      partial total;
+
+      for( int t = 0; t < threads; t++ ) {
+         const partial& p = partials[t];
+
+         if( p.histogram.size() > total.histogram.size() ) 
+            total.histogram.resize( p.histogram.size() );
+
+         for( size_t d = 0; d < p.histogram.size(); d++ ) 
+            total.histogram[d] += p.histogram[d];
+
+         total.arcs += p.arcs;
+         total.self_loops += p.self_loops;
+      }
+
+      return total;
+   }
+};
+
+/** Fills the fields of s that follow from the distributions, arcs and graph_bits. */
+void summarize( statistics& s ) {
+   s.max_indegree = max( 0, (int)s.in_distribution.size() - 1 );
+   s.max_outdegree = max( 0, (int)s.out_distribution.size() - 1 );
+   s.mean_degree = s.nodes > 0 ? (double)s.arcs / s.nodes : 0;
+   s.dangling = s.out_distribution.empty() ? 0 : s.out_distribution[0];
+   s.bits_per_node = s.nodes > 0 ? (double)s.graph_bits / s.nodes : 0;
+   s.bits_per_link = s.arcs > 0 ? (double)s.graph_bits / s.arcs : 0;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void compute( const bv_graph::graph& g, statistics& s, int threads, ostream* log ) {
+   const long n = g.get_num_nodes();
+
+   threads = parallel::scan_threads( g, threads );
+
+   s.nodes = n;
+   s.indegree.assign( n, 0 );
+   s.outdegree.assign( n, 0 );
+
+   degree_job job;
+   job.g = &g;
+   job.n = n;
+   job.indegree = n > 0 ? &s.indegree[0] : NULL;
+   job.outdegree = n > 0 ? &s.outdegree[0] : NULL;
+   job.atomic = threads > 1;
+
+   if( log != NULL )
+      *log << "Scanning graph (" << threads << " threads)...\n";
+
+   degree_job::partial total = job.run( threads, &degree_job::scan );
+
+   s.arcs = total.arcs;
+   s.self_loops = total.self_loops;
+   s.out_distribution.swap( total.histogram );
+
+   job.degree = job.indegree;
+   job.run( threads, &degree_job::count_degrees ).histogram.swap( s.in_distribution );
+
+   const string name = g.get_basename() + ".graph";
+
+   s.graph_bits = !g.get_basename().empty() && boost::filesystem::exists( name ) 
+      ? 8 * (long)boost::filesystem::file_size( name ) : 0;
+
+   summarize( s );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void store( const statistics& s, const string& filename ) {
+   assert( (long)s.indegree.size() == s.nodes && (long)s.outdegree.size() == s.nodes );
+
+   ofstream out( filename.c_str(), ios::binary | ios::trunc );
+   assert( out.good() );
+
+   {
+      csr::detail::le_writer w( out );
+
+      for( int i = 0; i < 8; i++ ) 
+         w.write( MAGIC[i], 1 );
+
+      w.write( VERSION, 4 );
+      w.write( 0, 4 );
+      w.write( s.nodes, 8 );
+      w.write( s.arcs, 8 );
+      w.write( s.self_loops, 8 );
+      w.write( s.graph_bits, 8 );
+
+      for( long x = 0; x < s.nodes; x++ ) 
+         w.write( s.indegree[x], 4 );
+
+      for( long x = 0; x < s.nodes; x++ ) 
+         w.write( s.outdegree[x], 4 );
+   }
+
+   assert( out.good() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void load( const string& filename, statistics& s, int threads ) {
+   ifstream in( filename.c_str(), ios::binary );
+   char header[ HEADER_SIZE ];
+
+   in.read( header, HEADER_SIZE );
+
+   assert( in.good() && memcmp( header, MAGIC, 8 ) == 0 );
+   assert( read_le( header + 8, 4 ) == (boost::uint64_t)VERSION );
+
+   s.nodes = read_le( header + 16, 8 );
+   s.arcs = read_le( header + 24, 8 );
+   s.self_loops = read_le( header + 32, 8 );
+   s.graph_bits = read_le( header + 40, 8 );
+
+   vector<int>* degrees[] = { &s.indegree, &s.outdegree };
+   vector<char> buffer( 1 << 16 );
+
+   for( int k = 0; k < 2; k++ ) {
+      degrees[k]->resize( s.nodes );
+
+      for( long x = 0; x < s.nodes; ) {
+         const long m = min( s.nodes - x, (long)buffer.size() / 4 );
+
+         in.read( &buffer[0], 4 * m );
+         assert( in.good() );
+
+         for( long i = 0; i < m; i++, x++ ) 
+            (*degrees[k])[x] = read_le( &buffer[ 4 * i ], 4 );
+      }
+   }
+
+   if( threads < 1 ) 
+      threads = 1;
+
+   degree_job job;
+   job.n = s.nodes;
+
+   job.degree = s.nodes > 0 ? &s.indegree[0] : NULL;
+   job.run( threads, &degree_job::count_degrees ).histogram.swap( s.in_distribution );
+
+   job.degree = s.nodes > 0 ? &s.outdegree[0] : NULL;
+   job.run( threads, &degree_job::count_degrees ).histogram.swap( s.out_distribution );
+
+   summarize( s );
+}
+
+} }
@@ -0,0 +1,92 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef DEGREES_HPP_
+#define DEGREES_HPP_
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include "webgraph.hpp"
+
+/*!
+ * Degree statistics of compressed graphs, from a single scan.
+ */
+namespace webgraph { namespace degrees {
+
+struct statistics {
+   long nodes;
+   long arcs;
+
+   /// The indegree and outdegree of each node.
+   std::vector<int> indegree, outdegree;
+
+   /// in_distribution[d] is the number of nodes of indegree d, up to the largest indegree;
+   /// likewise for outdegrees.
+   std::vector<long> in_distribution, out_distribution;
+
+   int max_indegree, max_outdegree;
+   double mean_degree;
+
+   /// Nodes without successors.
+   long dangling;
+   long self_loops;
+
+   /// The size of the .graph file in bits, or 0 if unknown, and per node and per arc.
+   long graph_bits;
+   double bits_per_node, bits_per_link;
+
+   statistics() : nodes( 0 ), arcs( 0 ), max_indegree( 0 ), max_outdegree( 0 ), 
+                  mean_degree( 0 ), dangling( 0 ), self_loops( 0 ), graph_bits( 0 ), 
+                  bits_per_node( 0 ), bits_per_link( 0 ) {}
+};
+
+/*!
+ * Computes the statistics of g with one sequential scan, which needs no random access.
+ *
+ * If g was loaded with all offsets (graph::load), the scan is split into
+ * ranges of nodes, each decoded by one of the given number of threads. Outdegrees are
+ * written by the thread owning the node, indegrees are incremented atomically, and each
+ * thread counts outdegrees and self-loops on its own; the counts are merged at the end.
+ */
+void compute( const bv_graph::graph& g, statistics& s, int threads = 1, 
+              std::ostream* log = NULL );
+
+/*!
+ * Writes the degrees of s as a binary file, all little endian:
+ *
+ *   - a 48-byte header: the 8 magic bytes "WGDEG\0\0\0", the format version (4 bytes),
+ *     4 bytes of padding, then the number of nodes n, the number of arcs, the number of
+ *     self-loops and the size of the graph in bits (8 bytes each);
+ *   - the n indegrees, then the n outdegrees, 4 bytes each.
+ *
+ * The rest of the statistics is computed again by load().
+ */
+void store( const statistics& s, const std::string& filename );
+
+/*!
+ * Reads statistics written by store(), counting the distributions with the given number
+ * of threads.
+ */
+void load( const std::string& filename, statistics& s, int threads = 1 );
+
+} }
+
+#endif /*DEGREES_HPP_*/
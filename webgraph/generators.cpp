@@ -0,0 +1,362 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "generators.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/poisson_distribution.hpp>
+
+namespace webgraph { namespace generators {
+
+using namespace std;
+
+namespace {
+   /** The splitmix64 finalizer: a good 64-bit hash, used to derive independent seeds. */
+   boost::uint64_t mix( boost::uint64_t z ) {
+      z += 0x9e3779b97f4a7c15ULL;
+      z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+      z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+      return z ^ ( z >> 31 );
+   }
+
+   /** A uniform double in [0, 1) from the top 53 bits of h. */
+   double to_unit( boost::uint64_t h ) {
+      return ( h >> 11 ) * ( 1.0 / 9007199254740992.0 );
+   }
+
+   /** The random source of a block. */
+   class block_random {
+   private:
+      boost::mt19937 engine;
+
+   public:
+      block_random( boost::uint64_t seed, long block ) : 
+         engine( (boost::uint32_t)mix( mix( seed ) ^ (boost::uint64_t)block ) ) {}
+
+      boost::mt19937& get_engine() {
+         return engine;
+      }
+
+      /** Uniform in [0, 1). */
+      double unit() {
+         boost::uint64_t hi = engine(), lo = engine();
+         return to_unit( ( hi << 32 ) | lo );
+      }
+
+      /** Uniform in [0, k). */
+      long below( long k ) {
+         return (long)( unit() * k );
+      }
+   };
+
+   /** Sorts the list of the last node, starting at targets[from], and removes duplicates. */
+   void close_list( vector<int>& targets, long from, vector<long>& offsets ) {
+      sort( targets.begin() + from, targets.end() );
+      targets.erase( unique( targets.begin() + from, targets.end() ), targets.end() );
+      offsets.push_back( targets.size() );
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void uniform_block( const generator_parameters& p, long from, long to, 
+                       block_random& r, vector<long>& offsets, vector<int>& targets ) {
+      const long max_degree = (long)( 2 * p.avg_degree );
+
+      for( long x = from; x < to; x++ ) {
+         long d = max_degree > 0 ? r.below( max_degree ) : 0, start = targets.size();
+         d = min( d, p.n - 1 );
+
+         // Draw until there are d distinct targets other than x.
+         while( (long)targets.size() - start < d ) {
+            for( long k = targets.size() - start; k < d; k++ ) {
+               long t = r.below( p.n - 1 );
+               targets.push_back( t >= x ? t + 1 : t );
+            }
+
+            sort( targets.begin() + start, targets.end() );
+            targets.erase( unique( targets.begin() + start, targets.end() ), targets.end() );
+         }
+
+         offsets.push_back( targets.size() );
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /** The probability that an R-MAT arc leaves some node below n, i.e. the fraction of
+    * arcs of the 2^levels-node R-MAT graph we keep the sources of. */
+   double rmat_source_mass( const generator_parameters& p, int levels ) {
+      const double top = p.rmat_a + p.rmat_b, bottom = 1 - top;
+      double mass = 0, prefix = 1;
+
+      for( int l = levels - 1; l >= 0; l-- ) {
+         if( ( p.n >> l ) & 1 ) {
+            // All nodes with the same higher bits as n and a 0 here are below n.
+            mass += prefix * top;
+            prefix *= bottom;
+         } else {
+            prefix *= top;
+         }
+      }
+
+      return mass;
+   }
+
+   /** Generates R-MAT lists one source at a time: the source bits of the arcs of a node
+    * are fixed, so its outdegree is Poisson with mean proportional to their probability,
+    * and each target bit is drawn conditionally on the corresponding source bit.
+    */
+   void rmat_block( const generator_parameters& p, long from, long to, 
+                    block_random& r, vector<long>& offsets, vector<int>& targets ) {
+      int levels = 0;
+      while( ( 1L << levels ) < p.n ) 
+         levels++;
+
+      const double a = p.rmat_a, b = p.rmat_b, c = p.rmat_c, d = 1 - a - b - c;
+      assert( a > 0 && b >= 0 && c >= 0 && d > 0 );
+
+      const double arcs = p.avg_degree * p.n / rmat_source_mass( p, levels );
+      // Target bits are drawn comparing a 32-bit random number against these.
+      const double two32 = 4294967296.0;
+      const boost::uint32_t right_if_top = (boost::uint32_t)min( two32 - 1, b / ( a + b ) * two32 ),
+         right_if_bottom = (boost::uint32_t)min( two32 - 1, d / ( c + d ) * two32 );
+
+      for( long x = from; x < to; x++ ) {
+         double prob = 1;
+         for( int l = 0; l < levels; l++ ) 
+            prob *= ( ( x >> l ) & 1 ) ? c + d : a + b;
+
+         long k = 0, start = targets.size();
+         if( arcs * prob > 0 ) {
+            boost::random::poisson_distribution<long, double> outdegree( arcs * prob );
+            k = outdegree( r.get_engine() );
+         }
+
+         while( k > 0 ) {
+            long t = 0;
+
+            for( int l = levels - 1; l >= 0; l-- ) {
+               boost::uint32_t right = ( ( x >> l ) & 1 ) ? right_if_bottom : right_if_top;
+               if( r.get_engine()() < right ) 
+                  t |= 1L << l;
+            }
+
+            // Targets beyond n are drawn again.
+            if( t < p.n ) {
+               targets.push_back( t );
+               k--;
+            }
+         }
+
+         close_list( targets, start, offsets );
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /** The number of links (before removing duplicates) of node x in the preferential
+    * attachment model. */
+   long pa_links( const generator_parameters& p, long x ) {
+      return x == 0 ? 0 : max( 1L, (long)( p.avg_degree + .5 ) );
+   }
+
+   /** The target of the j-th link of node x in the preferential attachment model. It is
+    * a function of the seed, x and j alone, so that following a copied link just means
+    * computing the link again; the chain of copies is geometric, of mean 
+    * 1 / ( 1 - copy_probability ).
+    */
+   long pa_target( const generator_parameters& p, long x, long j ) {
+      const long links = max( 1L, (long)( p.avg_degree + .5 ) );
+
+      for( ;; ) {
+         boost::uint64_t h = mix( p.seed ^ mix( (boost::uint64_t)x * links + j ) );
+         long y = (long)( to_unit( mix( h ) ) * x );
+
+         if( to_unit( h ) >= p.copy_probability || y == 0 )
+            return y;
+
+         // Copy the target of a random link of y.
+         j = (long)( to_unit( mix( h ^ 0x5851f42d4c957f2dULL ) ) * links );
+         x = y;
+      }
+   }
+
+   void pa_block( const generator_parameters& p, long from, long to, 
+                  vector<long>& offsets, vector<int>& targets ) {
+      for( long x = from; x < to; x++ ) {
+         long start = targets.size();
+
+         for( long j = pa_links( p, x ) - 1; j >= 0; j-- ) 
+            targets.push_back( pa_target( p, x, j ) );
+
+         close_list( targets, start, offsets );
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /** The copying model. Prototypes are taken within the block, so that blocks stay 
+    * independent; the first node of a block has none.
+    */
+   void copying_block( const generator_parameters& p, long from, long to, 
+                       block_random& r, vector<long>& offsets, vector<int>& targets ) {
+      // A discrete power law with exponent 2.5, scaled so that its mean is avg_degree.
+      const double gamma = 2.5, scale = p.avg_degree * ( gamma - 2 ) / ( gamma - 1 );
+      const long window = max( 1, p.locality_window );
+
+      for( long x = from; x < to; x++ ) {
+         long d = (long)min( (double)( p.n - 1 ), 
+                             floor( scale / pow( 1 - r.unit(), 1 / ( gamma - 1 ) ) ) );
+         long start = targets.size(), copied = 0;
+
+         if( x > from ) {
+            long prototype = x - 1 - r.below( min( window, x - from ) ) - from;
+
+            for( long i = offsets[ prototype ]; i < offsets[ prototype + 1 ]; i++ ) {
+               if( r.unit() < p.copy_probability ) {
+                  int t = targets[i];
+                  targets.push_back( t );
+                  copied++;
+               }
+            }
+         }
+
+         for( long k = copied; k < d; k++ ) {
+            long t;
+
+            if( r.unit() < p.locality ) {
+               t = x - window + r.below( 2 * window + 1 );
+               t = max( 0L, min( p.n - 1, t ) );
+            } else {
+               t = r.below( p.n );
+            }
+
+            targets.push_back( t );
+         }
+
+         close_list( targets, start, offsets );
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool parse_model( const string& name, model& m ) {
+   if( name == "uniform" ) 
+      m = UNIFORM;
+   else if( name == "rmat" ) 
+      m = RMAT;
+   else if( name == "pa" ) 
+      m = PREFERENTIAL_ATTACHMENT;
+   else if( name == "copying" ) 
+      m = COPYING;
+   else
+      return false;
+
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void generate_block( const generator_parameters& p, long block, 
+                     vector<long>& offsets, vector<int>& targets ) {
+   const long from = block * BLOCK_SIZE, to = min( p.n, from + BLOCK_SIZE );
+   assert( from < to );
+
+   block_random r( p.seed, block );
+
+   offsets.clear();
+   targets.clear();
+   offsets.push_back( 0 );
+
+   switch( p.type ) {
+   case UNIFORM:
+      uniform_block( p, from, to, r, offsets, targets );
+      break;
+   case RMAT:
+      rmat_block( p, from, to, r, offsets, targets );
+      break;
+   case PREFERENTIAL_ATTACHMENT:
+      pa_block( p, from, to, offsets, targets );
+      break;
+   case COPYING:
+      copying_block( p, from, to, r, offsets, targets );
+      break;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+generated_graph::generated_graph( const generator_parameters& p, int threads ) :
+   params( p ), threads( max( 1, threads ) ) {
+   assert( p.n > 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+pair<generated_graph::node_iterator, generated_graph::node_iterator> 
+generated_graph::get_node_iterator() const {
+   boost::shared_ptr<scan> s( new scan( params, threads ) );
+
+   s->advance();
+
+   return make_pair( node_iterator( s ), node_iterator() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+generated_graph::scan::scan( const generator_parameters& p, int threads ) :
+   params( p ), blocks( ( p.n + BLOCK_SIZE - 1 ) / BLOCK_SIZE ), 
+   current( 0 ), node( -1 ), at_end( false ), first( NULL ), last( NULL ) {
+   pipeline.start( blocks.size(), threads, boost::bind( &scan::generate, this, _1 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void generated_graph::scan::generate( long i ) {
+   generate_block( params, i, blocks[i].offsets, blocks[i].targets );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void generated_graph::scan::advance() {
+   assert( !at_end );
+
+   node++;
+
+   if( node == params.n ) {
+      at_end = true;
+      return;
+   }
+
+   const long i = node % BLOCK_SIZE;
+
+   if( i == 0 ) {
+      if( node > 0 ) {
+         // Free the block just left behind and let the workers move on.
+         vector<long>().swap( blocks[ current ].offsets );
+         vector<int>().swap( blocks[ current ].targets );
+         current++;
+         pipeline.release();
+      }
+
+      pipeline.wait();
+   }
+
+   const block& b = blocks[ current ];
+   const int* base = b.targets.empty() ? NULL : &b.targets[0];
+
+   first = base + b.offsets[i];
+   last = base + b.offsets[i + 1];
+}
+
+} }
@@ -0,0 +1,213 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef GENERATORS_HPP_
+#define GENERATORS_HPP_
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "successor_source.hpp"
+#include "pipeline.hpp"
+
+/*!
+ * Synthetic graphs for benchmarks and regression tests.
+ *
+ * Every model generates successor lists node by node, in blocks of BLOCK_SIZE nodes, and
+ * the lists of a block depend only on the parameters (seed included) and on the block
+ * number. Blocks can thus be generated by any number of threads in any order, and a
+ * given set of parameters always yields the same graph.
+ */
+namespace webgraph { namespace generators {
+
+enum model {
+   /// Outdegrees uniform in [0, 2 * avg_degree), targets uniform; no loops.
+   UNIFORM,
+   /// R-MAT (Chakrabarti, Zhan and Faloutsos, 2004) on the smallest power of two
+   /// holding n nodes, with quadrant probabilities a, b, c and 1 - a - b - c.
+   RMAT,
+   /// Linear preferential attachment: each node links to earlier nodes only, each of its
+   /// links going to a uniformly chosen node with probability 1 - copy_probability, and
+   /// otherwise to the target of a random link of a uniformly chosen node, which picks
+   /// targets proportionally to their indegree.
+   PREFERENTIAL_ATTACHMENT,
+   /// A copying model with locality, mimicking the lists of a crawl in URL order: each
+   /// node copies each successor of a prototype among the locality_window nodes before
+   /// it with probability copy_probability, and its remaining successors land within
+   /// locality_window of it with probability locality, anywhere otherwise. Outdegrees
+   /// follow a power law with exponent 2.5.
+   COPYING
+};
+
+/** Parses a model name (uniform, rmat, pa or copying); returns false if it is unknown. */
+bool parse_model( const std::string& name, model& m );
+
+struct generator_parameters {
+   model type;
+   long n;
+   double avg_degree;
+   boost::uint64_t seed;
+
+   double rmat_a, rmat_b, rmat_c;
+   double copy_probability;
+   double locality;
+   int locality_window;
+
+   generator_parameters() : 
+      type( COPYING ), n( 0 ), avg_degree( 10 ), seed( 0 ),
+      rmat_a( .57 ), rmat_b( .19 ), rmat_c( .19 ),
+      copy_probability( .8 ), locality( .9 ), locality_window( 10 ) {}
+};
+
+/// The number of nodes whose lists are generated together.
+const long BLOCK_SIZE = 1 << 16;
+
+/*!
+ * Generates the lists of the nodes of the given block, sorted and without duplicates: the
+ * successors of node block * BLOCK_SIZE + i end up in 
+ * targets[ offsets[i] ] .. targets[ offsets[i+1] - 1 ].
+ */
+void generate_block( const generator_parameters& p, long block, 
+                     std::vector<long>& offsets, std::vector<int>& targets );
+
+/*!
+ * A graph generated on the fly, which can be scanned (and thus stored, see
+ * bv_graph::graph::store) without ever being held in memory. Each scan generates the
+ * blocks with the given number of threads, at most twice as many blocks as threads
+ * ahead of the iterator (see parallel::ordered_pipeline). Iterators are single pass, and copies share their position;
+ * every call to get_node_iterator() starts a new scan.
+ */
+class generated_graph {
+private:
+   struct block {
+      std::vector<long> offsets;
+      std::vector<int> targets;
+   };
+
+   class scan : public boost::noncopyable {
+   private:
+      const generator_parameters params;
+      std::vector<block> blocks;
+
+      // Declared after blocks, so that the workers are stopped first.
+      parallel::ordered_pipeline pipeline;
+
+      void generate( long i );
+
+   public:
+      size_t current; // the block of the current node
+      long node;
+      bool at_end;
+      const int* first;
+      const int* last;
+
+      scan( const generator_parameters& p, int threads );
+
+      void advance();
+   };
+
+   generator_parameters params;
+   int threads;
+
+public:
+   class node_iterator : public boost::iterator_facade<
+      node_iterator,
+      long,
+      boost::single_pass_traversal_tag,
+      long
+   > {
+   private:
+      boost::shared_ptr<scan> state; // NULL for the end marker
+
+   public:
+      node_iterator() {}
+      explicit node_iterator( const boost::shared_ptr<scan>& s ) : state( s ) {}
+
+      std::pair<const int*, const int*> get_successors() const {
+         return std::make_pair( state->first, state->last );
+      }
+
+   private:
+      friend class boost::iterator_core_access;
+
+      void increment() {
+         state->advance();
+      }
+
+      bool at_end() const {
+         return state == NULL || state->at_end;
+      }
+
+      bool equal( const node_iterator& rhs ) const {
+         if( at_end() || rhs.at_end() )
+            return at_end() && rhs.at_end();
+
+         return state == rhs.state;
+      }
+
+      long dereference() const {
+         return state->node;
+      }
+   };
+
+   generated_graph( const generator_parameters& p, int threads = 1 );
+
+   long get_num_nodes() const {
+      return params.n;
+   }
+
+   std::pair<node_iterator, node_iterator> get_node_iterator() const;
+};
+
+} 
+
+////////////////////////////////////////////////////////////////////////////////
+template<>
+struct successor_source_traits<generators::generated_graph> {
+   typedef generators::generated_graph::node_iterator node_iterator;
+
+   static long num_nodes( const generators::generated_graph& g ) {
+      return g.get_num_nodes();
+   }
+
+   static std::pair<node_iterator, node_iterator> nodes( const generators::generated_graph& g ) {
+      return g.get_node_iterator();
+   }
+
+   static int successors( const node_iterator& i, std::vector<unsigned int>& dest ) {
+      std::pair<const int*, const int*> s = i.get_successors();
+      unsigned int d = s.second - s.first;
+
+      if( d > dest.size() )
+         dest.resize( d );
+
+      std::copy( s.first, s.second, dest.begin() );
+
+      return d;
+   }
+};
+
+}
+
+#endif /*GENERATORS_HPP_*/
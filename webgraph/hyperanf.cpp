@@ -0,0 +1,261 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "hyperanf.hpp"
+#include "parallel.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace webgraph { namespace hyperanf {
+
+using namespace std;
+
+namespace {
+
+typedef boost::uint64_t word;
+
+/// The number of consecutive nodes whose estimates are summed together.
+const long BLOCK_SIZE = 1 << 14;
+
+/// The top bit of each byte of a word.
+const word HIGH_BITS = 0x8080808080808080ULL;
+
+/** The register-wise maximum of two words of registers, none of which uses its top bit.
+ * (x | HIGH_BITS) - y cannot borrow across bytes, and keeps the top bit of a byte exactly
+ * where the register of x is not smaller than that of y. */
+inline word register_max( word x, word y ) {
+   const word ge = ( ( ( x | HIGH_BITS ) - y ) & HIGH_BITS ) >> 7;
+   const word mask = ge * 0xFF;
+
+   return ( x & mask ) | ( y & ~mask );
+}
+
+/** A 64-bit mix of node x, from the finalizer of SplitMix64. */
+inline word hash( word x, word seed ) {
+   word h = ( x + 1 ) * 0x9E3779B97F4A7C15ULL ^ seed;
+
+   h = ( h ^ ( h >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+   h = ( h ^ ( h >> 27 ) ) * 0x94D049BB133111EBULL;
+
+   return h ^ ( h >> 31 );
+}
+
+/*!
+ * The counters and the state shared by the threads of an iteration. Threads claim single
+ * blocks of nodes when the graph has offsets; otherwise a single thread scans the whole
+ * graph as one chunk. Either way the estimates of each block go to its own slot of sum.
+ */
+struct anf_job {
+   const bv_graph::graph* g;
+   long n;
+   int m;
+   int words;
+   double alpha_mm;
+   double inverse_power[ 65 ];
+
+   long num_blocks;
+   parallel::chunks nodes;
+
+   vector<word> current;
+   vector<word> next;
+
+   vector<double> sum;
+   vector<char> changed;
+
+   anf_job( const bv_graph::graph& g, const anf_parameters& p ) : 
+      g( &g ), n( g.get_num_nodes() ), m( 1 << p.log2m ), words( m / 8 ),
+      num_blocks( ( n + BLOCK_SIZE - 1 ) / BLOCK_SIZE ),
+      current( n * words ), next( n * words ), 
+      sum( num_blocks ), changed( num_blocks ) {
+      const double alpha = m == 16 ? .673 : m == 32 ? .697 : m == 64 ? .709 
+         : .7213 / ( 1 + 1.079 / m );
+
+      alpha_mm = alpha * m * m;
+
+      for( int r = 0; r <= 64; r++ ) 
+         inverse_power[r] = ldexp( 1.0, -r );
+
+      for( long x = 0; x < n; x++ ) {
+         const word h = hash( x, p.seed ), rest = h >> p.log2m;
+         const int j = h & ( m - 1 );
+         const word rank = rest == 0 ? 64 - p.log2m + 1 : __builtin_ctzll( rest ) + 1;
+
+         current[ x * words + j / 8 ] |= rank << ( j % 8 * 8 );
+      }
+   }
+
+   /** The HyperLogLog estimate of the counter starting at c, with the small range
+    * correction. */
+   double estimate( const word* c ) const {
+      double z = 0;
+      int zeros = 0;
+
+      for( int w = 0; w < words; w++ ) 
+         for( int b = 0; b < 64; b += 8 ) {
+            const int r = ( c[w] >> b ) & 0xFF;
+
+            z += inverse_power[r];
+            zeros += r == 0;
+         }
+
+      const double e = alpha_mm / z;
+
+      return e <= 2.5 * m && zeros != 0 ? m * log( double( m ) / zeros ) : e;
+   }
+
+   /** Sums the estimates of the current counters, by block. */
+   double total() const {
+      double s = 0;
+
+      for( long b = 0; b < num_blocks; b++ ) {
+         double block_sum = 0;
+
+         for( long x = b * BLOCK_SIZE; x < min( n, ( b + 1 ) * BLOCK_SIZE ); x++ ) 
+            block_sum += estimate( &current[ x * words ] );
+
+         s += block_sum;
+      }
+
+      return s;
+   }
+
+   /** Computes the next counters of the nodes in [from, to), a range of whole blocks. */
+   void scan( long from, long to ) {
+      vector<unsigned int> succ;
+      bv_graph::graph::node_iterator i, end;
+      long x = from;
+
+      boost::tie( i, end ) = g->get_node_iterator( from );
+
+      for( long b = from / BLOCK_SIZE; x < to; b++ ) {
+         double block_sum = 0;
+         bool block_changed = false;
+
+         for( ; x < min( to, ( b + 1 ) * BLOCK_SIZE ); ++i, ++x ) {
+            const int d = bv_graph::successor_array( i, succ );
+            const word* c = &current[ x * words ];
+            word* u = &next[ x * words ];
+
+            copy( c, c + words, u );
+
+            for( int k = 0; k < d; k++ ) {
+               const word* s = &current[ (long)succ[k] * words ];
+
+               for( int w = 0; w < words; w++ ) 
+                  u[w] = register_max( u[w], s[w] );
+            }
+
+            block_changed |= !equal( c, c + words, u );
+            block_sum += estimate( u );
+         }
+
+         sum[b] = block_sum;
+         changed[b] = block_changed;
+      }
+   }
+
+   void scan_chunks() {
+      long from, to;
+
+      while( nodes.claim( from, to ) ) 
+         scan( from, to );
+   }
+
+   /** Runs an iteration; returns whether any counter changed. */
+   bool iterate( int threads ) {
+      nodes.reset_fixed( n, threads > 1 ? BLOCK_SIZE : max( 1L, n ) );
+      parallel::run( threads, this, &anf_job::scan_chunks );
+
+      current.swap( next );
+
+      return find( changed.begin(), changed.end(), true ) != changed.end();
+   }
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int neighbourhood_function( const bv_graph::graph& g, vector<double>& nf, 
+                            const anf_parameters& p, ostream* log ) {
+   assert( p.log2m >= 4 && p.log2m <= 16 );
+
+   const int threads = parallel::scan_threads( g, p.threads );
+
+   anf_job job( g, p );
+
+   nf.assign( 1, job.total() );
+
+   int t;
+
+   for( t = 1; t <= p.max_distance; t++ ) {
+      if( !job.iterate( threads ) )
+         break;
+
+      double s = 0;
+
+      for( long b = 0; b < job.num_blocks; b++ ) 
+         s += job.sum[b];
+
+      nf.push_back( s );
+
+      if( log != NULL )
+         *log << "Iteration " << t << ": " << s << " pairs\n";
+   }
+
+   return t - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void distance_distribution( const vector<double>& nf, vector<double>& dd ) {
+   dd.resize( nf.size() );
+
+   for( size_t t = 0; t < nf.size(); t++ ) 
+      dd[t] = t == 0 ? nf[0] : nf[t] - nf[t - 1];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double average_distance( const vector<double>& nf ) {
+   double pairs = 0, total = 0;
+
+   for( size_t t = 1; t < nf.size(); t++ ) {
+      pairs += nf[t] - nf[t - 1];
+      total += t * ( nf[t] - nf[t - 1] );
+   }
+
+   return pairs == 0 ? 0 : total / pairs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double effective_diameter( const vector<double>& nf, double fraction ) {
+   assert( !nf.empty() );
+
+   const double target = fraction * nf.back();
+   size_t t = 0;
+
+   while( nf[t] < target ) 
+      t++;
+
+   if( t == 0 )
+      return 0;
+
+   return t - 1 + ( target - nf[t - 1] ) / ( nf[t] - nf[t - 1] );
+}
+
+} }
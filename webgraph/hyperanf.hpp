@@ -0,0 +1,82 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef HYPERANF_HPP_
+#define HYPERANF_HPP_
+
+#include <vector>
+#include <iostream>
+#include <boost/cstdint.hpp>
+
+#include "webgraph.hpp"
+
+/*!
+ * Approximate neighbourhood function and distance distribution of compressed graphs, by
+ * HyperANF (Boldi, Rosa and Vigna, 2011).
+ *
+ * Each node has a HyperLogLog counter, initially holding just the node. At iteration t
+ * the counter of x becomes the union of its own and those of its successors, so it then
+ * estimates the number of nodes within distance t of x, and the sum of all counters the
+ * number of pairs at distance at most t. Iteration stops when no counter changes.
+ *
+ * Counters have 2^log2m one-byte registers, packed eight to a 64-bit word, and a union is
+ * a register-wise maximum computed a word at a time with a few arithmetic operations
+ * (registers hold at most 64 - log2m + 1, so their top bit is free to catch borrows). Two
+ * arrays of counters are kept, for 2^(log2m + 1) bytes per node.
+ *
+ * The graph is scanned sequentially once per iteration; if it was loaded with all
+ * offsets, each scan is split into ranges of nodes among the threads, each writing only
+ * the counters of its own ranges. Estimates are summed by range, in order, so the result
+ * does not depend on the number of threads.
+ */
+namespace webgraph { namespace hyperanf {
+
+struct anf_parameters {
+   /// The base-2 logarithm of the number of registers per counter, at least 4; the
+   /// relative standard deviation of a counter is about 1.04 / sqrt( 2^log2m ).
+   int log2m;
+   int max_distance;
+   int threads;
+   boost::uint64_t seed;
+
+   anf_parameters() : log2m( 6 ), max_distance( 1 << 30 ), threads( 1 ), seed( 0 ) {}
+};
+
+/*!
+ * Estimates the neighbourhood function of g: on return nf[t] is the estimated number of
+ * pairs (x, y) such that y is within distance t of x (including x itself at distance 0).
+ * Returns the number of iterations performed.
+ */
+int neighbourhood_function( const bv_graph::graph& g, std::vector<double>& nf, 
+                            const anf_parameters& p = anf_parameters(), 
+                            std::ostream* log = NULL );
+
+/** Turns a neighbourhood function into the number of pairs at each distance. */
+void distance_distribution( const std::vector<double>& nf, std::vector<double>& dd );
+
+/** The average distance between reachable pairs of distinct nodes. */
+double average_distance( const std::vector<double>& nf );
+
+/** The smallest (interpolated) distance within which lie the given fraction of the pairs
+ * counted by nf; with fraction .9, the effective diameter. */
+double effective_diameter( const std::vector<double>& nf, double fraction = .9 );
+
+} }
+
+#endif /*HYPERANF_HPP_*/
@@ -0,0 +1,70 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef ARRAY_ITERATOR_HPP
+#define ARRAY_ITERATOR_HPP
+
+#include "utility_iterator_base.hpp"
+#include <string>
+#include <sstream>
+#include <algorithm>
+
+namespace webgraph { namespace bv_graph { namespace utility_iterators {
+
+/*!
+ * Iterates over a range of an array owned by someone else, such as the successor lists
+ * of a decompressed graph. Cloning just copies two pointers.
+ */
+template<typename val_type>
+class array_iterator : public utility_iterator_base<val_type> {
+private:
+   const val_type* curr;
+   const val_type* end;
+
+public:
+   array_iterator( const val_type* b, const val_type* e ) : curr( b ), end( e ) {}
+
+   val_type next() {
+      return *curr++;
+   }
+
+   bool has_next() const {
+      return curr != end;
+   }
+   
+   int skip( int how_many ) {
+      int s = std::min( how_many, (int)( end - curr ) );
+      curr += s;
+      return s;
+   }
+
+   std::string as_str() const {
+      std::ostringstream o;
+      o << "Array iterator with " << ( end - curr ) << " elements left.";
+      return o.str();
+   }
+   
+   array_iterator* clone() const {
+      return new array_iterator( *this );
+   }
+};
+
+}}}
+
+#endif
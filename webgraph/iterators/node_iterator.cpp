@@ -39,26 +39,42 @@ using namespace utility_iterators;
 node_iterator::node_iterator( const graph* owner, boost::shared_ptr<ibitstream> is, 
                               int from, int window_size ) :
       ibs(is) {
-      this->from = from;
-      this->cyclic_buffer_size = window_size + 1;
-      this->owner = owner;
-      this->n = owner->get_num_nodes();
-      this->end_marker = false;
-      this->window.resize( cyclic_buffer_size );
-      for( vector< vector<int> >::iterator itor = window.begin();
-           itor != window.end();
-           itor++ ) {
-         itor->resize( graph::INITIAL_SUCCESSOR_LIST_LENGTH );
+   this->from = from;
+   this->cyclic_buffer_size = window_size + 1;
+   this->owner = owner;
+   this->n = owner->get_num_nodes();
+   this->end_marker = false;
+   this->window.resize( cyclic_buffer_size );
+   for( vector< vector<int> >::iterator itor = window.begin();
+        itor != window.end();
+        itor++ ) 
+      itor->resize( graph::INITIAL_SUCCESSOR_LIST_LENGTH );
          
-        this->outd.resize( cyclic_buffer_size );
-//      this->block_outdegrees = NULL; // so long as offset step = 1 TODO change this
+   this->outd.resize( cyclic_buffer_size );
+//   this->block_outdegrees = NULL; // so long as offset step = 1 TODO change this
 
-        if ( from != 0 ) {
-          owner->position( *ibs, from );
-        }
-        curr = from - 1;
+   if ( from != 0 ) {
+      // Lists may refer to the window_size lists before them, so the window is filled by
+      // random access (which resolves references recursively) before positioning on from.
+      assert( owner->offset_step == 1 );
+
+      for( int y = max( 0, from - window_size ); y < from; y++ ) {
+         int i = y % cyclic_buffer_size;
+         graph::succ_itor_pair s = owner->get_successors( y );
+
+         outd[i] = owner->outdegree( y );
+         if( window[i].size() < (unsigned)outd[i] )
+            window[i].resize( outd[i] );
+
+         std::copy( s.first, s.second, window[i].begin() );
       }
-      increment(); // grab the first node.
+
+      ibs->set_position( owner->offset[ from ] );
+   }
+
+   curr = from - 1;
+
+   increment(); // grab the first node.
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -168,6 +184,24 @@ vector<int> successor_vector( const node_iterator& itor ) {
    return retval;
 }
    
+/** Copies the successors of the current node into the front of <code>dest</code>,
+ * growing it if needed, and returns how many there are. Unlike successor_vector, this
+ * allows the caller to reuse the same vector for every node.
+ */
+int successor_array( const node_iterator& itor, vector<unsigned int>& dest ) {
+   assert( itor.curr != itor.from - 1 );
+
+   int cur_index = itor.curr % itor.cyclic_buffer_size;
+   int d = itor.outd[ cur_index ];
+
+   if( dest.size() < (unsigned)d )
+      dest.resize( d );
+
+   std::copy( itor.window[ cur_index ].begin(), itor.window[ cur_index ].begin() + d, dest.begin() );
+
+   return d;
+}
+   
 int outdegree( const node_iterator& itor ) {
    assert( itor.curr != itor.from - 1 );
 
@@ -133,11 +133,13 @@ public:
    friend std::pair<succ_itor_wrapper, succ_itor_wrapper> successors( node_iterator& rhs );
 
    friend std::vector<int> successor_vector( const node_iterator& rhs );
+   friend int successor_array( const node_iterator& rhs, std::vector<unsigned int>& dest );
    friend int outdegree( const node_iterator& rhs );
    friend class graph;
 };
 
 int outdegree( const node_iterator& itor );
+int successor_array( const node_iterator& itor, std::vector<unsigned int>& dest );
 
 } }
 
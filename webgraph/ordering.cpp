@@ -0,0 +1,210 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "ordering.hpp"
+#include "transform.hpp"
+
+#include <cassert>
+#include <cmath>
+
+namespace webgraph { namespace ordering {
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+void to_permutation( const vector<int>& order, vector<int>& perm ) {
+   perm.resize( order.size() );
+
+   for( unsigned i = 0; i < order.size(); i++ ) 
+      perm[ order[i] ] = i;
+}
+
+bool is_permutation( const vector<int>& v ) {
+   vector<bool> seen( v.size() );
+
+   for( unsigned i = 0; i < v.size(); i++ ) {
+      if( v[i] < 0 || (unsigned)v[i] >= v.size() || seen[ v[i] ] )
+         return false;
+      seen[ v[i] ] = true;
+   }
+
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void bfs_order( const bv_graph::graph& g, vector<int>& order ) {
+   const long n = g.get_num_nodes();
+   vector<bool> visited( n );
+
+   order.clear();
+   order.reserve( n );
+
+   // order doubles as the queue: nodes in [head, order.size()) are still to be expanded.
+   unsigned head = 0;
+
+   for( long start = 0; start < n; start++ ) {
+      if( visited[start] )
+         continue;
+
+      visited[start] = true;
+      order.push_back( start );
+
+      while( head < order.size() ) {
+         bv_graph::graph::successor_iterator s, end;
+
+         for( boost::tie( s, end ) = g.get_successors( order[ head++ ] ); s != end; ++s ) {
+            if( !visited[ *s ] ) {
+               visited[ *s ] = true;
+               order.push_back( *s );
+            }
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+vector<double> default_gammas() {
+   vector<double> gammas;
+
+   for( int i = 0; i <= 10; i++ ) 
+      gammas.push_back( ldexp( 1.0, -i ) );
+   gammas.push_back( 0 );
+
+   return gammas;
+}
+
+namespace {
+
+/*!
+ * Runs label propagation at resolution gamma; labels must come in initialized (each
+ * node in its own cluster, say) and are updated in place.
+ */
+void propagate( const bv_graph::graph& g, const vector<long>& in_offsets, 
+                const vector<int>& in_arcs, double gamma, int max_iterations, 
+                vector<int>& label, ostream* log ) {
+   const long n = g.get_num_nodes();
+
+   vector<int> volume( n ), count( n ), touched;
+   vector<unsigned int> succ;
+
+   for( long x = 0; x < n; x++ ) 
+      volume[ label[x] ]++;
+
+   for( int it = 0; it < max_iterations; it++ ) {
+      long changes = 0;
+      bv_graph::graph::node_iterator i, end;
+      long x = 0;
+
+      for( boost::tie( i, end ) = g.get_node_iterator( 0 ); x < n && i != end; ++i, ++x ) {
+         int d = bv_graph::successor_array( i, succ );
+
+         for( int j = 0; j < d; j++ ) {
+            if( (long)succ[j] == x ) continue;
+            int l = label[ succ[j] ];
+            if( count[l]++ == 0 ) touched.push_back( l );
+         }
+         for( long j = in_offsets[x]; j < in_offsets[x + 1]; j++ ) {
+            if( in_arcs[j] == x ) continue;
+            int l = label[ in_arcs[j] ];
+            if( count[l]++ == 0 ) touched.push_back( l );
+         }
+
+         const int curr = label[x];
+
+         // x itself does not count towards the volume of its own cluster.
+         double best = count[curr] - gamma * ( volume[curr] - 1 - count[curr] );
+         int best_label = curr;
+
+         for( unsigned j = 0; j < touched.size(); j++ ) {
+            int l = touched[j];
+            double score = count[l] - gamma * ( volume[l] - count[l] );
+
+            if( score > best || ( score == best && l < best_label && best_label != curr ) ) {
+               best = score;
+               best_label = l;
+            }
+         }
+
+         for( unsigned j = 0; j < touched.size(); j++ ) 
+            count[ touched[j] ] = 0;
+         touched.clear();
+
+         if( best_label != curr ) {
+            volume[curr]--;
+            volume[best_label]++;
+            label[x] = best_label;
+            changes++;
+         }
+      }
+
+      if( log != NULL )
+         *log << "gamma=" << gamma << ", sweep " << it + 1 << ": " << changes 
+              << " changes\n";
+
+      if( changes <= n / 1000 )
+         break;
+   }
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void llp_order( const bv_graph::graph& g, vector<int>& order, const vector<double>& gammas, 
+                int max_iterations, ostream* log ) {
+   const long n = g.get_num_nodes();
+
+   vector<long> in_offsets;
+   vector<int> in_arcs;
+
+   transform::transpose_in_memory( g, in_offsets, in_arcs, 1, log );
+
+   order.resize( n );
+   for( long x = 0; x < n; x++ ) 
+      order[x] = x;
+
+   vector<int> label( n ), key( n ), bucket( n + 1 ), next( n );
+
+   for( unsigned k = 0; k < gammas.size(); k++ ) {
+      for( long x = 0; x < n; x++ ) 
+         label[x] = x;
+
+      propagate( g, in_offsets, in_arcs, gammas[k], max_iterations, label, log );
+
+      // Each cluster is keyed by the position of its first member in the current order,
+      // and a stable counting sort on that key keeps the previous order within clusters.
+      fill( key.begin(), key.end(), -1 );
+      for( long i = 0; i < n; i++ ) 
+         if( key[ label[ order[i] ] ] == -1 )
+            key[ label[ order[i] ] ] = i;
+
+      fill( bucket.begin(), bucket.end(), 0 );
+      for( long i = 0; i < n; i++ ) 
+         bucket[ key[ label[ order[i] ] ] + 1 ]++;
+      for( long i = 0; i < n; i++ ) 
+         bucket[i + 1] += bucket[i];
+      for( long i = 0; i < n; i++ ) 
+         next[ bucket[ key[ label[ order[i] ] ] ]++ ] = order[i];
+
+      order.swap( next );
+   }
+
+   assert( is_permutation( order ) );
+}
+
+} }
@@ -0,0 +1,116 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef ORDERING_HPP_
+#define ORDERING_HPP_
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include <boost/tuple/tuple.hpp>
+
+#include "webgraph.hpp"
+#include "successor_source.hpp"
+
+/*!
+ * Node orderings that improve locality, and thus compression and the speed of scans.
+ *
+ * Every function here produces an order: the sequence of old node numbers in their new
+ * position, i.e. order[i] is the node that will be numbered i. transform::permute wants the
+ * inverse mapping, which to_permutation computes.
+ */
+namespace webgraph { namespace ordering {
+
+/** Inverts an order into a permutation suitable for transform::permute: perm[ order[i] ] = i. */
+void to_permutation( const std::vector<int>& order, std::vector<int>& perm );
+
+/** Checks that v contains each of 0 .. v.size() - 1 exactly once. */
+bool is_permutation( const std::vector<int>& v );
+
+namespace detail {
+   struct by_degree {
+      const std::vector<int>& degree;
+
+      by_degree( const std::vector<int>& d ) : degree( d ) {}
+
+      bool operator()( int x, int y ) const {
+         return degree[x] > degree[y] || ( degree[x] == degree[y] && x < y );
+      }
+   };
+}
+
+/*!
+ * Orders nodes by decreasing outdegree (ties by node number). Needs a single sequential
+ * scan of g.
+ */
+template<class source_type>
+void degree_order( const source_type& g, std::vector<int>& order ) {
+   typedef successor_source_traits<source_type> traits;
+
+   const long n = traits::num_nodes( g );
+   std::vector<int> degree( n );
+   std::vector<unsigned int> succ;
+
+   typename traits::node_iterator i, end;
+   long x = 0;
+
+   for( boost::tie( i, end ) = traits::nodes( g ); x < n && i != end; ++i, ++x ) 
+      degree[x] = traits::successors( i, succ );
+
+   order.resize( n );
+   for( long y = 0; y < n; y++ ) 
+      order[y] = y;
+
+   std::sort( order.begin(), order.end(), detail::by_degree( degree ) );
+}
+
+/*!
+ * Orders nodes as they are visited by a breadth-first visit following arcs forward,
+ * started from node 0 and then from the lowest-numbered node not yet visited, until all
+ * nodes are visited. g must have been loaded with offsets (graph::load).
+ */
+void bfs_order( const bv_graph::graph& g, std::vector<int>& order );
+
+/*!
+ * A Layered Label Propagation ordering (Boldi, Rosa, Santini and Vigna, 2011).
+ *
+ * For each resolution gamma, label propagation is run on the symmetrized graph: sweeping
+ * the nodes, each takes the label l maximizing k(l) - gamma * ( v(l) - k(l) ), where k(l)
+ * is the number of its neighbours with label l and v(l) the number of nodes with label l.
+ * Sweeps stop when fewer than one node in a thousand changes label, or after
+ * max_iterations. Small gammas give large clusters, large ones small clusters.
+ *
+ * Layers are then combined in the given order of gammas: nodes are stably sorted by
+ * cluster, clusters being placed where their first member was, so that each layer refines
+ * the order left by the previous ones.
+ *
+ * Out-arcs are read by sequential scans of g; in-arcs come from an in-memory transpose
+ * (4 bytes per arc). g may be loaded in any mode.
+ */
+void llp_order( const bv_graph::graph& g, std::vector<int>& order, 
+                const std::vector<double>& gammas, int max_iterations = 100, 
+                std::ostream* log = NULL );
+
+/** The default resolutions for llp_order: 0 and 2^-i for i = 0 .. 10 . */
+std::vector<double> default_gammas();
+
+} }
+
+#endif /*ORDERING_HPP_*/
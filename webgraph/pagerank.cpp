@@ -0,0 +1,311 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "pagerank.hpp"
+#include "transform.hpp"
+#include "parallel.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace webgraph { namespace pagerank {
+
+using namespace std;
+
+namespace {
+
+/*!
+ * State shared by the threads of a pull iteration. Blocks are claimed through blocks; the
+ * sums of each block go to their own slot of diff and dangling, and are added up in
+ * block order once all threads are done. Predecessors come from the in-memory transpose
+ * (offsets and preds) or, if transpose is not NULL, are decoded from it.
+ */
+template<class rank_type>
+struct pull_job {
+   parallel::chunks blocks;
+   double alpha;
+   double base;
+
+   const bv_graph::graph* transpose;
+   const vector<long>* offsets;
+   const vector<int>* preds;
+   const vector<int>* outdegree;
+   vector<rank_type>* rank;
+   const vector<rank_type>* contrib;
+   vector<rank_type>* next_contrib;
+
+   vector<double> diff;
+   vector<double> dangling;
+
+   /** Computes the new rank of the nodes of each claimed block, and their contribution to
+    * the next iteration. */
+   void iterate() {
+      const long* o = transpose == NULL ? &(*offsets)[0] : NULL;
+      const int* pr = transpose != NULL || (*preds).empty() ? NULL : &(*preds)[0];
+      const int* d = &(*outdegree)[0];
+      const rank_type* c = &(*contrib)[0];
+      rank_type* r = &(*rank)[0];
+      rank_type* nc = &(*next_contrib)[0];
+
+      bv_graph::graph::node_iterator i, end;
+      vector<unsigned int> succ;
+      long b, from, to, next = -1;
+
+      while( blocks.claim( b, from, to ) ) {
+         double block_diff = 0, block_dangling = 0;
+
+         // A single thread gets the blocks in order, and needs no offsets to go on.
+         if( transpose != NULL && from != next ) 
+            boost::tie( i, end ) = transpose->get_node_iterator( from );
+
+         for( long x = from; x < to; x++ ) {
+            double s = 0;
+
+            if( transpose != NULL ) {
+               const int k = bv_graph::successor_array( i, succ );
+
+               for( int j = 0; j < k; j++ ) 
+                  s += c[ succ[j] ];
+
+               ++i;
+            } else
+               for( const int* y = pr + o[x]; y != pr + o[x + 1]; ++y ) 
+                  s += c[ *y ];
+
+            const rank_type v = rank_type( alpha * s + base );
+
+            block_diff += fabs( double( v ) - double( r[x] ) );
+            r[x] = v;
+
+            if( d[x] == 0 ) {
+               block_dangling += v;
+               nc[x] = 0;
+            } else
+               nc[x] = v / d[x];
+         }
+
+         diff[b] = block_diff;
+         dangling[b] = block_dangling;
+         next = to;
+      }
+   }
+};
+
+/*!
+ * Fills outdegree with the outdegrees of g, scanning it with as many threads as its
+ * offsets allow.
+ */
+struct outdegree_job {
+   const bv_graph::graph* g;
+   parallel::chunks nodes;
+   int* outdegree;
+
+   void scan() {
+      long from, to;
+
+      while( nodes.claim( from, to ) ) {
+         bv_graph::graph::node_iterator i, end;
+         long x = from;
+
+         for( boost::tie( i, end ) = g->get_node_iterator( from ); x < to; ++i, ++x ) 
+            outdegree[x] = bv_graph::outdegree( i );
+      }
+   }
+};
+
+template<class rank_type>
+int compute_pull( const bv_graph::graph& g, vector<rank_type>& rank, 
+                  const pagerank_parameters& p, double* delta, ostream* log ) {
+   const long n = g.get_num_nodes();
+   int threads = max( 1, p.threads );
+
+   vector<long> offsets;
+   vector<int> preds;
+   vector<int> outdegree( n );
+
+   if( p.transpose == NULL ) {
+      transform::transpose_in_memory( g, offsets, preds, threads, log );
+
+      // Every source occurs in the transpose once per arc.
+      for( vector<int>::const_iterator y = preds.begin(); y != preds.end(); ++y ) 
+         outdegree[ *y ]++;
+   } else {
+      assert( p.transpose->get_num_nodes() == n );
+
+      outdegree_job degrees;
+      const int scan_threads = parallel::scan_threads( g, threads );
+
+      degrees.g = &g;
+      degrees.outdegree = &outdegree[0];
+      degrees.nodes.reset( n, scan_threads );
+      parallel::run( scan_threads, &degrees, &outdegree_job::scan );
+
+      threads = parallel::scan_threads( *p.transpose, threads );
+   }
+
+   vector<rank_type> contrib( n ), next_contrib( n );
+
+   pull_job<rank_type> job;
+   job.alpha = p.alpha;
+   job.transpose = p.transpose;
+   job.offsets = &offsets;
+   job.preds = &preds;
+   job.outdegree = &outdegree;
+   job.rank = &rank;
+   job.contrib = &contrib;
+   job.next_contrib = &next_contrib;
+   job.blocks.reset_fixed( n, BLOCK_SIZE );
+   job.diff.resize( job.blocks.count() );
+   job.dangling.resize( job.blocks.count() );
+
+   double dangling = 0;
+
+   for( long b = 0; b < job.blocks.count(); b++ ) {
+      double block_dangling = 0;
+
+      for( long x = b * BLOCK_SIZE; x < min( n, ( b + 1 ) * BLOCK_SIZE ); x++ ) 
+         if( outdegree[x] == 0 )
+            block_dangling += rank[x];
+         else
+            contrib[x] = rank[x] / outdegree[x];
+
+      dangling += block_dangling;
+   }
+
+   if( log != NULL && p.transpose != NULL )
+      *log << "Pulling from the transpose (" << threads << " threads)...\n";
+
+   int iterations = 0;
+   double diff = 0;
+
+   while( iterations < p.max_iterations ) {
+      job.base = ( 1 - p.alpha + p.alpha * dangling ) / n;
+      job.blocks.reset_fixed( n, BLOCK_SIZE );
+      parallel::run( threads, &job, &pull_job<rank_type>::iterate );
+
+      diff = dangling = 0;
+
+      for( long b = 0; b < job.blocks.count(); b++ ) {
+         diff += job.diff[b];
+         dangling += job.dangling[b];
+      }
+
+      contrib.swap( next_contrib );
+      iterations++;
+
+      if( log != NULL )
+         *log << "Iteration " << iterations << ": delta " << diff << "\n";
+
+      if( diff < p.tolerance )
+         break;
+   }
+
+   if( delta != NULL )
+      *delta = diff;
+
+   return iterations;
+}
+
+template<class rank_type>
+int compute_push( const bv_graph::graph& g, vector<rank_type>& rank, 
+                  const pagerank_parameters& p, double* delta, ostream* log ) {
+   const long n = g.get_num_nodes();
+
+   vector<rank_type> next( n );
+   vector<unsigned int> succ;
+
+   int iterations = 0;
+   double diff = 0;
+
+   while( iterations < p.max_iterations ) {
+      fill( next.begin(), next.end(), rank_type( 0 ) );
+
+      double dangling = 0;
+      bv_graph::graph::node_iterator i, end;
+      long x = 0;
+
+      for( boost::tie( i, end ) = g.get_node_iterator( 0 ); x < n; ++i, ++x ) {
+         const int d = bv_graph::successor_array( i, succ );
+
+         if( d == 0 ) {
+            dangling += rank[x];
+            continue;
+         }
+
+         const rank_type c = rank[x] / d;
+
+         for( int j = 0; j < d; j++ ) 
+            next[ succ[j] ] += c;
+      }
+
+      const double base = ( 1 - p.alpha + p.alpha * dangling ) / n;
+
+      diff = 0;
+
+      for( x = 0; x < n; x++ ) {
+         next[x] = rank_type( p.alpha * next[x] + base );
+         diff += fabs( double( next[x] ) - double( rank[x] ) );
+      }
+
+      rank.swap( next );
+      iterations++;
+
+      if( log != NULL )
+         *log << "Iteration " << iterations << ": delta " << diff << "\n";
+
+      if( diff < p.tolerance )
+         break;
+   }
+
+   if( delta != NULL )
+      *delta = diff;
+
+   return iterations;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template<class rank_type>
+int compute( const bv_graph::graph& g, vector<rank_type>& rank, 
+             const pagerank_parameters& p, double* delta, ostream* log ) {
+   const long n = g.get_num_nodes();
+
+   assert( p.alpha >= 0 && p.alpha < 1 );
+
+   rank.assign( n, rank_type( 1.0 / max( 1L, n ) ) );
+
+   if( delta != NULL )
+      *delta = 0;
+
+   if( n == 0 )
+      return 0;
+
+   if( p.pull || p.threads > 1 || p.transpose != NULL )
+      return compute_pull( g, rank, p, delta, log );
+   else
+      return compute_push( g, rank, p, delta, log );
+}
+
+template int compute<float>( const bv_graph::graph& g, vector<float>& rank, 
+                             const pagerank_parameters& p, double* delta, ostream* log );
+template int compute<double>( const bv_graph::graph& g, vector<double>& rank, 
+                              const pagerank_parameters& p, double* delta, ostream* log );
+
+} }
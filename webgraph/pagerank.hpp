@@ -0,0 +1,87 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef PAGERANK_HPP_
+#define PAGERANK_HPP_
+
+#include <vector>
+#include <iostream>
+
+#include "webgraph.hpp"
+
+/*!
+ * PageRank by power iteration, computed directly on compressed graphs.
+ *
+ * In push mode the graph is scanned sequentially once per iteration, and each node
+ * spreads its rank among its successors; only the rank vectors are kept in memory, so
+ * this works on graphs loaded with graph::load_sequential() or graph::load_offline().
+ *
+ * In pull mode each node sums the contributions of its predecessors, read from the
+ * transpose. Nodes are processed in blocks of BLOCK_SIZE, claimed by the threads one at a
+ * time; a block writes only its own ranks, so threads never contend. Push mode is
+ * sequential, so asking for more than one thread implies pull mode.
+ *
+ * Pull mode costs more memory than push mode. Unless pagerank_parameters::transpose is
+ * given, the transpose is built in memory (see transform::transpose_in_memory), which
+ * takes 4 bytes per arc and 8 per node, and decoding g with more than one thread needs g
+ * loaded with offsets. Given a compressed transpose, only the graph as loaded and 4 bytes
+ * per node of outdegrees are needed; it is decoded with more than one thread only if
+ * loaded with offsets. Either way, pull mode keeps three rank vectors instead of two.
+ *
+ * The rank of dangling nodes (nodes without successors) is spread uniformly over all nodes,
+ * as is the teleportation mass 1 - alpha. Sums over a block are accumulated in double and
+ * reduced block by block, in order, so the result does not depend on the number of
+ * threads.
+ */
+namespace webgraph { namespace pagerank {
+
+/// The number of consecutive nodes handled as a unit by pull mode.
+const long BLOCK_SIZE = 1 << 12;
+
+struct pagerank_parameters {
+   /// The damping factor.
+   double alpha;
+   /// Iteration stops when the l1 norm of the difference of two consecutive rank
+   /// vectors drops below this.
+   double tolerance;
+   int max_iterations;
+   /// Whether to iterate on the transpose; implied by threads > 1 or a transpose.
+   bool pull;
+   int threads;
+   /// The transpose of the graph, if available; otherwise pull mode builds it in memory.
+   const bv_graph::graph* transpose;
+
+   pagerank_parameters() : 
+      alpha( .85 ), tolerance( 1e-7 ), max_iterations( 100 ), pull( false ), threads( 1 ),
+      transpose( NULL ) {}
+};
+
+/*!
+ * Computes the PageRank of the nodes of g into rank, starting from the uniform vector;
+ * rank_type may be float or double. Returns the number of iterations performed, and the
+ * l1 norm of the last difference in delta if it is not NULL.
+ */
+template<class rank_type>
+int compute( const bv_graph::graph& g, std::vector<rank_type>& rank, 
+             const pagerank_parameters& p, double* delta = NULL, 
+             std::ostream* log = NULL );
+
+} }
+
+#endif /*PAGERANK_HPP_*/
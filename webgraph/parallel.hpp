@@ -0,0 +1,115 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef PARALLEL_HPP_
+#define PARALLEL_HPP_
+
+#include <algorithm>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+#include "webgraph.hpp"
+
+/*!
+ * The scaffolding shared by the multi-threaded algorithms: a range of items (usually
+ * nodes) is cut in chunks, which threads claim one at a time without locks, so that
+ * threads that get cheap chunks do more of them.
+ */
+namespace webgraph { namespace parallel {
+
+class chunks {
+private:
+   long n;
+   long size;
+   long next;
+
+public:
+   chunks() : n( 0 ), size( 1 ), next( 0 ) {}
+
+   /** Cuts [0, n) for the given number of threads: about 16 chunks per thread, of at
+    * least min_size items, or a single chunk for one thread. */
+   void reset( long n, int threads, long min_size = 1024 ) {
+      reset_fixed( n, threads > 1 ? std::max( min_size, n / ( 16L * threads ) ) 
+                   : std::max( 1L, n ) );
+   }
+
+   /** Cuts [0, n) in chunks of the given size. */
+   void reset_fixed( long n, long size ) {
+      this->n = n;
+      this->size = std::max( 1L, size );
+      next = 0;
+   }
+
+   long count() const {
+      return ( n + size - 1 ) / size;
+   }
+
+   /** Claims the next chunk, c, as the items in [from, to); returns false when done. */
+   bool claim( long& c, long& from, long& to ) {
+      c = __sync_fetch_and_add( &next, 1 );
+
+      from = c * size;
+      to = std::min( n, from + size );
+
+      return from < n;
+   }
+
+   bool claim( long& from, long& to ) {
+      long c;
+      return claim( c, from, to );
+   }
+};
+
+/** Runs f on the given number of threads, directly if there is one, and waits for all. */
+template<class function_type>
+void run( int threads, function_type f ) {
+   if( threads <= 1 ) {
+      f();
+      return;
+   }
+
+   boost::thread_group group;
+
+   for( int t = 0; t < threads; t++ ) 
+      group.create_thread( f );
+
+   group.join_all();
+}
+
+/** Runs (job->*what)() on the given number of threads. */
+template<class job_type>
+void run( int threads, job_type* job, void (job_type::*what)() ) {
+   run( threads, boost::bind( what, job ) );
+}
+
+/** The number of threads, out of those asked for, that can scan g from the middle:
+ * starting a node iterator anywhere requires all offsets. */
+inline int scan_threads( const bv_graph::graph& g, int threads ) {
+   return threads > 1 && g.get_offset_step() == 1 ? threads : 1;
+}
+
+/** The number of threads, out of those asked for, that can decode lists of g by random
+ * access at the same time: this is only safe with all offsets, or a decompressed graph. */
+inline int random_access_threads( const bv_graph::graph& g, int threads ) {
+   return threads > 1 && ( g.get_offset_step() == 1 || g.is_decompressed() ) ? threads : 1;
+}
+
+} }
+
+#endif /*PARALLEL_HPP_*/
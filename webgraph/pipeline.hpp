@@ -0,0 +1,132 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef PIPELINE_HPP_
+#define PIPELINE_HPP_
+
+#include <vector>
+#include <boost/utility.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+
+namespace webgraph { namespace parallel {
+
+/*!
+ * Items 0, 1, ... produced by worker threads and consumed in order by a single thread,
+ * as when a graph is parsed or generated piece by piece while it is being compressed.
+ * Workers take items in order, and stay at most twice as many items as there are threads
+ * ahead of the oldest item not yet released, which bounds the memory held by items
+ * waiting to be consumed.
+ *
+ * The items live with the owner of the pipeline, which should declare it after them: the
+ * destructor stops the workers, so the pipeline can be dropped before all items are
+ * consumed, but not after the items are gone.
+ */
+class ordered_pipeline : public boost::noncopyable {
+private:
+   boost::function<void (long)> produce;
+   std::vector<bool> ready;
+   long next;      // the next item to produce
+   long current;   // the oldest item not yet released
+   long window;
+   bool stopping;
+
+   boost::mutex mutex;
+   boost::condition produced, consumed;
+   boost::thread_group workers;
+
+   /** The body of a worker: produces items, in order, while they are within the window. */
+   void work() {
+      for( ;; ) {
+         long i;
+
+         {
+            boost::mutex::scoped_lock lock( mutex );
+
+            while( !stopping && next < (long)ready.size() && next >= current + window ) 
+               consumed.wait( lock );
+
+            if( stopping || next == (long)ready.size() )
+               return;
+
+            i = next++;
+         }
+
+         // Nobody else touches item i until it is marked as ready.
+         produce( i );
+
+         {
+            boost::mutex::scoped_lock lock( mutex );
+            ready[i] = true;
+         }
+
+         produced.notify_all();
+      }
+   }
+
+public:
+   ordered_pipeline() : next( 0 ), current( 0 ), window( 1 ), stopping( false ) {}
+
+   ~ordered_pipeline() {
+      {
+         boost::mutex::scoped_lock lock( mutex );
+         stopping = true;
+      }
+
+      consumed.notify_all();
+      workers.join_all();
+   }
+
+   /** Starts producing n items with the given number of threads, calling f( i ) to
+    * produce item i; can only be called once. */
+   void start( long n, int threads, boost::function<void (long)> f ) {
+      produce = f;
+      ready.assign( n, false );
+      window = 2 * threads;
+
+      for( int t = 0; t < threads; t++ ) 
+         workers.create_thread( boost::bind( &ordered_pipeline::work, this ) );
+   }
+
+   /** Waits until the oldest item not yet released is produced. */
+   void wait() {
+      boost::mutex::scoped_lock lock( mutex );
+
+      while( !ready[ current ] ) 
+         produced.wait( lock );
+   }
+
+   /** Releases the oldest item, which the consumer is done with, and lets the workers
+    * move on. */
+   void release() {
+      {
+         boost::mutex::scoped_lock lock( mutex );
+         current++;
+      }
+
+      consumed.notify_all();
+   }
+};
+
+} }
+
+#endif /*PIPELINE_HPP_*/
@@ -0,0 +1,330 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "random_walks.hpp"
+#include "bfs.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+
+namespace webgraph { namespace random_walks {
+
+using namespace std;
+
+namespace {
+
+typedef boost::uint64_t word;
+
+/** A 64-bit mix of a walker and a step, from the finalizer of SplitMix64. */
+inline word hash( word seed, word walker, word step ) {
+   word h = seed ^ ( walker * 0x9E3779B97F4A7C15ULL ) ^ ( ( step + 1 ) * 0xC2B2AE3D27D4EB4FULL );
+
+   h = ( h ^ ( h >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+   h = ( h ^ ( h >> 27 ) ) * 0x94D049BB133111EBULL;
+
+   return h ^ ( h >> 31 );
+}
+
+/** A double uniform in [0, 1) from the top 53 bits of h. */
+inline double uniform( word h ) {
+   return ( h >> 11 ) * ( 1.0 / 9007199254740992.0 );
+}
+
+struct walker {
+   int node;
+   int id;
+
+   bool operator<( const walker& other ) const {
+      return node < other.node || ( node == other.node && id < other.id );
+   }
+};
+
+/** Sorts walkers by bucket, with a counting sort, and then by node within each bucket. */
+void group( vector<walker>& walkers, vector<walker>& scratch, long n, int bucket_bits ) {
+   const long buckets = ( n >> bucket_bits ) + 1;
+   vector<long> start( buckets + 1 );
+
+   for( size_t w = 0; w < walkers.size(); w++ ) 
+      start[ ( walkers[w].node >> bucket_bits ) + 1 ]++;
+
+   for( long b = 0; b < buckets; b++ ) 
+      start[ b + 1 ] += start[b];
+
+   scratch.resize( walkers.size() );
+
+   vector<long> pos( start.begin(), start.end() - 1 );
+
+   for( size_t w = 0; w < walkers.size(); w++ ) 
+      scratch[ pos[ walkers[w].node >> bucket_bits ]++ ] = walkers[w];
+
+   for( long b = 0; b < buckets; b++ ) 
+      if( start[ b + 1 ] - start[b] > 1 ) 
+         sort( scratch.begin() + start[b], scratch.begin() + start[ b + 1 ] );
+
+   walkers.swap( scratch );
+}
+
+/*!
+ * State shared by the threads of a step. The sorted walkers are cut at bounds in chunks
+ * that do not split the walkers of a node, which threads claim one at a time, by number,
+ * through chunks. Walkers that stop get node -1; the visits of personalized PageRank
+ * walkers, as source index and node, go to the slot of their chunk.
+ */
+struct step_job {
+   const bv_graph::graph* g;
+   vector<walker>* walkers;
+   word seed;
+   word step;
+
+   // For personalized PageRank only.
+   bool restart;
+   double alpha;
+   const vector<int>* sources;
+   int walks_per_source;
+
+   vector<long> bounds;
+   parallel::chunks chunks;
+   vector< vector<word> > visits;
+
+   /** The node where w goes from x, which has outdegree d; s points to the successors of
+    * x if they have been decoded. */
+   int move( const walker& w, int x, int d, const int* s ) const {
+      if( d == 0 ) 
+         return restart ? (*sources)[ w.id / walks_per_source ] : -1;
+
+      const int i = hash( seed, w.id, 2 * step + 1 ) % d;
+
+      return s != NULL ? s[i] : g->successor( x, i );
+   }
+
+   void advance() {
+      bfs::accessor a( *g );
+      long c, from, to;
+
+      while( chunks.claim( c, from, to ) ) {
+         walker* w = &(*walkers)[0];
+         long i = bounds[c];
+
+         while( i < bounds[ c + 1 ] ) {
+            const int x = w[i].node;
+            long j = i + 1;
+
+            while( j < bounds[ c + 1 ] && w[j].node == x ) 
+               j++;
+
+            const int d = g->outdegree( x );
+            const int* s = NULL, *end;
+
+            if( d > 0 && j - i > 1 ) 
+               boost::tie( s, end ) = a.successors( x );
+
+            for( ; i < j; i++ ) {
+               if( restart && uniform( hash( seed, w[i].id, 2 * step ) ) >= alpha ) {
+                  w[i].node = -1;
+                  continue;
+               }
+
+               w[i].node = move( w[i], x, d, s );
+
+               if( restart ) 
+                  visits[c].push_back( word( w[i].id / walks_per_source ) << 32 | w[i].node );
+            }
+         }
+      }
+   }
+
+   /** Runs a step with the given number of threads, and removes stopped walkers. */
+   void run( int threads ) {
+      const long size = walkers->size();
+
+      if( size < 1024 )
+         threads = 1;
+
+      const long chunk = threads > 1 ? max( 64L, size / ( 16L * threads ) ) : max( 1L, size );
+
+      bounds.assign( 1, 0 );
+
+      while( bounds.back() < size ) {
+         long b = min( size, bounds.back() + chunk );
+
+         while( b < size && (*walkers)[b].node == (*walkers)[ b - 1 ].node ) 
+            b++;
+
+         bounds.push_back( b );
+      }
+
+      visits.resize( bounds.size() - 1 );
+      for( size_t c = 0; c < visits.size(); c++ ) 
+         visits[c].clear();
+
+      chunks.reset_fixed( bounds.size() - 1, 1 );
+      parallel::run( threads, this, &step_job::advance );
+   }
+};
+
+/** Prepares job to walk on g; returns the number of threads to use. */
+int prepare( step_job& job, const bv_graph::graph& g, const walk_parameters& p ) {
+   assert( g.get_offset_step() > 0 || g.is_decompressed() );
+   assert( p.bucket_bits >= 0 && p.bucket_bits < 31 );
+
+   job.g = &g;
+   job.seed = p.seed;
+   job.restart = false;
+
+   return parallel::random_access_threads( g, p.threads );
+}
+
+/** Removes the walkers that stopped. */
+void remove_stopped( vector<walker>& walkers ) {
+   size_t k = 0;
+
+   for( size_t w = 0; w < walkers.size(); w++ ) 
+      if( walkers[w].node != -1 ) 
+         walkers[ k++ ] = walkers[w];
+
+   walkers.resize( k );
+}
+
+/** Orders scores by decreasing value, and then by node. */
+bool by_score( const pair<int, double>& a, const pair<int, double>& b ) {
+   return a.second > b.second || ( a.second == b.second && a.first < b.first );
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void walk( const bv_graph::graph& g, const vector<int>& starts, int length, 
+           vector<int>& walks, const walk_parameters& p, ostream* log ) {
+   const long n = g.get_num_nodes();
+   const long stride = length + 1;
+
+   step_job job;
+   const int threads = prepare( job, g, p );
+
+   vector<walker> walkers( starts.size() ), scratch;
+
+   walks.assign( starts.size() * stride, -1 );
+
+   for( size_t w = 0; w < starts.size(); w++ ) {
+      assert( starts[w] >= 0 && starts[w] < n );
+
+      walkers[w].node = walks[ w * stride ] = starts[w];
+      walkers[w].id = w;
+   }
+
+   job.walkers = &walkers;
+
+   for( int t = 1; t <= length && !walkers.empty(); t++ ) {
+      group( walkers, scratch, n, p.bucket_bits );
+
+      job.step = t;
+      job.run( threads );
+
+      for( size_t w = 0; w < walkers.size(); w++ ) 
+         walks[ walkers[w].id * stride + t ] = walkers[w].node;
+
+      remove_stopped( walkers );
+
+      if( log != NULL )
+         *log << "Step " << t << ": " << walkers.size() << " walkers left\n";
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void personalized_pagerank( const bv_graph::graph& g, const vector<int>& sources, 
+                            int walks_per_source, double alpha, 
+                            vector< vector< pair<int, double> > >& ppr, int top, 
+                            const walk_parameters& p, ostream* log ) {
+   const long n = g.get_num_nodes();
+
+   assert( alpha >= 0 && alpha < 1 );
+   assert( walks_per_source > 0 );
+   assert( (double)sources.size() * walks_per_source < 2147483648.0 );
+
+   step_job job;
+   const int threads = prepare( job, g, p );
+
+   job.restart = true;
+   job.alpha = alpha;
+   job.sources = &sources;
+   job.walks_per_source = walks_per_source;
+
+   vector<walker> walkers( sources.size() * walks_per_source ), scratch;
+   vector<word> visits;
+
+   for( size_t w = 0; w < walkers.size(); w++ ) {
+      walkers[w].node = sources[ w / walks_per_source ];
+      walkers[w].id = w;
+
+      assert( walkers[w].node >= 0 && walkers[w].node < n );
+   }
+
+   job.walkers = &walkers;
+
+   for( int t = 0; !walkers.empty(); t++ ) {
+      group( walkers, scratch, n, p.bucket_bits );
+
+      job.step = t;
+      job.run( threads );
+
+      for( size_t c = 0; c < job.visits.size(); c++ ) 
+         visits.insert( visits.end(), job.visits[c].begin(), job.visits[c].end() );
+
+      remove_stopped( walkers );
+
+      if( log != NULL )
+         *log << "Step " << t + 1 << ": " << walkers.size() << " walkers left\n";
+   }
+
+   // Every walk visits its source first.
+   for( size_t k = 0; k < sources.size(); k++ ) 
+      visits.push_back( word( k ) << 32 | sources[k] );
+
+   sort( visits.begin(), visits.end() );
+
+   const double unit = ( 1 - alpha ) / walks_per_source;
+
+   ppr.assign( sources.size(), vector< pair<int, double> >() );
+
+   for( size_t i = 0; i < visits.size(); ) {
+      size_t j = i + 1;
+
+      while( j < visits.size() && visits[j] == visits[i] ) 
+         j++;
+
+      const int k = visits[i] >> 32, x = visits[i] & 0xFFFFFFFFu;
+      double count = j - i;
+
+      // Sources were added once, not once per walk.
+      if( x == sources[k] ) 
+         count += walks_per_source - 1;
+
+      ppr[k].push_back( make_pair( x, count * unit ) );
+      i = j;
+   }
+
+   for( size_t k = 0; k < sources.size(); k++ ) {
+      sort( ppr[k].begin(), ppr[k].end(), by_score );
+
+      if( top > 0 && (long)ppr[k].size() > top )
+         ppr[k].resize( top );
+   }
+}
+
+} }
@@ -0,0 +1,82 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef RANDOM_WALKS_HPP_
+#define RANDOM_WALKS_HPP_
+
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <boost/cstdint.hpp>
+
+#include "webgraph.hpp"
+
+/*!
+ * Random walks on compressed graphs, many walkers at a time.
+ *
+ * All walkers advance in lockstep. Before each step they are sorted into buckets of
+ * 2^bucket_bits consecutive nodes, and by node within a bucket, so the lists that a step
+ * decodes are close together in the graph file, and each is decoded once however many
+ * walkers stand on it. A walker alone on its node only needs the outdegree and the
+ * successor it draws, and the list is decoded up to that successor only (see
+ * graph::successor); otherwise the list is decoded once and shared. The graph must be
+ * loaded with offsets or decompressed.
+ *
+ * Buckets are handed out to the threads in chunks. Every random choice of a walker is a
+ * hash of the seed, of the walker and of the step, so results depend neither on the
+ * number of threads nor on how walkers are grouped.
+ */
+namespace webgraph { namespace random_walks {
+
+struct walk_parameters {
+   int threads;
+   boost::uint64_t seed;
+   int bucket_bits;
+
+   walk_parameters() : threads( 1 ), seed( 0 ), bucket_bits( 10 ) {}
+};
+
+/*!
+ * Walks length steps from each of the given nodes, moving to a uniformly chosen successor
+ * at each step. On return walks[ w * ( length + 1 ) + t ] is the node where walk w is
+ * after t steps, or -1 if it stopped earlier on a node without successors.
+ */
+void walk( const bv_graph::graph& g, const std::vector<int>& starts, int length, 
+           std::vector<int>& walks, const walk_parameters& p = walk_parameters(), 
+           std::ostream* log = NULL );
+
+/*!
+ * Estimates personalized PageRank by Monte Carlo (Avrachenkov et al., 2007): from each
+ * source, walks_per_source walks continue with probability alpha at each step, and jump
+ * back to the source from nodes without successors. The score of a node is 1 - alpha times
+ * its number of visits, over walks_per_source; all the nodes of a walk are counted, which
+ * gives a lower variance than counting only the last one.
+ *
+ * On return ppr[k] holds the nodes visited from sources[k] with their scores, by
+ * decreasing score, truncated to the first top if top is positive.
+ */
+void personalized_pagerank( const bv_graph::graph& g, const std::vector<int>& sources, 
+                            int walks_per_source, double alpha, 
+                            std::vector< std::vector< std::pair<int, double> > >& ppr, 
+                            int top = 0, const walk_parameters& p = walk_parameters(), 
+                            std::ostream* log = NULL );
+
+} }
+
+#endif /*RANDOM_WALKS_HPP_*/
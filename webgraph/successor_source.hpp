@@ -0,0 +1,161 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef SUCCESSOR_SOURCE_HPP_
+#define SUCCESSOR_SOURCE_HPP_
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "csr_view.hpp"
+#include "../asciigraph/offline_graph.hpp"
+#include "../asciigraph/stream_graph.hpp"
+#include "../asciigraph/parallel_graph.hpp"
+
+namespace webgraph {
+
+/*!
+ * Adapts a graph type so that it can be scanned as a sequence of sorted successor lists,
+ * node 0 first. This is all bv_graph::graph::store needs from its input, so anything with
+ * a specialization of this class can be compressed.
+ *
+ * A specialization must provide
+ *
+ *   typedef ... node_iterator;
+ *   static long num_nodes( const graph_type& g );
+ *   static std::pair<node_iterator, node_iterator> nodes( const graph_type& g );
+ *   static int successors( const node_iterator& i, std::vector<unsigned int>& dest );
+ *
+ * where successors() copies the (strictly increasing) successor list of the node i points
+ * to into the front of dest, growing dest if needed, and returns its length. dest may be
+ * longer than the list on return.
+ *
+ * The specialization for bv_graph::graph lives in webgraph.hpp.
+ */
+template<class graph_type>
+struct successor_source_traits;
+
+////////////////////////////////////////////////////////////////////////////////
+template<>
+struct successor_source_traits<ascii_graph::offline_graph> {
+   typedef ascii_graph::offline_graph::node_iterator node_iterator;
+
+   static long num_nodes( const ascii_graph::offline_graph& g ) {
+      return g.get_num_nodes();
+   }
+
+   static std::pair<node_iterator, node_iterator> nodes( const ascii_graph::offline_graph& g ) {
+      return g.get_vertex_iterator();
+   }
+
+   static int successors( const node_iterator& i, std::vector<unsigned int>& dest ) {
+      const std::vector<ascii_graph::vertex_label_t>& s = ascii_graph::successors( i );
+
+      if( s.size() > dest.size() )
+         dest.resize( s.size() );
+
+      std::copy( s.begin(), s.end(), dest.begin() );
+
+      return s.size();
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+template<>
+struct successor_source_traits<ascii_graph::stream_graph> {
+   typedef ascii_graph::stream_graph::node_iterator node_iterator;
+
+   static long num_nodes( const ascii_graph::stream_graph& g ) {
+      return g.get_num_nodes();
+   }
+
+   static std::pair<node_iterator, node_iterator> nodes( const ascii_graph::stream_graph& g ) {
+      return g.get_vertex_iterator();
+   }
+
+   static int successors( const node_iterator& i, std::vector<unsigned int>& dest ) {
+      const std::vector<ascii_graph::vertex_label_t>& s = i.get_successors();
+
+      if( s.size() > dest.size() )
+         dest.resize( s.size() );
+
+      std::copy( s.begin(), s.end(), dest.begin() );
+
+      return s.size();
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+template<>
+struct successor_source_traits<ascii_graph::parallel_graph> {
+   typedef ascii_graph::parallel_graph::node_iterator node_iterator;
+
+   static long num_nodes( const ascii_graph::parallel_graph& g ) {
+      return g.get_num_nodes();
+   }
+
+   static std::pair<node_iterator, node_iterator> nodes( const ascii_graph::parallel_graph& g ) {
+      return g.get_vertex_iterator();
+   }
+
+   static int successors( const node_iterator& i, std::vector<unsigned int>& dest ) {
+      std::pair<const ascii_graph::vertex_label_t*, const ascii_graph::vertex_label_t*> s = 
+         i.get_successors();
+      unsigned int d = s.second - s.first;
+
+      if( d > dest.size() )
+         dest.resize( d );
+
+      std::copy( s.first, s.second, dest.begin() );
+
+      return d;
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+template<class offset_type, class target_type>
+struct successor_source_traits< csr_view<offset_type, target_type> > {
+   typedef csr_view<offset_type, target_type> view_type;
+   typedef typename view_type::node_iterator node_iterator;
+
+   static long num_nodes( const view_type& g ) {
+      return g.get_num_nodes();
+   }
+
+   static std::pair<node_iterator, node_iterator> nodes( const view_type& g ) {
+      return g.get_node_iterator( 0 );
+   }
+
+   static int successors( const node_iterator& i, std::vector<unsigned int>& dest ) {
+      typename view_type::succ_itor_pair s = i.get_owner()->get_successors( *i );
+      unsigned int d = s.second - s.first;
+
+      if( d > dest.size() )
+         dest.resize( d );
+
+      std::copy( s.first, s.second, dest.begin() );
+
+      return d;
+   }
+};
+
+}
+
+#endif /*SUCCESSOR_SOURCE_HPP_*/
@@ -0,0 +1,153 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "transform.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+
+namespace webgraph { namespace transform {
+
+using namespace std;
+
+namespace {
+
+/*!
+ * State shared by the threads of transpose_in_memory.
+ */
+struct transpose_job {
+   const bv_graph::graph* g;
+   parallel::chunks nodes;
+   bool concurrent;
+
+   vector<long>* offsets;
+   vector<long>* pos;
+   vector<int>* indegree;
+   vector<int>* targets;
+
+   /** Counts indegrees if fill is false, otherwise puts each arc in its place. */
+   void scan( bool fill ) {
+      vector<unsigned int> succ;
+      long from, to;
+
+      while( nodes.claim( from, to ) ) {
+         bv_graph::graph::node_iterator i, end;
+         long x = from;
+
+         for( boost::tie( i, end ) = g->get_node_iterator( from ); x < to; ++i, ++x ) {
+            int d = bv_graph::successor_array( i, succ );
+
+            if( !fill ) {
+               int* c = &(*indegree)[0];
+
+               if( concurrent )
+                  for( int j = 0; j < d; j++ ) 
+                     __sync_fetch_and_add( c + succ[j], 1 );
+               else
+                  for( int j = 0; j < d; j++ ) 
+                     c[ succ[j] ]++;
+            } else {
+               long* p = &(*pos)[0];
+               int* t = &(*targets)[0];
+
+               if( concurrent )
+                  for( int j = 0; j < d; j++ ) 
+                     t[ __sync_fetch_and_add( p + succ[j], 1 ) ] = x;
+               else
+                  for( int j = 0; j < d; j++ ) 
+                     t[ p[ succ[j] ]++ ] = x;
+            }
+         }
+      }
+   }
+
+   void count_indegrees() {
+      scan( false );
+   }
+
+   void place_arcs() {
+      scan( true );
+   }
+
+   /** Sorts the predecessor lists; only needed when arcs were placed concurrently. */
+   void sort_lists() {
+      long from, to;
+
+      while( nodes.claim( from, to ) ) 
+         for( long y = from; y < to; y++ ) 
+            sort( targets->begin() + (*offsets)[y], targets->begin() + (*offsets)[y + 1] );
+   }
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void transpose_in_memory( const bv_graph::graph& g, vector<long>& offsets, 
+                          vector<int>& targets, int threads, ostream* log ) {
+   const long n = g.get_num_nodes();
+
+   threads = parallel::scan_threads( g, threads );
+
+   transpose_job job;
+   job.g = &g;
+   job.concurrent = threads > 1;
+
+   vector<int> indegree( n );
+   vector<long> pos;
+
+   job.offsets = &offsets;
+   job.pos = &pos;
+   job.indegree = &indegree;
+   job.targets = &targets;
+
+   if( log != NULL )
+      *log << "Counting indegrees (" << threads << " threads)...\n";
+
+   job.nodes.reset( n, threads );
+   parallel::run( threads, &job, &transpose_job::count_indegrees );
+
+   offsets.resize( n + 1 );
+   offsets[0] = 0;
+   for( long y = 0; y < n; y++ ) 
+      offsets[y + 1] = offsets[y] + indegree[y];
+
+   vector<int>().swap( indegree );
+
+   pos.assign( offsets.begin(), offsets.end() - 1 );
+   targets.resize( offsets[n] );
+
+   if( log != NULL )
+      *log << "Placing " << offsets[n] << " arcs...\n";
+
+   job.nodes.reset( n, threads );
+   parallel::run( threads, &job, &transpose_job::place_arcs );
+
+   vector<long>().swap( pos );
+
+   // A single thread visits sources in order, so lists come out sorted already.
+   if( job.concurrent ) {
+      if( log != NULL )
+         *log << "Sorting predecessor lists...\n";
+
+      job.nodes.reset( n, threads );
+      parallel::run( threads, &job, &transpose_job::sort_lists );
+   }
+}
+
+} }
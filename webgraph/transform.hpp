@@ -0,0 +1,140 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef TRANSFORM_HPP_
+#define TRANSFORM_HPP_
+
+#include <vector>
+#include <iostream>
+#include <cassert>
+
+#include <boost/progress.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/tuple/tuple.hpp>
+
+#include "webgraph.hpp"
+#include "successor_source.hpp"
+#include "arc_list_builder.hpp"
+
+namespace webgraph { namespace transform {
+
+/*!
+ * Adds every arc of g, reversed, to b and finishes b, which can then be stored as the
+ * transpose of g. g is scanned once, sequentially; memory use is bounded by the batch
+ * size of b, so this works for graphs of any size.
+ *
+ * @param g any graph with a successor_source_traits specialization.
+ * @param b an empty builder.
+ * @param log a stream to report progress on, or <code>NULL</code>.
+ */
+template<class source_type>
+void transpose( const source_type& g, arc_list_builder& b, std::ostream* log = NULL ) {
+   typedef successor_source_traits<source_type> traits;
+
+   const long n = traits::num_nodes( g );
+   std::vector<unsigned int> succ;
+
+   boost::shared_ptr<boost::progress_display> pp;
+
+   if( log != NULL ) {
+      *log << "Transposing graph...\n";
+      pp.reset( new boost::progress_display( n, *log ) );
+   }
+
+   typename traits::node_iterator i, end;
+   long x = 0;
+
+   for( boost::tie( i, end ) = traits::nodes( g ); x < n && i != end; ++i, ++x ) {
+      int d = traits::successors( i, succ );
+
+      for( int j = 0; j < d; j++ ) 
+         b.add_arc( succ[j], x );
+
+      if( pp != NULL )
+         ++(*pp);
+   }
+
+   b.set_num_nodes( n );
+   b.finish();
+}
+
+/*!
+ * Renumbers the nodes of g: node x becomes perm[x]. Arcs are mapped and fed to b, which
+ * is then finished and can be stored as the permuted graph. As for transpose(), g is
+ * scanned once and only the permutation itself (4 bytes per node) and the batch of b are
+ * held in memory.
+ *
+ * @param g any graph with a successor_source_traits specialization.
+ * @param perm a permutation of 0 .. n - 1.
+ * @param b an empty builder.
+ * @param log a stream to report progress on, or <code>NULL</code>.
+ */
+template<class source_type>
+void permute( const source_type& g, const std::vector<int>& perm, arc_list_builder& b, 
+              std::ostream* log = NULL ) {
+   typedef successor_source_traits<source_type> traits;
+
+   const long n = traits::num_nodes( g );
+   std::vector<unsigned int> succ;
+
+   assert( (long)perm.size() == n );
+
+   boost::shared_ptr<boost::progress_display> pp;
+
+   if( log != NULL ) {
+      *log << "Permuting graph...\n";
+      pp.reset( new boost::progress_display( n, *log ) );
+   }
+
+   typename traits::node_iterator i, end;
+   long x = 0;
+
+   for( boost::tie( i, end ) = traits::nodes( g ); x < n && i != end; ++i, ++x ) {
+      int d = traits::successors( i, succ );
+
+      for( int j = 0; j < d; j++ ) 
+         b.add_arc( perm[x], perm[ succ[j] ] );
+
+      if( pp != NULL )
+         ++(*pp);
+   }
+
+   b.set_num_nodes( n );
+   b.finish();
+}
+
+/*!
+ * Builds the transpose of g in memory, in compressed sparse row form: on return
+ * offsets has n + 1 entries and the (sorted) predecessors of x are
+ * targets[ offsets[x] ] .. targets[ offsets[x+1] - 1 ]. Wrap the result in a csr_view to
+ * store it.
+ *
+ * g is decoded twice, once to count indegrees and once to place arcs. If g was loaded
+ * with offsets (graph::load), both passes are split among the given number of threads,
+ * each decoding its own range of nodes; otherwise a single thread is used.
+ *
+ * Memory use is 4 bytes per arc plus 16 bytes per node, on top of g itself.
+ */
+void transpose_in_memory( const bv_graph::graph& g, std::vector<long>& offsets, 
+                          std::vector<int>& targets, int threads = 1, 
+                          std::ostream* log = NULL );
+
+} }
+
+#endif /*TRANSFORM_HPP_*/
@@ -0,0 +1,383 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "triangles.hpp"
+#include "bfs.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_real.hpp>
+#include <boost/random/uniform_int.hpp>
+#include <boost/random/variate_generator.hpp>
+
+namespace webgraph { namespace triangles {
+
+using namespace std;
+
+namespace {
+
+/** Merges the sorted lists [a, a_end) and [b, b_end) into out, without duplicates and
+ * without x. */
+void merge_neighbours( int x, const int* a, const int* a_end, const int* b, const int* b_end,
+                       vector<int>& out ) {
+   out.clear();
+
+   while( a != a_end || b != b_end ) {
+      int y;
+
+      if( b == b_end || ( a != a_end && *a < *b ) ) 
+         y = *a++;
+      else if( a == a_end || *b < *a ) 
+         y = *b++;
+      else {
+         y = *a++;
+         b++;
+      }
+
+      if( y != x )
+         out.push_back( y );
+   }
+}
+
+/*!
+ * State shared by the threads of count(), which claim chunks of nodes; the scans decode g
+ * and the transpose from the start of each chunk in lockstep.
+ */
+struct triangle_job {
+   const bv_graph::graph* g;
+   const bv_graph::graph* t;
+   long n;
+   parallel::chunks nodes;
+
+   int* degree;
+   long* offsets;
+   int* targets;
+   long* per_node;
+   long total;
+
+   /** Whether the edge between x and y is oriented from x to y. */
+   bool oriented( int x, int y ) const {
+      return degree[x] < degree[y] || ( degree[x] == degree[y] && x < y );
+   }
+
+   /** Scans the neighbours of each node: in the first phase to compute degrees, in the
+    * second to count oriented edges (in offsets[x + 1]), in the third to place them. */
+   void scan( int phase ) {
+      vector<unsigned int> succ, pred;
+      vector<int> neighbours;
+      long from, to;
+
+      while( nodes.claim( from, to ) ) {
+         bv_graph::graph::node_iterator i, i_end, j, j_end;
+         long x = from;
+
+         boost::tie( i, i_end ) = g->get_node_iterator( from );
+         boost::tie( j, j_end ) = t->get_node_iterator( from );
+
+         for( ; x < to; ++i, ++j, ++x ) {
+            const int d = bv_graph::successor_array( i, succ );
+            const int e = bv_graph::successor_array( j, pred );
+            const int* s = d == 0 ? NULL : (const int*)&succ[0];
+            const int* p = e == 0 ? NULL : (const int*)&pred[0];
+
+            merge_neighbours( x, s, s + d, p, p + e, neighbours );
+
+            if( phase == 0 ) {
+               degree[x] = neighbours.size();
+               continue;
+            }
+
+            int* out = phase == 2 ? targets + offsets[x] : NULL;
+            long k = 0;
+
+            for( size_t l = 0; l < neighbours.size(); l++ ) 
+               if( oriented( x, neighbours[l] ) ) {
+                  if( out != NULL ) 
+                     out[k] = neighbours[l];
+                  k++;
+               }
+
+            if( phase == 1 ) 
+               offsets[ x + 1 ] = k;
+         }
+      }
+   }
+
+   void degrees() {
+      scan( 0 );
+   }
+
+   void count_oriented() {
+      scan( 1 );
+   }
+
+   void place_oriented() {
+      scan( 2 );
+   }
+
+   /** Intersects the oriented lists of the endpoints of each oriented edge out of the
+    * chunk; each common successor closes a triangle. */
+   void count_triangles() {
+      long from, to, local = 0;
+
+      while( nodes.claim( from, to ) ) 
+         for( long x = from; x < to; x++ ) 
+            for( long k = offsets[x]; k < offsets[ x + 1 ]; k++ ) {
+               const int y = targets[k];
+               const int* a = targets + offsets[x], *a_end = targets + offsets[ x + 1 ];
+               const int* b = targets + offsets[y], *b_end = targets + offsets[ y + 1 ];
+               long found = 0;
+
+               while( a != a_end && b != b_end ) {
+                  if( *a < *b ) 
+                     a++;
+                  else if( *b < *a ) 
+                     b++;
+                  else {
+                     __sync_fetch_and_add( per_node + *a, 1 );
+                     found++;
+                     a++;
+                     b++;
+                  }
+               }
+
+               if( found != 0 ) {
+                  __sync_fetch_and_add( per_node + x, found );
+                  __sync_fetch_and_add( per_node + y, found );
+                  local += found;
+               }
+            }
+
+      __sync_fetch_and_add( &total, local );
+   }
+
+   /** Runs what on the given number of threads, over chunks of nodes cut for them. */
+   void run( int threads, void (triangle_job::*what)() ) {
+      nodes.reset( n, threads );
+      parallel::run( threads, this, what );
+   }
+};
+
+/** Sets up job to scan g and t in chunks; returns the number of threads to use. */
+int prepare( triangle_job& job, const bv_graph::graph& g, const bv_graph::graph& t, 
+             int threads ) {
+   const long n = g.get_num_nodes();
+
+   assert( t.get_num_nodes() == n );
+
+   threads = parallel::scan_threads( t, parallel::scan_threads( g, threads ) );
+
+   job.g = &g;
+   job.t = &t;
+   job.n = n;
+   job.total = 0;
+
+   return threads;
+}
+
+/// The number of wedges sampled from the same generator.
+const long SAMPLE_BLOCK_SIZE = 1 << 12;
+
+/*!
+ * State shared by the threads of sample(). Samples are drawn in blocks of
+ * SAMPLE_BLOCK_SIZE, claimed through blocks; each block counts its closed wedges in its
+ * own slot.
+ */
+struct sample_job {
+   const bv_graph::graph* g;
+   const bv_graph::graph* t;
+   const vector<double>* cumulative;
+   boost::uint32_t seed;
+
+   parallel::chunks blocks;
+   vector<long> closed;
+
+   void run() {
+      bfs::accessor g_succ( *g ), t_succ( *t ), y_succ( *g ), z_succ( *g );
+      vector<int> neighbours;
+      long b, from, to;
+
+      while( blocks.claim( b, from, to ) ) {
+         boost::mt19937 rng( seed * 1000003u + (boost::uint32_t)b );
+         boost::uniform_real<double> unit( 0, 1 );
+         long block_closed = 0;
+
+         for( long k = from; k < to; k++ ) {
+            const double r = unit( rng ) * cumulative->back();
+            const int x = upper_bound( cumulative->begin(), cumulative->end(), r ) 
+               - cumulative->begin();
+            const int* s, *s_end, *p, *p_end;
+
+            boost::tie( s, s_end ) = g_succ.successors( x );
+            boost::tie( p, p_end ) = t_succ.successors( x );
+            merge_neighbours( x, s, s_end, p, p_end, neighbours );
+
+            const int d = neighbours.size();
+            boost::uniform_int<int> first( 0, d - 1 ), second( 0, d - 2 );
+            const int i = first( rng );
+            int j = second( rng );
+
+            if( j >= i )
+               j++;
+
+            const int y = neighbours[i], z = neighbours[j];
+
+            boost::tie( s, s_end ) = y_succ.successors( y );
+            boost::tie( p, p_end ) = z_succ.successors( z );
+
+            block_closed += binary_search( s, s_end, z ) || binary_search( p, p_end, y );
+         }
+
+         closed[b] = block_closed;
+      }
+   }
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long count( const bv_graph::graph& g, const bv_graph::graph& transpose, 
+            vector<long>& per_node, vector<int>& degree, int threads, ostream* log ) {
+   const long n = g.get_num_nodes();
+
+   triangle_job job;
+   threads = prepare( job, g, transpose, threads );
+
+   degree.assign( n, 0 );
+   per_node.assign( n, 0 );
+
+   vector<long> offsets( n + 1 );
+   vector<int> targets;
+
+   job.degree = &degree[0];
+   job.offsets = &offsets[0];
+   job.per_node = &per_node[0];
+
+   if( log != NULL )
+      *log << "Computing degrees (" << threads << " threads)...\n";
+
+   job.run( threads, &triangle_job::degrees );
+   job.run( threads, &triangle_job::count_oriented );
+
+   for( long x = 0; x < n; x++ ) 
+      offsets[ x + 1 ] += offsets[x];
+
+   targets.resize( offsets[n] );
+   job.targets = targets.empty() ? NULL : &targets[0];
+
+   if( log != NULL )
+      *log << "Orienting " << offsets[n] << " edges...\n";
+
+   job.run( threads, &triangle_job::place_oriented );
+
+   if( log != NULL )
+      *log << "Counting triangles...\n";
+
+   // Chunks of equal numbers of nodes can have very different costs here.
+   job.nodes.reset_fixed( n, threads > 1 ? max( 64L, n / ( 256L * threads ) ) : n );
+   parallel::run( threads, &job, &triangle_job::count_triangles );
+
+   if( log != NULL )
+      *log << job.total << " triangles.\n";
+
+   return job.total;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void local_clustering( const vector<long>& per_node, const vector<int>& degree, 
+                       vector<double>& coefficient ) {
+   coefficient.resize( degree.size() );
+
+   for( size_t x = 0; x < degree.size(); x++ ) 
+      coefficient[x] = degree[x] < 2 ? 0 
+         : 2.0 * per_node[x] / ( double( degree[x] ) * ( degree[x] - 1 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double wedges( const vector<int>& degree ) {
+   double w = 0;
+
+   for( size_t x = 0; x < degree.size(); x++ ) 
+      w += double( degree[x] ) * ( degree[x] - 1 ) / 2;
+
+   return w;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double sample( const bv_graph::graph& g, const bv_graph::graph& transpose, long samples, 
+               boost::uint32_t seed, int threads, double* transitivity, ostream* log ) {
+   const long n = g.get_num_nodes();
+
+   assert( g.get_offset_step() > 0 || g.is_decompressed() );
+   assert( transpose.get_offset_step() > 0 || transpose.is_decompressed() );
+
+   triangle_job job;
+   const int scan_threads = prepare( job, g, transpose, threads );
+   vector<int> degree( n );
+
+   job.degree = &degree[0];
+
+   if( log != NULL )
+      *log << "Computing degrees (" << scan_threads << " threads)...\n";
+
+   job.run( scan_threads, &triangle_job::degrees );
+
+   vector<double> cumulative( n );
+   double w = 0;
+
+   for( long x = 0; x < n; x++ ) 
+      cumulative[x] = w += double( degree[x] ) * ( degree[x] - 1 ) / 2;
+
+   if( transitivity != NULL )
+      *transitivity = 0;
+
+   if( w == 0 || samples <= 0 )
+      return 0;
+
+   threads = parallel::random_access_threads( transpose, 
+                                              parallel::random_access_threads( g, threads ) );
+
+   sample_job s;
+   s.g = &g;
+   s.t = &transpose;
+   s.cumulative = &cumulative;
+   s.seed = seed;
+   s.blocks.reset_fixed( samples, SAMPLE_BLOCK_SIZE );
+   s.closed.resize( s.blocks.count() );
+
+   if( log != NULL )
+      *log << "Sampling " << samples << " wedges (" << threads << " threads)...\n";
+
+   parallel::run( threads, &s, &sample_job::run );
+
+   long closed = 0;
+
+   for( long b = 0; b < s.blocks.count(); b++ ) 
+      closed += s.closed[b];
+
+   const double tau = double( closed ) / samples;
+
+   if( transitivity != NULL )
+      *transitivity = tau;
+
+   return tau * w / 3;
+}
+
+} }
@@ -0,0 +1,81 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef TRIANGLES_HPP_
+#define TRIANGLES_HPP_
+
+#include <vector>
+#include <iostream>
+#include <boost/cstdint.hpp>
+
+#include "webgraph.hpp"
+
+/*!
+ * Triangles and clustering coefficients of compressed graphs.
+ *
+ * Arcs are taken as undirected, and loops and parallel arcs are ignored: the neighbours of
+ * x are its successors and its predecessors, other than x itself. Predecessors come from
+ * the transpose, which must be given (pass g itself for a symmetric graph), and is scanned
+ * in lockstep with g; the two lists of each node are merged into a reused buffer, so
+ * decoding allocates nothing once the buffers have grown.
+ *
+ * Scans are split into ranges of nodes among the threads if both graphs were loaded with
+ * all offsets; otherwise a single thread scans them sequentially, so they need not fit in
+ * memory.
+ */
+namespace webgraph { namespace triangles {
+
+/*!
+ * Counts exactly the triangles of g. Each edge is oriented towards the endpoint of larger
+ * degree (ties broken by index), the oriented graph is built in memory (4 bytes per edge),
+ * and each triangle is then found once, intersecting the sorted oriented lists of the
+ * endpoints of each edge. Orientation keeps these lists short even around hubs.
+ *
+ * On return degree[x] is the number of neighbours of x and per_node[x] the number of
+ * triangles x belongs to. Returns the number of triangles.
+ */
+long count( const bv_graph::graph& g, const bv_graph::graph& transpose, 
+            std::vector<long>& per_node, std::vector<int>& degree, int threads = 1, 
+            std::ostream* log = NULL );
+
+/** Computes the local clustering coefficient of each node, 0 for nodes with less than two
+ * neighbours. */
+void local_clustering( const std::vector<long>& per_node, const std::vector<int>& degree, 
+                       std::vector<double>& coefficient );
+
+/** The number of wedges (paths of length two) of a graph with the given degrees. */
+double wedges( const std::vector<int>& degree );
+
+/*!
+ * Estimates the number of triangles of g from the given number of random wedges, centered
+ * on nodes chosen proportionally to their number of wedges: the fraction of closed wedges
+ * estimates the transitivity (three times the triangles over the wedges), which is stored
+ * in transitivity if it is not NULL. Only the degrees are computed by a scan, and the
+ * sampled lists are decoded by random access: both graphs must be loaded with offsets.
+ *
+ * Samples are drawn in fixed blocks, each from its own generator seeded by seed and its
+ * number, so the estimate does not depend on the number of threads.
+ */
+double sample( const bv_graph::graph& g, const bv_graph::graph& transpose, long samples, 
+               boost::uint32_t seed = 0, int threads = 1, double* transitivity = NULL, 
+               std::ostream* log = NULL );
+
+} }
+
+#endif /*TRIANGLES_HPP_*/
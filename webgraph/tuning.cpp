@@ -0,0 +1,268 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <iomanip>
+#include <fstream>
+#include <string>
+
+#include "tuning.hpp"
+#include "../properties/properties.hpp"
+#include "../utils/fast.hpp"
+
+namespace webgraph { namespace bv_graph {
+
+using namespace std;
+
+ostream& operator<<( ostream& out, const compression_parameters& p ) {
+   out << "window size " << p.window_size
+       << ", max ref count " << p.max_ref_count
+       << ", min interval length " << p.min_interval_length
+       << ", zeta k " << p.zeta_k
+       << ", flags 0x" << hex << p.flags << dec;
+
+   if( p.chain_weight != 0 ) 
+      out << ", chain weight " << p.chain_weight;
+
+   return out;
+}
+
+/*!
+ * Returns the number of bits the graph file of the sampled lists would take under the
+ * given parameters (see graph::estimate_bits).
+ */
+long long estimate_bits( const node_sample& s, const compression_parameters& p, 
+                         compression_stats* stats ) {
+   long long bits = 0;
+
+   for( int r = 0; r < s.num_runs(); r++ ) 
+      bits += graph::estimate_bits( s.get_lists( r ), s.get_first( r ), p.window_size, 
+                                    p.max_ref_count, p.min_interval_length, p.zeta_k, 
+                                    p.flags, stats, p.chain_weight );
+
+   return bits;
+}
+
+namespace {
+   using namespace compression_flags;
+
+   /** Candidate window sizes, in increasing order of compression and decoding cost. */
+   const int WINDOW_SIZES[] = { 0, 1, 2, 3, 4, 5, 7, 10, 16 };
+   /** 0 means no intervals at all. */
+   const int MIN_INTERVAL_LENGTHS[] = { 3, 0, 2, 4, 5, 8 };
+
+   /** A larger window is only worth it if it saves at least this fraction of the bits. */
+   const double MIN_WINDOW_GAIN = 0.005;
+
+   bool same( const compression_parameters& a, const compression_parameters& b ) {
+      return a.window_size == b.window_size && a.max_ref_count == b.max_ref_count
+         && a.min_interval_length == b.min_interval_length && a.zeta_k == b.zeta_k
+         && a.flags == b.flags && a.chain_weight == b.chain_weight;
+   }
+
+   /** Sets the coding of the flag-mask field starting at the given bit. */
+   int with_coding( int flags, int shift, int coding ) {
+      return ( flags & ~( 0xF << shift ) ) | ( coding << shift );
+   }
+
+   /*!
+    * A coordinate-descent search: each step varies a single parameter of the current
+    * best setting, and keeps the candidate with the fewest bits - or, for candidates
+    * listed in increasing order of decoding cost, the cheapest one within a tolerance.
+    */
+   class search {
+   private:
+      const node_sample& s;
+      ostream* log;
+
+   public:
+      compression_parameters best;
+      long long best_bits;
+
+      search( const node_sample& s, const compression_parameters& start, ostream* log ) :
+         s(s), log(log), best(start) {
+         best_bits = estimate_bits( s, best );
+      }
+
+      /** Returns true if the best setting changed. */
+      bool step( const char* what, const vector<compression_parameters>& cand, 
+                 double tolerance = 0 ) {
+         vector<long long> bits( cand.size() );
+         long long min_bits = best_bits;
+
+         for( unsigned i = 0; i < cand.size(); i++ ) 
+            min_bits = min( min_bits, bits[i] = estimate_bits( s, cand[i] ) );
+
+         unsigned chosen = 0;
+         while( chosen < cand.size() && bits[chosen] > min_bits * ( 1 + tolerance ) ) 
+            chosen++;
+
+         // Without a tolerance, ties keep the current setting.
+         bool changed = chosen < cand.size() && ( tolerance > 0 || bits[chosen] < best_bits )
+            && !same( cand[chosen], best );
+
+         if( changed ) {
+            best = cand[chosen];
+            best_bits = bits[chosen];
+         }
+
+         if( log != NULL ) 
+            *log << setw(22) << left << what << right << fixed << setprecision(3)
+                 << (double)best_bits / max( 1L, s.get_num_arcs() ) << " bits/link\n";
+
+         return changed;
+      }
+   };
+}
+
+/*!
+ * Chooses compression parameters for the graph the sample was drawn from.
+ *
+ * The window size, the minimum interval length, the residual coding (&zeta;<sub>1</sub>
+ * to &zeta;<sub>7</sub>, &gamma; or &delta;) and the codings of outdegrees, references,
+ * block counts and blocks are optimized in turn, repeating until nothing changes, by
+ * compressing the sample under each candidate. As a larger window slows down both
+ * compression and decoding, the smallest window within half a percent of the best one
+ * is preferred.
+ *
+ * @param s the sample.
+ * @param max_ref_count the bound on the length of reference chains, which is what
+ * limits the cost of random access (-1 for no bound, i.e. the smallest graph).
+ * @param chain_weight the reference chain weight, kept fixed (see graph::store).
+ * @param log a stream to report progress on, or <code>NULL</code>.
+ */
+compression_parameters tune( const node_sample& s, int max_ref_count, double chain_weight,
+                             ostream* log ) {
+   compression_parameters start;
+
+   start.chain_weight = chain_weight;
+
+   if( max_ref_count != -1 ) 
+      start.max_ref_count = max_ref_count;
+
+   if( log != NULL ) 
+      *log << "Tuning on " << s.get_num_nodes() << " nodes in " << s.num_runs() 
+           << " runs, " << s.get_num_arcs() << " arcs\n";
+
+   search srch( s, start, log );
+   bool changed = true;
+
+   for( int round = 0; changed && round < 3; round++ ) {
+      changed = false;
+      vector<compression_parameters> cand;
+
+      for( unsigned i = 0; i < sizeof( WINDOW_SIZES ) / sizeof( int ); i++ ) {
+         cand.push_back( srch.best );
+         cand.back().window_size = WINDOW_SIZES[i];
+      }
+      changed |= srch.step( "window size", cand, MIN_WINDOW_GAIN );
+
+      cand.clear();
+      for( unsigned i = 0; i < sizeof( MIN_INTERVAL_LENGTHS ) / sizeof( int ); i++ ) {
+         cand.push_back( srch.best );
+         cand.back().min_interval_length = MIN_INTERVAL_LENGTHS[i];
+      }
+      changed |= srch.step( "min interval length", cand );
+
+      cand.clear();
+      for( int k = 1; k <= 7; k++ ) {
+         cand.push_back( srch.best );
+         cand.back().zeta_k = k;
+         cand.back().flags = with_coding( cand.back().flags, 8, ZETA );
+      }
+      cand.push_back( srch.best );
+      cand.back().flags = with_coding( cand.back().flags, 8, GAMMA );
+      cand.push_back( srch.best );
+      cand.back().flags = with_coding( cand.back().flags, 8, DELTA );
+      changed |= srch.step( "residual coding", cand );
+
+      // Only the codings graph::string_to_flags understands are tried.
+      const int outdegree_codings[] = { GAMMA, DELTA };
+      const int reference_codings[] = { UNARY, GAMMA, DELTA };
+      const int block_codings[] = { GAMMA, DELTA };
+
+      cand.clear();
+      for( int i = 0; i < 2; i++ ) {
+         cand.push_back( srch.best );
+         cand.back().flags = with_coding( cand.back().flags, 0, outdegree_codings[i] );
+      }
+      changed |= srch.step( "outdegree coding", cand );
+
+      if( srch.best.window_size > 0 ) {
+         cand.clear();
+         for( int i = 0; i < 3; i++ ) {
+            cand.push_back( srch.best );
+            cand.back().flags = with_coding( cand.back().flags, 12, reference_codings[i] );
+         }
+         changed |= srch.step( "reference coding", cand );
+
+         cand.clear();
+         for( int i = 0; i < 3; i++ ) {
+            cand.push_back( srch.best );
+            cand.back().flags = with_coding( cand.back().flags, 16, reference_codings[i] );
+         }
+         changed |= srch.step( "block count coding", cand );
+
+         cand.clear();
+         for( int i = 0; i < 2; i++ ) {
+            cand.push_back( srch.best );
+            cand.back().flags = with_coding( cand.back().flags, 4, block_codings[i] );
+         }
+         changed |= srch.step( "block coding", cand );
+      }
+   }
+
+   if( log != NULL ) 
+      *log << "Chose " << srch.best << "\n";
+
+   return srch.best;
+}
+
+/*!
+ * Records in the property file of a graph compressed with tuned parameters what they
+ * were tuned for, and on how large a sample. The parameters themselves are already
+ * there.
+ *
+ * @param basename the basename of the graph.
+ * @param target a description of the target (e.g. "size").
+ * @param s the sample the parameters were tuned on.
+ * @param p the parameters chosen.
+ */
+void record_tuning( const string& basename, const string& target, const node_sample& s, 
+                    const compression_parameters& p ) {
+   properties props;
+   string name = basename + ".properties";
+
+   {
+      ifstream in( name.c_str() );
+      assert( in.good() );
+      props.load( in );
+   }
+
+   props.set_property( "autotune", target );
+   props.set_property( "autotunesamplenodes", utils::to_string( s.get_num_nodes() ) );
+   props.set_property( "autotunesampleruns", utils::to_string( s.num_runs() ) );
+   props.set_property( "autotunesamplebitsperlink", 
+                       utils::to_string( (double)estimate_bits( s, p ) / 
+                                         max( 1L, s.get_num_arcs() ) ) );
+
+   ofstream out( name.c_str() );
+   props.store( out, "BVGraph properties" );
+}
+
+} }
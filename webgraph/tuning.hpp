@@ -0,0 +1,160 @@
+/*               
+ *  Copyright (c) 2007, Jacob Ratkiewicz.
+ *
+ *  This program is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef TUNING_HPP_
+#define TUNING_HPP_
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <boost/random/linear_congruential.hpp>
+
+#include "webgraph.hpp"
+#include "successor_source.hpp"
+
+namespace webgraph { namespace bv_graph {
+
+/*!
+ * The parameters graph::store takes, bundled so that they can be searched over.
+ * -1 means "default", as in graph::store.
+ */
+struct compression_parameters {
+   int window_size;
+   int max_ref_count;
+   int min_interval_length;
+   int zeta_k;
+   int flags;
+   double chain_weight;
+
+   compression_parameters() : 
+      window_size( graph::DEFAULT_WINDOW_SIZE ),
+      max_ref_count( graph::DEFAULT_MAX_REF_COUNT ),
+      min_interval_length( graph::DEFAULT_MIN_INTERVAL_LENGTH ),
+      zeta_k( graph::DEFAULT_ZETA_K ),
+      flags( 0 ),
+      chain_weight( 0 ) {
+   }
+};
+
+std::ostream& operator<<( std::ostream& out, const compression_parameters& p );
+
+/*!
+ * A stratified sample of a graph: the node range is cut into a number of strata of equal
+ * size, and from each stratum a run of consecutive nodes is drawn at random, together
+ * with its successor lists. Runs (rather than isolated nodes) are needed because
+ * references and gaps depend on the neighbouring lists; strata make sure every part of
+ * the graph is represented, as the structure of crawls typically drifts along the node
+ * order.
+ *
+ * The source is scanned once, sequentially, and only the sampled lists are kept. If the
+ * graph has fewer nodes than the sample would, the whole graph is taken.
+ */
+class node_sample {
+public:
+   static const int DEFAULT_STRATA = 64;
+   static const int DEFAULT_RUN_LENGTH = 1000;
+
+   template<class source_type>
+   node_sample( const source_type& g, int strata = DEFAULT_STRATA, 
+                int run_length = DEFAULT_RUN_LENGTH, unsigned seed = 0 );
+
+   int num_runs() const {
+      return first.size();
+   }
+
+   int get_first( int r ) const {
+      return first[r];
+   }
+
+   const std::vector<std::vector<unsigned int> >& get_lists( int r ) const {
+      return lists[r];
+   }
+
+   long get_num_nodes() const {
+      return num_nodes;
+   }
+
+   long get_num_arcs() const {
+      return num_arcs;
+   }
+
+private:
+   std::vector<int> first;
+   std::vector<std::vector<std::vector<unsigned int> > > lists;
+   long num_nodes, num_arcs;
+};
+
+long long estimate_bits( const node_sample& s, const compression_parameters& p, 
+                         compression_stats* stats = NULL );
+
+compression_parameters tune( const node_sample& s, int max_ref_count = -1, 
+                             double chain_weight = 0, std::ostream* log = NULL );
+
+void record_tuning( const std::string& basename, const std::string& target, 
+                    const node_sample& s, const compression_parameters& p );
+
+template<class source_type>
+node_sample::node_sample( const source_type& g, int strata, int run_length, unsigned seed ) :
+   num_nodes(0), num_arcs(0) {
+   typedef successor_source_traits<source_type> traits;
+
+   long n = traits::num_nodes( g );
+
+   assert( strata > 0 && run_length > 0 );
+
+   if( n <= (long)strata * run_length ) {
+      first.push_back( 0 );
+      run_length = n;
+   } else {
+      boost::minstd_rand rng( seed + 1 );
+      long stratum = n / strata;
+      
+      for( int k = 0; k < strata; k++ ) {
+         long slack = std::max( 1L, stratum - run_length + 1 );
+         first.push_back( k * stratum + rng() % slack );
+      }
+   }
+
+   lists.resize( first.size() );
+
+   typename traits::node_iterator i, end;
+   std::vector<unsigned int> buf;
+   long x = 0;
+   unsigned r = 0;
+
+   for( boost::tie( i, end ) = traits::nodes( g );
+        x < n && i != end && r < first.size(); ++i, ++x ) {
+      if( x < first[r] ) 
+         continue;
+
+      int d = traits::successors( i, buf );
+
+      lists[r].push_back( std::vector<unsigned int>( buf.begin(), buf.begin() + d ) );
+      num_nodes++;
+      num_arcs += d;
+
+      if( x == first[r] + run_length - 1 ) 
+         r++;
+   }
+}
+
+} }
+
+#endif
@@ -37,12 +37,17 @@
  */
 
 #include <cassert>
+#include <cerrno>
+#include <cstring>
 #include <climits>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <algorithm>
 #include <iterator>
+#include <stdexcept>
+
+#include <unistd.h>
 
 #include <boost/filesystem/operations.hpp>
 #include <boost/regex.hpp>
@@ -63,6 +68,7 @@
 #include "iterators/utility_iterator_base.hpp"
 #include "iterators/iterator_wrappers.hpp"
 #include "iterators/empty_iterator.hpp"
+#include "iterators/array_iterator.hpp"
 
 //#define HARDCORE_DEBUG
 
@@ -554,14 +560,19 @@ int graph::outdegree( int x ) const {
       a BVGraph. To this purpose, we have special-purpose input bit stream that is
       used just to read outdegrees. */
 
+   if( is_decompressed() )
+      return decompressed_offsets[ x + 1 ] - decompressed_offsets[ x ];
+
    assert(offset_step > 0); // TODO do something better.
    // throw new IllegalStateException( "You cannot compute the outdegree of a random node
    //without offsets" ); 
 
-   // With all offsets, we just position and read.
+   // With all offsets, we just position and read. A private stream over the graph memory
+   // keeps this (and thus random access) safe to use from several threads at once.
    if ( offset_step == 1 ) {
-      outdegree_ibs.set_position( offset[ x ] );
-      return read_outdegree( outdegree_ibs );
+      ibitstream ibs( graph_memory_ptr );
+      ibs.set_position( offset[ x ] );
+      return read_outdegree( ibs );
    }
 
    // Otherwise, it could happen that the required outdegree is in the outdegree cache.
@@ -736,12 +747,48 @@ graph::succ_itor_pair graph::get_successors( int x ) const {
    
    // Lots of copying happens here.. but that's okay, because these are lightweight classes.
 
+   if( is_decompressed() ) {
+      assert( x < n );
+      std::pair<const int*, const int*> s = get_decompressed_successors( x );
+      internal_succ_itor_ptr p( new utility_iterators::array_iterator<int>( s.first, s.second ) );
+
+      return make_pair( iterator_wrappers::java_to_cpp<int>( p ), 
+                        iterator_wrappers::java_to_cpp<int>() );
+   }
+
    internal_succ_itor_ptr p = get_successors_internal( x );
 
    return make_pair( iterator_wrappers::java_to_cpp<int>( p ), 
                      iterator_wrappers::java_to_cpp<int>() );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/** Returns the successor of index i of a given node, decoding its list only up to it. The
+ * same conditions apply as for get_successors().
+ * 
+ * @param x a node.
+ * @param i an index smaller than the outdegree of x.
+ * @return the i-th successor of x.
+ */
+int graph::successor( int x, int i ) const {
+   assert( x >= 0 && i >= 0 );
+   assert( offset_step > 0 );
+
+   if( is_decompressed() ) {
+      assert( decompressed_offsets[x] + i < decompressed_offsets[x + 1] );
+      return decompressed_targets[ decompressed_offsets[x] + i ];
+   }
+
+   internal_succ_itor_ptr p = get_successors_internal( x );
+
+   if( i > 0 )
+      p->skip( i );
+
+   assert( p->has_next() );
+
+   return p->next();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /**
  * wrapper for get_successors_internal that saves us declaring the bogus vectors.
@@ -1069,6 +1116,113 @@ pair<node_iterator, node_iterator> graph::get_node_iterator( int from ) const {
 //    }
 }
    
+namespace {
+   /** Records value as an instance of component c, charging it the bits read since the
+    * last call. */
+   inline void record( compression_stats& st, compression_stats::component c, int value, 
+                       ibitstream& ibs, long& last ) {
+      long now = ibs.get_read_bits();
+      
+      st.add( c, value, (int)( now - last ) );
+      last = now;
+   }
+}
+
+/** Scans the graph file and records the statistics of each component, as graph::store
+ * would have done while compressing the graph. Only the outdegrees of the last
+ * {@link #window_size} nodes are kept, so the graph may be of any size; successor lists
+ * are never materialized. Offsets are not read, so that component stays empty.
+ *
+ * Works with any load method that does not rearrange the graph file (i.e. offset step
+ * -1, 0 or 1).
+ *
+ * @param st the statistics to add to.
+ * @param log a stream to report progress on, or <code>NULL</code>.
+ */
+void graph::scan_stats( compression_stats& st, ostream* log ) const {
+   assert( offset_step <= 1 );
+
+   boost::shared_ptr<ibitstream> ibs_ptr;
+
+   if( offset_step == -1 ) 
+      ibs_ptr.reset( new ibitstream( basename + ".graph", STD_BUFFER_SIZE ) );
+   else
+      ibs_ptr.reset( new ibitstream( graph_memory_ptr ) );
+
+   ibitstream& ibs = *ibs_ptr;
+
+   int cyclic_buffer_size = window_size + 1;
+   vector<int> outd( cyclic_buffer_size );
+   long last = ibs.get_read_bits();
+
+   boost::shared_ptr<boost::progress_display> pp;
+
+   if( log != NULL ) {
+      *log << "Scanning graph...\n";
+      pp.reset( new boost::progress_display( n, *log ) );
+   }
+
+   for( int x = 0; x < n; x++ ) {
+      if( pp != NULL )
+         ++(*pp);
+
+      int d = read_outdegree( ibs );
+      record( st, compression_stats::OUTDEGREES, d, ibs, last );
+
+      outd[ x % cyclic_buffer_size ] = d;
+
+      if( d == 0 ) 
+         continue;
+
+      int ref = 0, extra_count = d;
+
+      if( window_size > 0 ) {
+         ref = read_reference( ibs );
+         record( st, compression_stats::REFERENCES, ref, ibs, last );
+      }
+
+      if( ref > 0 ) {
+         int block_count = read_block_count( ibs );
+         record( st, compression_stats::BLOCK_COUNTS, block_count, ibs, last );
+
+         // As in get_successors_internal(): every other block is copied, and with an
+         // even block count the tail of the reference list is copied too.
+         int copied = 0, total = 0;
+
+         for( int i = 0; i < block_count; i++ ) {
+            int b = read_block( ibs );
+            record( st, compression_stats::BLOCKS, b, ibs, last );
+
+            total += b + ( i == 0 ? 0 : 1 );
+            if( i % 2 == 0 ) 
+               copied += b + ( i == 0 ? 0 : 1 );
+         }
+
+         if( block_count % 2 == 0 ) 
+            copied += outd[ ( x - ref + cyclic_buffer_size ) % cyclic_buffer_size ] - total;
+
+         extra_count = d - copied;
+      }
+
+      if( extra_count > 0 && min_interval_length != NO_INTERVALS ) {
+         int interval_count = ibs.read_gamma();
+         record( st, compression_stats::INTERVAL_COUNTS, interval_count, ibs, last );
+
+         for( int i = 0; i < interval_count; i++ ) {
+            record( st, compression_stats::INTERVALS, ibs.read_gamma(), ibs, last );
+
+            int l = ibs.read_gamma();
+            record( st, compression_stats::INTERVALS, l, ibs, last );
+
+            extra_count -= l + min_interval_length;
+         }
+      }
+
+      for( int i = 0; i < extra_count; i++ ) 
+         record( st, compression_stats::RESIDUALS, read_residual( ibs ), ibs, last );
+   }
+}
+   
 /* The following private methods handle the flag mask. They are the only methods which
  * replicate the shifting logic specified in the flag-mask definition.
  */
@@ -1275,6 +1429,10 @@ void graph::load_internal( string basename, int offset_step, std::ostream* log )
      
    if ( props.has_property( "zetak" ) ) 
       zeta_k = atoi( props.get_property( "zetak" ).c_str() );
+
+   // Not needed to decode, but append() must keep choosing references the same way.
+   if ( props.has_property( "chainweight" ) ) 
+      chain_weight = atof( props.get_property( "chainweight" ).c_str() );
    
    // Soft check due to previous usage of toString() instead of getName() This will
    // fail if the graph is not anything but a bv graph, but whatever.  //if ( !
@@ -1356,7 +1514,6 @@ void graph::load_internal( string basename, int offset_step, std::ostream* log )
          long off = 0;
          for( i = 0; i <= n; i++ ) {
             offset[ i ] = off = read_offset( offset_ibs ) + off;
-            cerr << "offset[" << i << "] = " << offset[i] << endl;
          }
             
          //pm.stop();
@@ -1570,7 +1727,7 @@ int graph::differentially_compress( obitstream& obs, int curr_node, int ref,
    long written_bits_at_start = obs.get_written_bits();
 
    // We build the list of blocks copied and skipped (alternatively) from the previous list.
-   int i, j = 0, k = 0, prev = 0, curr_block_len = 0;
+   int i, j = 0, k = 0, prev = 0, curr_block_len = 0, t;
    bool copying = true;
 
    // This guarantees that we will not try to differentially compress when ref == 0.
@@ -1647,32 +1804,33 @@ int graph::differentially_compress( obitstream& obs, int curr_node, int ref,
    // We store locally the resulting arrays for faster access.
    int block_count = blocks.size(), extra_count = extras.size();
 
+   // Statistics are only kept for what is really written.
+   compression_stats* st = for_real ? stats : NULL;
+
    // If we have a nontrivial reference window we write the reference to the reference list.
-   if ( window_size > 0 ) 
-      write_reference( obs, ref );
+   if ( window_size > 0 ) {
+      t = write_reference( obs, ref );
+      if ( st != NULL ) st->add( compression_stats::REFERENCES, ref, t );
+   }
 
 #ifndef CONFIG_FAST
    lg() << LEVEL_EVERYTHING << "Just called write_reference().\n";
 #endif
 
-//   if ( STATS && for_real ) reference_stats.println( ref );
-
    // Then, if the reference is not void we write the length of the copy list.
    if ( ref != 0 ) {
-      write_block_count( obs, block_count );
-             
-//      if ( STATS && forReal ) blockCountStats.println( blockCount );
+      t = write_block_count( obs, block_count );
+      if ( st != NULL ) st->add( compression_stats::BLOCK_COUNTS, block_count, t );
 
       // Then, we write the copy list; all lengths except the first one are decremented.
       if ( block_count > 0 ) {
-         write_block( obs, blocks[ 0 ] );
-         for( i = 1; i < block_count; i++ ) 
-            write_block( obs, blocks[ i ] - 1 );
-
-//          if ( STATS && forReal ) {
-//             blockStats.println( block[ 0 ] ); 
-//             for( i = 1; i < blockCount; i++ ) blockStats.println( block[ i ] - 1 );
-//          }
+         t = write_block( obs, blocks[ 0 ] );
+         if ( st != NULL ) st->add( compression_stats::BLOCKS, blocks[ 0 ], t );
+
+         for( i = 1; i < block_count; i++ ) {
+            t = write_block( obs, blocks[ i ] - 1 );
+            if ( st != NULL ) st->add( compression_stats::BLOCKS, blocks[ i ] - 1, t );
+         }
       }
    }
 
@@ -1691,32 +1849,21 @@ int graph::differentially_compress( obitstream& obs, int curr_node, int ref,
          int interval_count = intervalize( extras, min_interval_length, left, len, residuals );
                      
          // We write the number of intervals.
-         obs.write_gamma( interval_count );
-                     
-//         if ( STATS && forReal ) intervalCountStats.println( intervalCount );
+         t = obs.write_gamma( interval_count );
+         if ( st != NULL ) st->add( compression_stats::INTERVAL_COUNTS, interval_count, t );
                      
          // We write out the intervals.
          for( i = 0; i < interval_count; i++ ) {
-            if ( i == 0 ) {
-               prev = left[i];
-               obs.write_gamma( utils::int2nat( prev - curr_node ) );
-            }
-            else 
-               obs.write_gamma( left[i] - prev - 1 );
+            int gap = ( i == 0 ) ? utils::int2nat( left[i] - curr_node ) : left[i] - prev - 1;
+
+            t = obs.write_gamma( gap );
+            if ( st != NULL ) st->add( compression_stats::INTERVALS, gap, t );
 
             prev = left[i] + len[i];
-            obs.write_gamma( len[ i ] - min_interval_length );
+            t = obs.write_gamma( len[ i ] - min_interval_length );
+            if ( st != NULL ) st->add( compression_stats::INTERVALS, len[ i ] - min_interval_length, t );
          }
                      
-//          if ( STATS && forReal ) 
-//             for( i = 0; i < intervalCount; i++ ) {
-//                if ( i == 0 ) leftStats.println( Fast.int2nat( ( prev = left.getInt( i ) ) - currNode ) );
-//                else leftStats.println( left.getInt( i ) - prev - 1 );
-//                prev = left.getInt( i ) + len.getInt( i );
-//                lenStats.println( len.getInt( i ) - min_interval_length );
-//             }
-                     
-                     
          residual = residuals;
          residual_count = residuals.size();
       }
@@ -1729,8 +1876,6 @@ int graph::differentially_compress( obitstream& obs, int curr_node, int ref,
       lg() << LEVEL_EVERYTHING << "Done writing extras.\n";
 #endif
                               
-//      if ( STATS && forReal ) residualCountStats.println( residualCount );
-
       // Now we write out the residuals, if any
       if ( residual_count != 0 ) {
          prev = residual[0];
@@ -1738,7 +1883,8 @@ int graph::differentially_compress( obitstream& obs, int curr_node, int ref,
          lg() << LEVEL_EVERYTHING << "about to write residual "
               << utils::int2nat( prev ) << " (used int2nat)\n";
 #endif
-         write_residual( obs, utils::int2nat( prev - curr_node ) );
+         t = write_residual( obs, utils::int2nat( prev - curr_node ) );
+         if ( st != NULL ) st->add( compression_stats::RESIDUALS, utils::int2nat( prev - curr_node ), t );
 
          for( i = 1; i < residual_count; i++ ) {
 //             if ( residual[ i ] == prev ) 
@@ -1749,17 +1895,10 @@ int graph::differentially_compress( obitstream& obs, int curr_node, int ref,
             lg() << LEVEL_EVERYTHING << "about to write residual "
                  << residual[i] - prev - 1 << "\n";
 #endif
-            write_residual( obs, residual[ i ] - prev - 1 );
+            t = write_residual( obs, residual[ i ] - prev - 1 );
+            if ( st != NULL ) st->add( compression_stats::RESIDUALS, residual[ i ] - prev - 1, t );
             prev = residual[ i ];
          }
-             
-//          if ( STATS && forReal ) {
-//             residualStats.println( Fast.int2nat( ( prev = residual[ 0 ] ) - currNode ) );
-//             for( i = 1; i < residualCount; i++ ) {
-//                residualStats.println( residual[ i ] - prev - 1 );
-//                prev = residual[ i ];
-//             }
-//          }
       }             
    }
 
@@ -1770,492 +1909,152 @@ int graph::differentially_compress( obitstream& obs, int curr_node, int ref,
    return (int)( obs.get_written_bits() - written_bits_at_start );
 }
 
-/** Writes the given graph using a given base name.
- *
- * @param graph a graph to be compressed.
- * @param basename a base name.
- * @param window_size the window size (-1 for the default value).
- * @param maxRefCount the maximum reference count (-1 for the default value).
- * @param min_interval_length the minimum interval length (-1 for the default value).
- * @param zeta_k the parameter used for residual &zeta;-coding, if used (-1 for the default value).
- * @param flags the flag mask.
- * @param pm a progress meter to measure the state of compression, or <code>null</code> if no metering is required.
- * @throws IOException if some exception is raised while writing the graph.
- *
- * TODO this must be re-written to deal with Boost 
- */
-//void graph::store( 
-//    boost::shared_ptr<graph> g, string basename,
-//    int window_size, int max_ref_count, int min_interval_length, 
-//    int zeta_k, int flags, ostream* log = NULL ) {
-//      BVGraph g = new BVGraph();
-//
-//      if ( window_size != -1 ) g.window_size = window_size;
-//      if ( maxRefCount != -1 ) g.maxRefCount = maxRefCount;
-//      if ( min_interval_length != -1 ) g.min_interval_length = min_interval_length;
-//      if ( zeta_k != -1 ) g.zeta_k = zeta_k;
-//      g.setFlags( flags );
-//      g.storeInternal( graph, basename, pm );
-//}
-
-////////////////////////////////////////////////////////////////////////////////
-/** Writes an offline_graph using the given base name
- *
- * @param graph a graph to be compressed.
- * @param basename a base name.
- * @param window_size the window size (-1 for the default value).
- * @param maxRefCount the maximum reference count (-1 for the default value).
- * @param min_interval_length the minimum interval length (-1 for the default value).
- * @param zeta_k the parameter used for residual &zeta;-coding, if used (-1 for the default value).
- * @param flags the flag mask.
- * @param pm a progress meter to measure the state of compression, or <code>null</code> if no metering is required.
- * @throws IOException if some exception is raised while writing the graph.
- *
- * TODO throw this away eventually.
- */
-void graph::store_offline_graph( 
-   webgraph::ascii_graph::offline_graph g, string basename,
-   int window_size, int max_ref_count, int min_interval_length, 
-   int zeta_k, int flags, ostream* log ) {
-
-#ifndef CONFIG_FAST      
-   register_logger( "webgraph", LEVEL_MAX );
-
-   lg() << LEVEL_DEBUG << "store_offline_graph( " << basename << ", " << window_size << ", "
-        << max_ref_count << ", " << min_interval_length << ", " 
-        << zeta_k << ", " << flags << ") " << "\n";
-#endif
-
-   boost::shared_ptr<graph> me( new graph() );  
-    
-   if ( window_size != -1 ) 
-      me->window_size = window_size;
-      
-   if ( max_ref_count != -1 ) 
-      me->max_ref_count = max_ref_count;
-      
-   if ( min_interval_length != -1 ) 
-      me->min_interval_length = min_interval_length;
-    
-   if ( zeta_k != -1 ) 
-      me->zeta_k = zeta_k;
-      
-   me->set_flags( flags );
-   // TODO change this
-   me->store_offline_graph_internal( g, basename, log );
-}
-
 ////////////////////////////////////////////////////////////////////////////////
-/** Writes the given graph <code>graph</code> using a given base
- * name, and the compression parameters and flags of this
- * graph object. Note that the latter is relevant only as far
- * as parameters and flags are concerned; its content is
- * really irrelevant.
+/** Compresses the (nonempty) successor list of <code>curr_node</code>, which must
+ * already be in the cyclic window <code>lst</code>, choosing as reference the list in
+ * the window that gives the smallest output among those whose reference count is below
+ * {@link #max_ref_count}. The outdegree must already have been written.
  *
- * @param graph a graph to be compressed.
- * @param basename a base name.
- * @param pm a progress meter to measure the state of compression, or
- * <code>null</code> if no metering is required.
- * @throws IOException if some exception is raised while writing the graph.
- * 
- * TODO use this version eventually.
- */
-//template<typename graph_type>
-//void graph::store_internal( graph_type* graph, string basename, ostream* log ) {
-//   // Used for differential compression
-//   obitstream bit_count( NullOutputStream.getInstance(), 0  ); // wtf does this do
-//
-//   int outd, curr_node, curr_index, j, best, best_index, cand, t = 0, n = graph->get_num_nodes();
-//   long bit_offset = 0;
-//
-//   obitstream graph_obs( basename + ".graph", STD_BUFFER_SIZE );
-//   obitstream offset_obs( basename + ".offsets", STD_BUFFER_SIZE );
-//
-//   //    if ( STATS ) {
-//   //       offsetStats = new PrintWriter( new FileWriter( basename + ".offsetStats" ) );
-//   //       referenceStats = new PrintWriter( new FileWriter( basename + ".referenceStats" ) );
-//   //       outdegreeStats = new PrintWriter( new FileWriter( basename + ".outdegreeStats" ) );
-//   //       blockCountStats = new PrintWriter( new FileWriter( basename + ".blockCountStats" ) );
-//   //       blockStats = new PrintWriter( new FileWriter( basename + ".blockStats" ) );
-//   //       intervalCountStats = new PrintWriter( new FileWriter( basename + ".intervalCountStats" ) );
-//   //       leftStats = new PrintWriter( new FileWriter( basename + ".leftStats" ) );
-//   //       lenStats = new PrintWriter( new FileWriter( basename + ".lenStats" ) );
-//   //       residualCountStats = new PrintWriter( new FileWriter( basename + ".residualCountStats" ) );
-//   //       residualStats = new PrintWriter( new FileWriter( basename + ".residualStats" ) );
-//   //    }
-//
-//   int cyclic_buffer_size = window_size + 1;
-//
-//   // Cyclic array of previous lists.
-//   int lst[][] = new int[ cyclic_buffer_size ][ INITIAL_SUCCESSOR_LIST_LENGTH ];
-//
-//   // For each list, its length.
-//   int list_len[] = new int[ cyclic_buffer_size ];
-//
-//   // For each list, the depth of its references.
-//   int ref_count[] = new int[ cyclic_buffer_size ];
-//   
-//   long tot_ref = 0, tot_dist = 0, tot_links = 0;
-//
-//   //    if ( pm != null ) {
-//   //       System.err.print( "Storing..." );
-//   //       pm.itemsName( "nodes" );
-//   //       pm.expectedUpdates( n );
-//   //       pm.start();
-//   //    }
-//
-//   // We iterate over the nodes of graph
-//   graph_type::node_iterator node_itor, node_itor_end;
-//   for ( tie( node_itor, node_itor_end) = graph.get_node_iterator(); 
-//       node_itor != node_itor_end;
-//       ++node_itor ) {
-//      // curr_node is the currently examined node, of outdegree outd, with index currIndex
-//      // (within the cyclic array)
-//      curr_node = *node_itor;
-//      
-//      // TODO get this to work with both asciigraph, bvgraph, and BGL
-//      // find the lcd and stick with it....
-//      outd = outdegree(node_itor); // get the number of successors of currNode
-//      curr_index = curr_node % cyclic_buffer_size;
-//
-//      
-//      // We write the current offset to the offset stream
-//      write_offset( offset_obs, (int)( graph_obs.written_bits() - bit_offset ) );
-//
-//      //      if ( STATS ) offsetStats.println( graphObs.written_bits() - bit_offset );
-//
-//      bit_offset = graph_obs.written_bits();
-//
-//      // We write the node outdegree
-//      write_outdegree( graph_obs, outd );
-//
-//      //      if ( STATS ) outdegreeStats.println( outd );
-//
-//      if ( outd > lst[ curr_index ].size() ) 
-//       lst[ curr_index ].resize( outd );
-//
-//      // The successor list we are going to compress and write out
-//      lst[curr_index] = successors_vector( node_itor );
-//      list_len[ curr_index ] = outd;
-//
-//      if ( outd > 0 ) {
-//      
-//       // Now we check the best candidate for compression.
-//       best = std::numeric_limits<int>::max();
-//       best_index = -1;
-//      
-//       ref_count[ curr_index ] = -1;
-//      
-//       for( j = 0; j < cyclic_buffer_size; j++ ) {
-//          cand = ( currNode - j + cyclicBufferSize ) % cyclicBufferSize;
-//          if ( ref_count[ cand ] < max_ref_count && list_len[ cand ] != 0
-//               && ( t = diff_comp( bit_count, curr_node, j, lst[ cand ], 
-//                                   list_len[ cand ], lst[ curr_index ], 
-//                                   list_len[ curr_index ], false ) ) < best ) {
-//             best = t;
-//             best_index = cand;
-//          }
-//       }
-//    
-//       assert( best_index >= 0 );
-//      
-//       ref_count[ curr_index ] = ref_count[ best_index ] + 1;
-//      
-//       diff_comp( graph_obs, curr_node, ( curr_node - best_index + cyclic_buffer_size ) % 
-//                  cyclic_buffer_size, lst[ best_index ], 
-//                  list_len[ best_index ], lst[ curr_index ], list_len[ curr_index], true );
-//                             
-//       tot_links += outd;
-//       tot_ref += ref_count[ curr_index ];
-//       tot_dist += ( curr_node - best_index + cyclic_buffer_size ) % cyclic_buffer_size;
-//      }
-//    
-//      
-//      if ( ( curr_node + 1 ) % 1000000 == 0 ) 
-//       *out << "[" <<
-//            << "bits/link=" << (double)graph_obs.written_bits() / ((tot_links != 0) ? 
-//                                                                   tot_links : 1 )
-//            << ", bits/node=" << (double)graph_obs.written_bits() / ( curr_node )
-//            << ", avgref=" << ( double )tot_ref / curr_node
-//            << ", avgdist=" << ( double )tot_dist / curr_node
-//            << "]" << endl;
-//
-//      //if ( pm != null ) pm.update();
-//   }
-//  
-//   // We write the final offset to the offset stream.
-//   write_offset( offset_obs, (int)( graph_obs.written_bits() - bit_offset ) );
-//  
-//   graph_obs.close();
-//   offset_obs.close();
-//
-//   //   if ( pm != null ) {
-//   //      pm.stop();
-//   //      System.err.println( " done." );
-//   //      System.err.println( pm );
-//   //   }
-//
-//   // Finally, we save all data related to this graph in a property file.
-//   // TODO chekc these names
-//   properties props = new properties();
-//   props.set_property( "basename", basename );
-//   props.set_property( "nodes", to_string(n) );
-//   props.set_property( "arcs", to_string(tot_links) );
-//   props.set_property( "window_size", to_string(window_size) );
-//   props.set_property( "maxrefcount", to_string(max_ref_count) );
-//   props.set_property( "min_interval_length", to_string(min_interval_length) );
-//   if ( residual_coding == ZETA ) 
-//      props.set_property( "zeta_k", to_string(zeta_k) );
-//   props.set_property( "compressionflags", flags_to_string( flags ) );
-//   props.set_property( "avgref", to_string( (double)tot_ref / n )  );
-//   props.set_property( "avgdist", to_string(double(tot_dist)/n ) );
-//   props.set_property( "bitsperlink", to_string( ( double )graph_obs.written_bits() / tot_links ) );
-//   props.set_property( "bitspernode", to_string( ( double )graph_obs.written_bits() / n ) );
-//   props.set_property( "graphclass", "webgraph::bv_graph::graph" );
-//   props.set_property( "version", to_string(BVGRAPH_VERSION) );
-//   
-//   ofstream property_file( basename + ".properties" );
-//   props.store( property_file, "BVGraph properties" );
-//   
-//   property_file.close();
-//   //
-//   //   if ( STATS ) {
-//   //      offsetStats.close();
-//   //      referenceStats.close();
-//   //      outdegreeStats.close();
-//   //      blockCountStats.close();
-//   //      blockStats.close();
-//   //      intervalCountStats.close();
-//   //      leftStats.close();
-//   //      lenStats.close();
-//   //      residualCountStats.close();
-//   //      residualStats.close();
-//   //   }
-//}
-
-////////////////////////////////////////////////////////////////////////////////
-/** Writes the given graph <code>graph</code> using a given base
- * name, and the compression parameters and flags of this
- * graph object. Note that the latter is relevant only as far
- * as parameters and flags are concerned; its content is
- * really irrelevant.
+ * <P>Random access to a node decodes its whole reference chain, so the greedy choice,
+ * which happily builds chains as long as max_ref_count allows, gives poor worst-case
+ * latency. If {@link #chain_weight} is positive each candidate is instead charged its
+ * bits plus chain_weight times the depth of the chain it would create (0 for no
+ * reference): a deep reference is then taken only if it saves more than chain_weight
+ * bits per level over a shallower one.
  *
- * @param graph a graph to be compressed.
- * @param basename a base name.
- * @param pm a progress meter to measure the state of compression, or
- * <code>null</code> if no metering is required.
- * @throws IOException if some exception is raised while writing the graph.
+ * @param obs the graph-file output bit stream.
+ * @param bit_count a scratch stream used to measure candidates.
+ * @param curr_node the node being compressed.
+ * @param lst the cyclic window of successor lists.
+ * @param list_len the lengths of the lists in the window.
+ * @param ref_count the reference count of the lists in the window; updated for
+ * <code>curr_node</code>.
+ * @return the reference chosen (0 if the list is not compressed differentially).
  */
-void graph::store_offline_graph_internal( webgraph::ascii_graph::offline_graph olg, 
-                                          string basename, ostream* log ) {
-   // Used for differential compression
-   // TODO make this portable.
-   boost::shared_ptr<ostream> nos( new ofstream("/dev/null") );
-
-#ifndef CONFIG_FAST
-   lg() << LEVEL_DEBUG << "store_offline_graph_internal( " << basename << " )\n";
-#endif
-   obitstream bit_count( nos, 0  );
-
-   typedef webgraph::ascii_graph::offline_graph graph_type;
-
-   unsigned int outd;
-   int curr_node, curr_index, j, best, best_index, cand, t = 0, n = olg.get_num_nodes();
-   long bit_offset = 0;
-
-   obitstream graph_obs( basename + ".graph", STD_BUFFER_SIZE );
-//   ofstream cpp_obs_log( "cpp_obs_log.txt" );
-// debug_obitstream graph_obs( graph_obs_underlying, cpp_obs_log );
-   obitstream offset_obs( basename + ".offsets", STD_BUFFER_SIZE );
-
-   //    if ( STATS ) {
-   //       offsetStats = new PrintWriter( new FileWriter( basename + ".offsetStats" ) );
-   //       referenceStats = new PrintWriter( new FileWriter( basename + ".referenceStats" ) );
-   //       outdegreeStats = new PrintWriter( new FileWriter( basename + ".outdegreeStats" ) );
-   //       blockCountStats = new PrintWriter( new FileWriter( basename + ".blockCountStats" ) );
-   //       blockStats = new PrintWriter( new FileWriter( basename + ".blockStats" ) );
-   //       intervalCountStats = new PrintWriter( new FileWriter( basename + ".intervalCountStats" ) );
-   //       leftStats = new PrintWriter( new FileWriter( basename + ".leftStats" ) );
-   //       lenStats = new PrintWriter( new FileWriter( basename + ".lenStats" ) );
-   //       residualCountStats = new PrintWriter( new FileWriter( basename + ".residualCountStats" ) );
-   //       residualStats = new PrintWriter( new FileWriter( basename + ".residualStats" ) );
-   //    }
-
+int graph::compress_list( obitstream& obs, obitstream& bit_count, int curr_node, 
+                          vector<vector<unsigned int> >& lst, vector<int>& list_len,
+                          vector<int>& ref_count ) {
    int cyclic_buffer_size = window_size + 1;
-
-   // Cyclic array of previous lists.
-   vector<vector<unsigned int> > lst( cyclic_buffer_size );
+   int curr_index = curr_node % cyclic_buffer_size;
+   int best_index = -1, cand;
+   double best = numeric_limits<double>::max(), t;
    
-   for( vector<vector<unsigned int> >::iterator i = lst.begin(); i != lst.end(); i++ ) 
-      i->resize( INITIAL_SUCCESSOR_LIST_LENGTH );
+   ref_count[ curr_index ] = -1;
    
-   // For each list, its length.
-   vector<int> list_len( cyclic_buffer_size );
+   for( int j = 0; j < cyclic_buffer_size; j++ ) {
+      cand = ( curr_node - j + cyclic_buffer_size ) % cyclic_buffer_size;
+      if ( ref_count[ cand ] < max_ref_count && list_len[ cand ] != 0 ) {
+         t = differentially_compress( bit_count, curr_node, j, lst[ cand ], list_len[ cand ], 
+                                      lst[ curr_index ], list_len[ curr_index ], false );
 
-   // For each list, the depth of its references.
-   vector<int> ref_count( cyclic_buffer_size );
-   
-   long tot_ref = 0, tot_dist = 0, tot_links = 0;
-
-   //    if ( pm != null ) {
-   //       System.err.print( "Storing..." );
-   //       pm.itemsName( "nodes" );
-   //       pm.expectedUpdates( n );
-   //       pm.start();
-   //    }
-
-   boost::shared_ptr<boost::progress_display> pp;
+         // For j == 0, ref_count[ cand ] is -1, so no reference costs nothing.
+         if ( chain_weight != 0 ) 
+            t += chain_weight * ( ref_count[ cand ] + 1 );
 
-   if( log != NULL ) {
-      *log << "Compressing graph...\n";
-      pp.reset( new boost::progress_display( olg.get_num_nodes(), *log ) );
+         if ( t < best ) {
+            best = t;
+            best_index = cand;
+         }
+      }
    }
-
-   // We iterate over the nodes of graph
-   graph_type::node_iterator node_itor, node_itor_end;
-   for ( tie( node_itor, node_itor_end) = olg.get_vertex_iterator(); 
-         node_itor != node_itor_end;
-         ++node_itor ) {
-      // curr_node is the currently examined node, of outdegree outd, with index currIndex
-      // (within the cyclic array)
-      curr_node = *node_itor;
-   
 #ifndef CONFIG_FAST
-      lg() << LEVEL_EVERYTHING << "Current node : " << curr_node;
+   lg() << logs::LEVEL_EVERYTHING << "best = " << best << ", best_index = " << best_index << "\n";
 #endif
 
-      // TODO get this to work with both asciigraph, bvgraph, and BGL
-      // find the lcd and stick with it....
-      outd = webgraph::ascii_graph::outdegree(node_itor); // get the number of successors of currNode
-      curr_index = curr_node % cyclic_buffer_size;
+   assert( best_index >= 0 );
+      
+   ref_count[ curr_index ] = ref_count[ best_index ] + 1;
 
-#ifndef CONFIG_FAST
-      lg() << LEVEL_EVERYTHING << ", which has " << outd << " outlinks.\n";
+   int ref = ( curr_node - best_index + cyclic_buffer_size ) % cyclic_buffer_size;
       
-      // We write the current offset to the offset stream
-      lg() << LEVEL_EVERYTHING << "About to write the offset - "
-           << (int)( graph_obs.get_written_bits() - bit_offset )
-           << "( " << graph_obs.get_written_bits() << ", " << bit_offset << " )\n";
-#endif
+   differentially_compress( obs, curr_node, ref, lst[ best_index ], list_len[ best_index ], 
+                            lst[ curr_index ], list_len[ curr_index ], true );
 
-      write_offset( offset_obs, (int)( graph_obs.get_written_bits() - bit_offset ) );
+   return ref;
+}
 
-      //      if ( STATS ) offsetStats.println( graphObs.written_bits() - bit_offset );
+////////////////////////////////////////////////////////////////////////////////
+/** Returns the number of bits the graph file would take for a run of consecutive
+ * successor lists, under the given parameters, without writing anything. The lists are
+ * those of nodes <code>first_node</code>, <code>first_node + 1</code>, ... so gaps
+ * relative to the node are coded exactly as store() would; the only difference is that
+ * the reference window starts out empty.
+ *
+ * This is the cost model used to tune compression parameters on a sample of the graph.
+ *
+ * @param lists the successor lists, sorted.
+ * @param first_node the node of the first list.
+ * @param stats if not <code>NULL</code>, receives the statistics of the lists.
+ * @param chain_weight as in store().
+ * @return the number of bits of the graph file spent on the lists.
+ */
+long long graph::estimate_bits( const vector<vector<unsigned int> >& lists, int first_node,
+                                int window_size, int max_ref_count, int min_interval_length, 
+                                int zeta_k, int flags, compression_stats* stats, 
+                                double chain_weight ) {
+   graph me;
+
+   if ( window_size != -1 ) 
+      me.window_size = window_size;
+   if ( max_ref_count != -1 ) 
+      me.max_ref_count = max_ref_count;
+   if ( min_interval_length != -1 ) 
+      me.min_interval_length = min_interval_length;
+   if ( zeta_k != -1 ) 
+      me.zeta_k = zeta_k;
+   me.chain_weight = chain_weight;
+   me.set_flags( flags );
 
-      bit_offset = graph_obs.get_written_bits();
+   compression_stats st;
+   me.stats = &st;
 
-      // We write the node outdegree
-      write_outdegree( graph_obs, outd );
+   boost::shared_ptr<ostream> nos( new ofstream( "/dev/null" ) );
+   obitstream obs( nos, 0 ), bit_count( nos, 0 );
 
-      //      if ( STATS ) outdegreeStats.println( outd );
+   int cyclic_buffer_size = me.window_size + 1;
+   vector<vector<unsigned int> > lst( cyclic_buffer_size );
+   vector<int> list_len( cyclic_buffer_size ), ref_count( cyclic_buffer_size );
 
-      if ( outd > lst[ curr_index ].size() ) 
-         lst[ curr_index ].resize( outd );
+   for( unsigned i = 0; i < lists.size(); i++ ) {
+      int curr_node = first_node + i, curr_index = curr_node % cyclic_buffer_size;
+      int outd = lists[i].size();
 
-      // The successor list we are going to compress and write out
-      lst[curr_index] = ascii_graph::successors( node_itor );
-      
+      lst[ curr_index ] = lists[i];
       list_len[ curr_index ] = outd;
 
-      if ( outd > 0 ) {
-   
-         // Now we check the best candidate for compression.
-         best = std::numeric_limits<int>::max();
-         best_index = -1;
-   
-         ref_count[ curr_index ] = -1;
-   
-         for( j = 0; j < cyclic_buffer_size; j++ ) {
-            cand = ( curr_node - j + cyclic_buffer_size ) % cyclic_buffer_size;
-            if ( ref_count[ cand ] < max_ref_count && list_len[ cand ] != 0
-                 && ( t = differentially_compress( bit_count, curr_node, j, lst[ cand ], 
-                                                   list_len[ cand ], lst[ curr_index ], 
-                                                   list_len[ curr_index ], false ) ) < best ) {
-               best = t;
-               best_index = cand;
-            }
-         }
-#ifndef CONFIG_FAST
-         lg() << LEVEL_EVERYTHING << "best = " << best << ", best_index = " << best_index << "\n";
-#endif
+      st.add( compression_stats::OUTDEGREES, outd, me.write_outdegree( obs, outd ) );
 
-         assert( best_index >= 0 );
-      
-         ref_count[ curr_index ] = ref_count[ best_index ] + 1;
-      
-         differentially_compress( graph_obs, curr_node, ( curr_node - best_index + cyclic_buffer_size ) % 
-                                  cyclic_buffer_size, lst[ best_index ], 
-                                  list_len[ best_index ], lst[ curr_index ], list_len[ curr_index], true );
-                             
-         tot_links += outd;
-         tot_ref += ref_count[ curr_index ];
-         tot_dist += ( curr_node - best_index + cyclic_buffer_size ) % cyclic_buffer_size;
-      }
-    
-      
-      if ( ( curr_node + 1 ) % 1000000 == 0 ) 
-         *log << "["
-              << "bits/link=" << double(graph_obs.get_written_bits()) / ((tot_links != 0) ? tot_links : 1 )
-              << ", bits/node=" << (double)graph_obs.get_written_bits() / ( curr_node )
-              << ", avgref=" << ( double )tot_ref / curr_node
-              << ", avgdist=" << ( double )tot_dist / curr_node
-              << "]" << endl;
-
-      //if ( pm != null ) pm.update();
-      if( pp != NULL )
-         ++(*pp);
+      if ( outd > 0 ) 
+         me.compress_list( obs, bit_count, curr_node, lst, list_len, ref_count );
    }
 
-   pp.reset();
-  
-   // We write the final offset to the offset stream.
-   write_offset( offset_obs, (int)( graph_obs.get_written_bits() - bit_offset ) );
-  
-   //graph_obs.close();
-   //offset_obs.close();
+   if ( stats != NULL ) 
+      stats->merge( st );
 
-   //   if ( pm != null ) {
-   //      pm.stop();
-   //      System.err.println( " done." );
-   //      System.err.println( pm );
-   //   }
+   return obs.get_written_bits();
+}
 
-   // Finally, we save all data related to this graph in a property file.
-   // TODO check these names
-   properties props;
-   props.set_property( "basename", basename );
-   props.set_property( "nodes", utils::to_string(n) );
-   props.set_property( "arcs", utils::to_string(tot_links) );
-   props.set_property( "windowsize", utils::to_string(window_size) );
-   props.set_property( "maxrefcount", utils::to_string(max_ref_count) );
-   props.set_property( "minintervallength", utils::to_string(min_interval_length) );
-   if ( residual_coding == webgraph::compression_flags::ZETA ) 
-      props.set_property( "zetak", utils::to_string(zeta_k) );
-   props.set_property( "compressionflags", flags_to_string( flags ) );
-   props.set_property( "avgref", utils::to_string( (double)tot_ref / n )  );
-   props.set_property( "avgdist", utils::to_string(double(tot_dist)/n ) );
-   props.set_property( "bitsperlink", utils::to_string( ( double )graph_obs.get_written_bits() / tot_links ) );
-   props.set_property( "bitspernode", utils::to_string( ( double )graph_obs.get_written_bits() / n ) );
-   props.set_property( "graphclass", "class it.unimi.dsi.webgraph.BVGraph" );
-   props.set_property( "version", utils::to_string(BVGRAPH_VERSION) );
-   
-   ofstream property_file( (basename + ".properties").c_str() );
-   props.store( property_file, "BVGraph properties" );
-   
-   property_file.close();
-   //
-   //   if ( STATS ) {
-   //      offsetStats.close();
-   //      referenceStats.close();
-   //      outdegreeStats.close();
-   //      blockCountStats.close();
-   //      blockStats.close();
-   //      intervalCountStats.close();
-   //      leftStats.close();
-   //      lenStats.close();
-   //      residualCountStats.close();
-   //      residualStats.close();
-   //   }
+////////////////////////////////////////////////////////////////////////////////
+/** Writes an offline_graph using the given base name
+ *
+ * @param graph a graph to be compressed.
+ * @param basename a base name.
+ * @param window_size the window size (-1 for the default value).
+ * @param maxRefCount the maximum reference count (-1 for the default value).
+ * @param min_interval_length the minimum interval length (-1 for the default value).
+ * @param zeta_k the parameter used for residual &zeta;-coding, if used (-1 for the default value).
+ * @param flags the flag mask.
+ * @param pm a progress meter to measure the state of compression, or <code>null</code> if no metering is required.
+ * @throws IOException if some exception is raised while writing the graph.
+ *
+ * This is now just a non-template shorthand for store().
+ */
+void graph::store_offline_graph( 
+   webgraph::ascii_graph::offline_graph g, string basename,
+   int window_size, int max_ref_count, int min_interval_length, 
+   int zeta_k, int flags, ostream* log, compression_stats* stats ) {
+   store( g, basename, window_size, max_ref_count, min_interval_length, zeta_k, flags, log,
+          stats );
 }
    
 /** Write the offset file to a given bit stream.
@@ -2283,6 +2082,144 @@ void graph::write_offsets( obitstream& obs, ostream* log ) {
    write_offset( obs, (int)( node_itor.ibs->get_read_bits() - last_offset ) );
 }
    
+////////////////////////////////////////////////////////////////////////////////
+/* The following private methods support append(). They all need offsets. */
+
+/** Returns the length of the reference chain starting at a node with a nonempty
+ * successor list, i.e. the reference count store() assigned to it.
+ */
+int graph::reference_depth( int x ) const {
+   assert( offset_step == 1 );
+
+   ibitstream ibs( graph_memory_ptr );
+   int depth = 0;
+
+   for( ;; ) {
+      ibs.set_position( offset[ x ] );
+
+      if ( read_outdegree( ibs ) == 0 || window_size == 0 ) 
+         return depth;
+
+      int ref = read_reference( ibs );
+
+      if ( ref == 0 ) 
+         return depth;
+
+      x -= ref;
+      depth++;
+   }
+}
+
+/** Fills a compression window as store_internal() would have left it after the last
+ * node: the last window_size successor lists, their lengths and reference counts.
+ */
+void graph::load_window( vector<vector<unsigned int> >& lst, vector<int>& list_len,
+                         vector<int>& ref_count ) const {
+   int cyclic_buffer_size = window_size + 1;
+
+   for( int x = max( 0L, n - window_size ); x < n; x++ ) {
+      int i = x % cyclic_buffer_size;
+
+      successor_iterator s, e;
+
+      lst[i].clear();
+      for( boost::tie( s, e ) = get_successors( x ); s != e; ++s ) 
+         lst[i].push_back( *s );
+
+      list_len[i] = lst[i].size();
+      ref_count[i] = list_len[i] > 0 ? reference_depth( x ) : 0;
+   }
+}
+
+/** Returns the number of bits taken by the first count deltas of the offset file. */
+long graph::offsets_file_bits( long count ) const {
+   ibitstream ibs( basename + ".offsets", STD_BUFFER_SIZE );
+
+   for( long i = 0; i < count; i++ ) 
+      read_offset( ibs );
+
+   return ibs.get_read_bits();
+}
+
+/** Opens a bit file so that writing goes on right after its first bits bits; the rest
+ * of the file is discarded. The returned stream counts the existing bits as written.
+ */
+boost::shared_ptr<obitstream> graph::reopen_bitstream( const string& filename, long bits ) {
+   int partial_bits = bits % 8, partial = 0;
+
+   if ( partial_bits != 0 ) {
+      ifstream in( filename.c_str(), ios::binary );
+      in.seekg( bits / 8 );
+      partial = in.get();
+
+      if ( !in.good() ) 
+         throw runtime_error( "Cannot read the last byte of " + filename );
+   }
+
+   if ( truncate( filename.c_str(), bits / 8 ) != 0 ) 
+      throw runtime_error( "Cannot truncate " + filename + ": " + strerror( errno ) );
+
+   boost::shared_ptr<ostream> os( new ofstream( filename.c_str(), ios::binary | ios::app ) );
+   boost::shared_ptr<obitstream> obs( new obitstream( os, STD_BUFFER_SIZE ) );
+
+   if ( partial_bits != 0 ) 
+      obs->write_int( ( partial & 0xFF ) >> ( 8 - partial_bits ), partial_bits );
+
+   obs->set_written_bits( bits );
+
+   return obs;
+}
+
+/** Rewrites the property file after an append: counts, averages and per-component
+ * statistics cover the old and the new nodes. avgref is recombined from its (rounded)
+ * old value.
+ */
+void graph::update_appended_properties( long new_n, long new_arcs, long tot_ref, 
+                                        long tot_dist, int max_ref, long graph_bits, 
+                                        long offsets_bits, 
+                                        const compression_stats& st ) const {
+   properties props;
+   string name = basename + ".properties";
+
+   {
+      ifstream in( name.c_str() );
+      assert( in.good() );
+      props.load( in );
+   }
+
+   long arcs = m + new_arcs;
+
+   tot_ref += (long)( atof( props.get_property( "avgref" ).c_str() ) * n + 0.5 );
+   tot_dist += (long)( atof( props.get_property( "avgdist" ).c_str() ) * n + 0.5 );
+
+   props.set_property( "nodes", utils::to_string( new_n ) );
+   props.set_property( "arcs", utils::to_string( arcs ) );
+   props.set_property( "avgref", utils::to_string( (double)tot_ref / new_n ) );
+   props.set_property( "avgdist", utils::to_string( (double)tot_dist / new_n ) );
+   props.set_property( "bitsperlink", utils::to_string( (double)graph_bits / arcs ) );
+   props.set_property( "bitspernode", utils::to_string( (double)graph_bits / new_n ) );
+
+   if ( props.has_property( "maxrefchain" ) ) 
+      max_ref = max( max_ref, atoi( props.get_property( "maxrefchain" ).c_str() ) );
+   props.set_property( "maxrefchain", utils::to_string( max_ref ) );
+
+   // Graphs stored before per-component statistics were kept just go without them.
+   compression_stats total( st );
+   if ( total.merge_properties( props ) ) {
+      total.set_properties( props );
+
+      // The delta that closed the old offset file has been rewritten, so it must not be
+      // counted twice.
+      props.set_property( "numberofoffsets", utils::to_string( new_n + 1 ) );
+      props.set_property( "bitsforoffsets", utils::to_string( offsets_bits ) );
+      props.set_property( "avgbitsforoffsets", 
+                          utils::to_string( (double)offsets_bits / ( new_n + 1 ) ) );
+   }
+
+   ofstream out( name.c_str() );
+   props.store( out, "BVGraph properties" );
+}
+   
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -24,19 +24,28 @@
 #include <vector>
 #include <utility>
 #include <climits>
+#include <limits>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
 
 #include <boost/progress.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/tuple/tuple.hpp>
 
 #include "types.hpp"
 #include "../asciigraph/offline_graph.hpp"
+#include "successor_source.hpp"
 #include "compression_flags.hpp"
+#include "compression_stats.hpp"
 #include "iterators/utility_iterator_base.hpp"
 #include "iterators/iterator_wrappers.hpp"
 #include "iterators/node_iterator.hpp"
 #include "../bitstreams/input_bitstream.hpp"
 #include "../bitstreams/output_bitstream.hpp"
 #include "../log/logger.hpp"
+#include "../properties/properties.hpp"
+#include "../utils/fast.hpp"
 
 namespace webgraph { namespace bv_graph {
 
@@ -77,9 +86,9 @@ private:
    
    // TODO this will have to be simulated.
    
-   //private PrintWriter offsetStats, outdegreeStats, blockCountStats, blockStats,
-   //intervalCountStats, referenceStats, leftStats, lenStats, residualStats,
-   //residualCountStats;
+   /** Where differentially_compress() records what it writes for real, or
+    * <code>NULL</code>. This takes the place of the Java STATS print writers. */
+   compression_stats* stats;
    
    ////////////// PUBLIC MEMBERS
 public:
@@ -214,6 +223,11 @@ protected:
    /** The maximum reference count. */
    int max_ref_count;
 
+   /** When compressing, the price in bits of one more level of reference chain: a
+    * reference is chosen to minimize its bits plus chain_weight times the depth of the
+    * chain it creates. Zero gives the plain greedy choice. */
+   double chain_weight;
+
    /** The window size. Zero means no references. */
    int window_size;
 
@@ -267,6 +281,13 @@ protected:
     * {@link #outdegree_cache_end}. */
    mutable int offset_cache_end;
    
+   /** If the graph was loaded with load_decompressed(), the successors of node x are
+    * decompressed_targets[ decompressed_offsets[x] ] .. 
+    * decompressed_targets[ decompressed_offsets[x + 1] - 1 ], and random access is served
+    * from these arrays; otherwise both are empty. */
+   std::vector<long> decompressed_offsets;
+   std::vector<int> decompressed_targets;
+
    /** These are only used by differentially_compress. Would be preferable to put their declarations
     * there, at some point */
    std::vector<int> extras;
@@ -290,9 +311,11 @@ protected:
    ////////////////////////////////////////////////////////////////////////////////
 
 protected:
-   graph() : graph_memory_ptr( new std::vector<byte> ),
+   graph() : stats(NULL),
+             graph_memory_ptr( new std::vector<byte> ),
              graph_memory( *graph_memory_ptr ),
              max_ref_count(DEFAULT_MAX_REF_COUNT),
+             chain_weight(0),
              window_size(DEFAULT_WINDOW_SIZE),
              min_interval_length(DEFAULT_MIN_INTERVAL_LENGTH),
              offset_step(DEFAULT_OFFSET_STEP),
@@ -352,6 +375,19 @@ protected:
 
 public:
    succ_itor_pair get_successors( int x ) const;
+   int successor( int x, int i ) const;
+
+   /** Whether the graph was loaded with load_decompressed(). */
+   bool is_decompressed() const {
+      return !decompressed_offsets.empty();
+   }
+
+   /** The successors of x as a range of the decompressed lists; only for graphs loaded
+    * with load_decompressed(). Unlike get_successors(), this involves no allocation. */
+   std::pair<const int*, const int*> get_decompressed_successors( int x ) const {
+      const int* t = decompressed_targets.empty() ? NULL : &decompressed_targets[0];
+      return std::make_pair( t + decompressed_offsets[x], t + decompressed_offsets[x + 1] );
+   }
    
 private:
    internal_succ_itor_ptr get_successors_internal( int x ) const;
@@ -362,6 +398,8 @@ private:
                                                    std::vector<int>& blockOutdegrees ) const;
 public:
    std::pair<node_iterator, node_iterator> get_node_iterator( int from ) const;
+
+   void scan_stats( compression_stats& st, std::ostream* log = NULL ) const;
         
 private:
    void set_flags( int flags );
@@ -375,9 +413,12 @@ public:
    static graph_ptr load( std::string basename, std::ostream* log = NULL );
    static graph_ptr load_sequential( std::string basename, std::ostream* log = NULL );
    static graph_ptr load_offline( std::string basename, std::ostream* log = NULL );
+   static graph_ptr load_decompressed( std::string basename, int threads = 1, 
+                                       std::ostream* log = NULL );
 
 protected:
    void load_internal( std::string basename, int offset_step, std::ostream* log = NULL );
+   void decompress( int threads, std::ostream* log );
    static int intervalize( const std::vector<int>& x, int min_interval, std::vector<int>& left, 
                            std::vector<int>& len, 
                            std::vector<int>& residuals );
@@ -387,21 +428,48 @@ private:
                                 std::vector<unsigned int>& ref_list, int ref_length, 
                                 std::vector<unsigned int>& current_list, 
                                 int current_len, bool for_real );
+
+   int compress_list( obitstream& obs, obitstream& bit_count, int curr_node, 
+                      std::vector<std::vector<unsigned int> >& lst, std::vector<int>& list_len,
+                      std::vector<int>& ref_count );
         
 public:
-//   static void store( boost::shared_ptr<graph> graph, std::string
-//                      basename, int window_size, int max_ref_count,
-//                      int min_interval_length, int zeta_k, int
-//                      flags, std::ostream* log = NULL );
+   template<class source_type>
+   static void store( const source_type& g, std::string basename, int window_size, 
+                      int max_ref_count, int min_interval_length, int zeta_k, int flags, 
+                      std::ostream* log = NULL, compression_stats* stats = NULL,
+                      double chain_weight = 0 );
+   static long long estimate_bits( const std::vector<std::vector<unsigned int> >& lists, 
+                                   int first_node, int window_size, int max_ref_count, 
+                                   int min_interval_length, int zeta_k, int flags, 
+                                   compression_stats* stats = NULL, 
+                                   double chain_weight = 0 );
    static void store_offline_graph( webgraph::ascii_graph::offline_graph graph, 
                                     std::string basename, int window_size, int max_ref_count, 
-                                    int min_interval_length, int zeta_k, int flags, std::ostream* log = NULL );
+                                    int min_interval_length, int zeta_k, int flags, std::ostream* log = NULL,
+                                    compression_stats* stats = NULL );
+
+   template<class source_type>
+   static void append( const source_type& g, std::string basename, long skip = 0, 
+                       std::ostream* log = NULL );
 
 private:
-//   void store_internal( boost::shared_ptr<graph> graph, std::string basename, std::ostream* log = NULL );
-   void store_offline_graph_internal( webgraph::ascii_graph::offline_graph graph, 
-                                      std::string basename, 
-                                      std::ostream* log = NULL );
+   template<class source_type>
+   void store_internal( const source_type& g, std::string basename, std::ostream* log,
+                        compression_stats& st );
+
+   template<class source_type>
+   void append_internal( const source_type& g, long skip, std::ostream* log );
+
+   int reference_depth( int x ) const;
+   void load_window( std::vector<std::vector<unsigned int> >& lst, std::vector<int>& list_len,
+                     std::vector<int>& ref_count ) const;
+   long offsets_file_bits( long count ) const;
+   static boost::shared_ptr<obitstream> reopen_bitstream( const std::string& filename, 
+                                                          long bits );
+   void update_appended_properties( long new_n, long new_arcs, long tot_ref, long tot_dist, 
+                                    int max_ref, long graph_bits, long offsets_bits,
+                                    const compression_stats& st ) const;
         
 public:
    void write_offsets( obitstream& obs, std::ostream* log = NULL );
@@ -410,5 +478,379 @@ public:
 //   static void main( std::string args[] );
 };
 
+} // end bv_graph
+
+////////////////////////////////////////////////////////////////////////////////
+/*!
+ * A BV graph is scanned through its node iterator, so recompressing a graph with new
+ * parameters takes a single sequential pass. Any offset step will do, including -1
+ * (offline).
+ */
+template<>
+struct successor_source_traits<bv_graph::graph> {
+   typedef bv_graph::graph::node_iterator node_iterator;
+
+   static long num_nodes( const bv_graph::graph& g ) {
+      return g.get_num_nodes();
+   }
+
+   static std::pair<node_iterator, node_iterator> nodes( const bv_graph::graph& g ) {
+      return g.get_node_iterator( 0 );
+   }
+
+   static int successors( const node_iterator& i, std::vector<unsigned int>& dest ) {
+      return bv_graph::successor_array( i, dest );
+   }
+};
+
+namespace bv_graph {
+
+////////////////////////////////////////////////////////////////////////////////
+/** Writes the given graph using a given base name.
+ *
+ * <P>The graph may be of any type with a specialization of successor_source_traits -
+ * e.g. an ascii_graph::offline_graph, a csr_view or a (loaded) graph, which makes it
+ * possible to recompress a BV graph with different parameters in a single pass.
+ *
+ * @param g a graph to be compressed.
+ * @param basename a base name.
+ * @param window_size the window size (-1 for the default value).
+ * @param max_ref_count the maximum reference count (-1 for the default value).
+ * @param min_interval_length the minimum interval length (-1 for the default value).
+ * @param zeta_k the parameter used for residual &zeta;-coding, if used (-1 for the default value).
+ * @param flags the flag mask.
+ * @param log a stream to report progress on, or <code>NULL</code> if no metering is required.
+ * @param stats if not <code>NULL</code>, receives the per-component statistics of the
+ * compressed graph (which are also summarized in the property file).
+ * @param chain_weight the price in bits of each level of reference chain (see
+ * compress_list()); positive values trade a little space for shorter chains, and thus
+ * faster random access, within the hard bound of max_ref_count.
+ */
+template<class source_type>
+void graph::store( const source_type& g, std::string basename,
+                   int window_size, int max_ref_count, int min_interval_length, 
+                   int zeta_k, int flags, std::ostream* log, compression_stats* stats,
+                   double chain_weight ) {
+#ifndef CONFIG_FAST      
+   logs::register_logger( "webgraph", logs::LEVEL_MAX );
+
+   lg() << logs::LEVEL_DEBUG << "store( " << basename << ", " << window_size << ", "
+        << max_ref_count << ", " << min_interval_length << ", " 
+        << zeta_k << ", " << flags << ") " << "\n";
+#endif
+
+   boost::shared_ptr<graph> me( new graph() );  
+    
+   if ( window_size != -1 ) 
+      me->window_size = window_size;
+      
+   if ( max_ref_count != -1 ) 
+      me->max_ref_count = max_ref_count;
+      
+   if ( min_interval_length != -1 ) 
+      me->min_interval_length = min_interval_length;
+    
+   if ( zeta_k != -1 ) 
+      me->zeta_k = zeta_k;
+
+   me->chain_weight = chain_weight;
+      
+   me->set_flags( flags );
+
+   compression_stats st;
+   me->store_internal( g, basename, log, st );
+
+   if ( stats != NULL ) 
+      stats->merge( st );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** Writes the given graph <code>g</code> using a given base name, and the compression
+ * parameters and flags of this graph object. Note that the latter is relevant only as
+ * far as parameters and flags are concerned; its content is really irrelevant.
+ *
+ * @param g a graph to be compressed.
+ * @param basename a base name.
+ * @param log a stream to report progress on, or <code>NULL</code> if no metering is
+ * required.
+ * @param st collects the statistics of what is written.
+ */
+template<class source_type>
+void graph::store_internal( const source_type& g, std::string basename, std::ostream* log,
+                            compression_stats& st ) {
+   typedef successor_source_traits<source_type> traits;
+   
+   // Used for differential compression
+   // TODO make this portable.
+   boost::shared_ptr<std::ostream> nos( new std::ofstream("/dev/null") );
+
+#ifndef CONFIG_FAST
+   lg() << logs::LEVEL_DEBUG << "store_internal( " << basename << " )\n";
+#endif
+   obitstream bit_count( nos, 0  );
+
+   // differentially_compress() records into st whatever it writes for real.
+   stats = &st;
+
+   unsigned int outd;
+   int curr_node, curr_index, n = traits::num_nodes( g );
+   long bit_offset = 0;
+
+   obitstream graph_obs( basename + ".graph", STD_BUFFER_SIZE );
+   obitstream offset_obs( basename + ".offsets", STD_BUFFER_SIZE );
+
+   int cyclic_buffer_size = window_size + 1;
+
+   // Cyclic array of previous lists.
+   std::vector<std::vector<unsigned int> > lst( cyclic_buffer_size );
+   
+   for( std::vector<std::vector<unsigned int> >::iterator i = lst.begin(); i != lst.end(); i++ ) 
+      i->resize( INITIAL_SUCCESSOR_LIST_LENGTH );
+   
+   // For each list, its length.
+   std::vector<int> list_len( cyclic_buffer_size );
+
+   // For each list, the depth of its references.
+   std::vector<int> ref_count( cyclic_buffer_size );
+   
+   long tot_ref = 0, tot_dist = 0, tot_links = 0;
+   int max_ref = 0;
+
+   boost::shared_ptr<boost::progress_display> pp;
+
+   if( log != NULL ) {
+      *log << "Compressing graph...\n";
+      pp.reset( new boost::progress_display( n, *log ) );
+   }
+
+   // We iterate over the nodes of graph
+   typename traits::node_iterator node_itor, node_itor_end;
+   curr_node = 0;
+   for ( boost::tie( node_itor, node_itor_end ) = traits::nodes( g ); 
+         curr_node < n && node_itor != node_itor_end;
+         ++node_itor, ++curr_node ) {
+      // curr_node is the currently examined node, of outdegree outd, with index curr_index
+      // (within the cyclic array)
+      curr_index = curr_node % cyclic_buffer_size;
+
+      // The successor list we are going to compress and write out
+      outd = traits::successors( node_itor, lst[ curr_index ] );
+
+#ifndef CONFIG_FAST
+      lg() << logs::LEVEL_EVERYTHING << "Current node : " << curr_node
+           << ", which has " << outd << " outlinks.\n";
+#endif
+
+      // We write the current offset to the offset stream
+      int delta = (int)( graph_obs.get_written_bits() - bit_offset );
+      st.add( compression_stats::OFFSETS, delta, write_offset( offset_obs, delta ) );
+
+      bit_offset = graph_obs.get_written_bits();
+
+      // We write the node outdegree
+      st.add( compression_stats::OUTDEGREES, outd, write_outdegree( graph_obs, outd ) );
+
+      list_len[ curr_index ] = outd;
+
+      if ( outd > 0 ) {
+         int ref = compress_list( graph_obs, bit_count, curr_node, lst, list_len, ref_count );
+                             
+         tot_links += outd;
+         tot_ref += ref_count[ curr_index ];
+         tot_dist += ref;
+         max_ref = std::max( max_ref, ref_count[ curr_index ] );
+      }
+      
+      if ( log != NULL && ( curr_node + 1 ) % 1000000 == 0 ) 
+         *log << "["
+              << "bits/link=" << double(graph_obs.get_written_bits()) / ((tot_links != 0) ? tot_links : 1 )
+              << ", bits/node=" << (double)graph_obs.get_written_bits() / ( curr_node )
+              << ", avgref=" << ( double )tot_ref / curr_node
+              << ", avgdist=" << ( double )tot_dist / curr_node
+              << "]" << std::endl;
+
+      if( pp != NULL )
+         ++(*pp);
+   }
+
+   assert( curr_node == n );
+
+   pp.reset();
+  
+   // We write the final offset to the offset stream.
+   int delta = (int)( graph_obs.get_written_bits() - bit_offset );
+   st.add( compression_stats::OFFSETS, delta, write_offset( offset_obs, delta ) );
+
+   stats = NULL;
+
+   // Finally, we save all data related to this graph in a property file.
+   properties props;
+   props.set_property( "basename", basename );
+   props.set_property( "nodes", utils::to_string(n) );
+   props.set_property( "arcs", utils::to_string(tot_links) );
+   props.set_property( "windowsize", utils::to_string(window_size) );
+   props.set_property( "maxrefcount", utils::to_string(max_ref_count) );
+   props.set_property( "minintervallength", utils::to_string(min_interval_length) );
+   if ( residual_coding == webgraph::compression_flags::ZETA ) 
+      props.set_property( "zetak", utils::to_string(zeta_k) );
+   props.set_property( "compressionflags", flags_to_string( flags ) );
+   props.set_property( "avgref", utils::to_string( (double)tot_ref / n )  );
+   props.set_property( "avgdist", utils::to_string(double(tot_dist)/n ) );
+   props.set_property( "maxrefchain", utils::to_string( max_ref ) );
+   if ( chain_weight != 0 ) 
+      props.set_property( "chainweight", utils::to_string( chain_weight ) );
+   props.set_property( "bitsperlink", utils::to_string( ( double )graph_obs.get_written_bits() / tot_links ) );
+   props.set_property( "bitspernode", utils::to_string( ( double )graph_obs.get_written_bits() / n ) );
+   st.set_properties( props );
+   props.set_property( "graphclass", "class it.unimi.dsi.webgraph.BVGraph" );
+   props.set_property( "version", utils::to_string(BVGRAPH_VERSION) );
+   
+   std::ofstream property_file( (basename + ".properties").c_str() );
+   props.store( property_file, "BVGraph properties" );
+   
+   property_file.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** Appends successor lists for new nodes to an existing graph, without recompressing
+ * it. The lists of g are taken as those of nodes n, n + 1, ... where n is the number of
+ * nodes of the graph. They are compressed with the parameters and flags the graph was
+ * stored with, just as store() would have compressed them had they been there from the
+ * start, so the result is the very graph store() would have produced.
+ *
+ * <P>The reference window is rebuilt by decoding the last window_size lists, and both
+ * the graph and the offset files are continued from their last bit. The property file
+ * is updated in place. The graph is loaded with offsets to do this, so it must fit in
+ * memory; and as the files are modified in place, an interrupted append leaves the graph
+ * unusable.
+ *
+ * @param g the new successor lists.
+ * @param basename the basename of the graph to extend.
+ * @param skip the number of leading nodes of g to ignore; they must have no successors,
+ * which is checked in a first pass over them before any file is touched (a
+ * <code>std::invalid_argument</code> is thrown otherwise), so g must be scannable twice.
+ * Sources that use absolute node ids, such as an arc_list_builder, should pass the
+ * number of nodes of the graph. An arc_list_builder only knows the nodes up to the
+ * largest it has seen: call its set_num_nodes() if the last new nodes are isolated.
+ * @param log a stream to report progress on, or <code>NULL</code>.
+ */
+template<class source_type>
+void graph::append( const source_type& g, std::string basename, long skip, 
+                    std::ostream* log ) {
+   graph_ptr me = load( basename, log );
+
+   me->append_internal( g, skip, log );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template<class source_type>
+void graph::append_internal( const source_type& g, long skip, std::ostream* log ) {
+   typedef successor_source_traits<source_type> traits;
+   
+   long k = traits::num_nodes( g ) - skip;
+
+   assert( k >= 0 );
+
+   int cyclic_buffer_size = window_size + 1;
+   std::vector<std::vector<unsigned int> > lst( cyclic_buffer_size );
+   std::vector<int> list_len( cyclic_buffer_size ), ref_count( cyclic_buffer_size );
+
+   std::vector<unsigned int> scratch;
+   typename traits::node_iterator node_itor, node_itor_end;
+   long x = 0;
+
+   // Old nodes cannot get successors; this must be known before the files are truncated.
+   for ( boost::tie( node_itor, node_itor_end ) = traits::nodes( g ); 
+         x < skip && node_itor != node_itor_end;
+         ++node_itor, ++x ) 
+      if ( traits::successors( node_itor, scratch ) != 0 ) 
+         throw std::invalid_argument( "Cannot append successors of node " + 
+                                      utils::to_string( x ) + ", which is not new" );
+
+   load_window( lst, list_len, ref_count );
+
+   // The offset file is continued after the delta of node n - 1: the next delta to write
+   // (the length of the list of n - 1) is the one that used to close the file.
+   boost::shared_ptr<obitstream> graph_obs = reopen_bitstream( basename + ".graph", 
+                                                               offset[ n ] );
+   boost::shared_ptr<obitstream> offset_obs = reopen_bitstream( basename + ".offsets", 
+                                                                offsets_file_bits( n ) );
+   long bit_offset = n > 0 ? offset[ n - 1 ] : 0;
+
+   boost::shared_ptr<std::ostream> nos( new std::ofstream("/dev/null") );
+   obitstream bit_count( nos, 0 );
+
+   compression_stats st;
+   stats = &st;
+
+   long tot_ref = 0, tot_dist = 0, tot_links = 0;
+   int max_ref = 0;
+
+   boost::shared_ptr<boost::progress_display> pp;
+
+   if( log != NULL ) {
+      *log << "Appending " << k << " nodes...\n";
+      pp.reset( new boost::progress_display( k, *log ) );
+   }
+
+   int curr_node = n;
+
+   x = 0;
+
+   for ( boost::tie( node_itor, node_itor_end ) = traits::nodes( g ); 
+         x < skip + k && node_itor != node_itor_end;
+         ++node_itor, ++x ) {
+      if ( x < skip ) {
+         int d = traits::successors( node_itor, scratch );
+         assert( d == 0 );
+         continue;
+      }
+
+      int curr_index = curr_node % cyclic_buffer_size;
+      unsigned int outd = traits::successors( node_itor, lst[ curr_index ] );
+
+      int delta = (int)( graph_obs->get_written_bits() - bit_offset );
+      st.add( compression_stats::OFFSETS, delta, write_offset( *offset_obs, delta ) );
+
+      bit_offset = graph_obs->get_written_bits();
+
+      st.add( compression_stats::OUTDEGREES, outd, write_outdegree( *graph_obs, outd ) );
+
+      list_len[ curr_index ] = outd;
+
+      if ( outd > 0 ) {
+         int ref = compress_list( *graph_obs, bit_count, curr_node, lst, list_len, ref_count );
+
+         tot_links += outd;
+         tot_ref += ref_count[ curr_index ];
+         tot_dist += ref;
+         max_ref = std::max( max_ref, ref_count[ curr_index ] );
+      }
+
+      curr_node++;
+
+      if( pp != NULL )
+         ++(*pp);
+   }
+
+   assert( curr_node == n + k );
+
+   pp.reset();
+
+   int delta = (int)( graph_obs->get_written_bits() - bit_offset );
+   st.add( compression_stats::OFFSETS, delta, write_offset( *offset_obs, delta ) );
+
+   stats = NULL;
+
+   // Flushing pads the streams, so their lengths must be taken first.
+   long graph_bits = graph_obs->get_written_bits(), offsets_bits = offset_obs->get_written_bits();
+
+   graph_obs->flush();
+   offset_obs->flush();
+
+   update_appended_properties( n + k, tot_links, tot_ref, tot_dist, max_ref, graph_bits, 
+                               offsets_bits, st );
+}
+
 } }
 #endif /*WEBGRAPH_H_*/